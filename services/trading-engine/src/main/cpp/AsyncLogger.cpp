@@ -0,0 +1,225 @@
+#include "AsyncLogger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+
+namespace quantis
+{
+
+    namespace
+    {
+        void append(std::vector<char> &out, const char *text, size_t length)
+        {
+            out.insert(out.end(), text, text + length);
+        }
+
+        void appendArg(std::vector<char> &out, const LogRecord &record, size_t i)
+        {
+            char buffer[32];
+            int length = 0;
+            switch (record.argTypes[i])
+            {
+            case LogArgType::Signed:
+                length = std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(record.args[i].i));
+                break;
+            case LogArgType::Unsigned:
+                length = std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(record.args[i].u));
+                break;
+            case LogArgType::Double:
+                length = std::snprintf(buffer, sizeof(buffer), "%g", record.args[i].d);
+                break;
+            case LogArgType::String:
+            {
+                const char *text = record.args[i].s ? record.args[i].s : "(null)";
+                append(out, text, std::strlen(text));
+                return;
+            }
+            }
+            append(out, buffer, static_cast<size_t>(std::max(length, 0)));
+        }
+
+        // Substitute each "{}" in the site's format with the next argument
+        void format(std::vector<char> &out, const LogRecord &record)
+        {
+            size_t next = 0;
+            const char *text = record.site->format;
+            while (*text)
+            {
+                if (text[0] == '{' && text[1] == '}' && next < record.argCount)
+                {
+                    appendArg(out, record, next++);
+                    text += 2;
+                }
+                else
+                {
+                    out.push_back(*text++);
+                }
+            }
+            out.push_back('\n');
+        }
+
+        void write(std::FILE *stream, std::vector<char> &buffer)
+        {
+            if (!buffer.empty())
+            {
+                std::fwrite(buffer.data(), 1, buffer.size(), stream);
+                std::fflush(stream);
+                buffer.clear();
+            }
+        }
+    }
+
+    thread_local AsyncLogger::ThreadRing *AsyncLogger::threadRing_{nullptr};
+    thread_local bool AsyncLogger::threadExited_{false};
+    thread_local AsyncLogger::ThreadHandle AsyncLogger::threadHandle_;
+
+    AsyncLogger::ThreadHandle::~ThreadHandle()
+    {
+        // The logger thread may free the ring as soon as it sees it retired
+        if (threadRing_)
+        {
+            threadRing_->retired.store(true, std::memory_order_release);
+            threadRing_ = nullptr;
+        }
+        threadExited_ = true;
+    }
+
+    AsyncLogger::AsyncLogger()
+    {
+        thread_ = std::thread([this]
+                              { run(); });
+#ifdef __linux__
+        pthread_setname_np(thread_.native_handle(), "quantis-log");
+#endif
+    }
+
+    AsyncLogger::~AsyncLogger()
+    {
+        running_.store(false, std::memory_order_release);
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    AsyncLogger::ThreadRing *AsyncLogger::localRing()
+    {
+        if (threadRing_ || threadExited_)
+        {
+            return threadRing_;
+        }
+
+        (void)&threadHandle_; // registers its destructor for this thread
+        auto ring = std::make_unique<ThreadRing>();
+        threadRing_ = ring.get();
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings_.push_back(std::move(ring));
+        return threadRing_;
+    }
+
+    bool AsyncLogger::drain(std::vector<char> &out, std::vector<char> &err)
+    {
+        std::vector<std::unique_ptr<ThreadRing>> finished;
+        bool any = false;
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex_);
+            for (size_t i = 0; i < rings_.size();)
+            {
+                ThreadRing &ring = *rings_[i];
+                // Read retired before draining so a ring is only freed once it is known empty
+                bool retired = ring.retired.load(std::memory_order_acquire);
+
+                LogRecord record;
+                while (ring.ring.tryPop(record))
+                {
+                    format(record.site->level >= LogLevel::Warn ? err : out, record);
+                    any = true;
+                }
+
+                if (retired)
+                {
+                    finished.push_back(std::move(rings_[i]));
+                    rings_[i] = std::move(rings_.back());
+                    rings_.pop_back();
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+        return any;
+    }
+
+    void AsyncLogger::run()
+    {
+        std::vector<char> out;
+        std::vector<char> err;
+        uint64_t reportedDrops = 0;
+
+        for (;;)
+        {
+            bool stopping = !running_.load(std::memory_order_acquire);
+            uint64_t flushRequest = flushRequests_.load(std::memory_order_acquire);
+
+            bool any = drain(out, err);
+
+            uint64_t drops = dropped_.load(std::memory_order_relaxed);
+            if (drops != reportedDrops)
+            {
+                char line[96];
+                int length = std::snprintf(line, sizeof(line), "AsyncLogger dropped %llu record(s): ring full\n",
+                                           static_cast<unsigned long long>(drops - reportedDrops));
+                append(err, line, static_cast<size_t>(length));
+                reportedDrops = drops;
+            }
+
+            write(stdout, out);
+            write(stderr, err);
+
+            if (flushRequest != flushesDone_.load(std::memory_order_relaxed))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(flushMutex_);
+                    flushesDone_.store(flushRequest, std::memory_order_release);
+                }
+                flushed_.notify_all();
+            }
+
+            if (stopping)
+            {
+                return;
+            }
+            if (!any)
+            {
+                // Idle: poll at a relaxed pace; producers never wake this thread
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    void AsyncLogger::flush()
+    {
+        uint64_t request = flushRequests_.fetch_add(1, std::memory_order_acq_rel) + 1;
+        std::unique_lock<std::mutex> lock(flushMutex_);
+        flushed_.wait(lock, [&]
+                      { return flushesDone_.load(std::memory_order_acquire) >= request; });
+    }
+
+    AsyncLogger &asyncLogger()
+    {
+        // Never destroyed: threads may still log during static destruction.
+        // Pending records are written at exit instead.
+        static AsyncLogger *logger = []
+        {
+            auto *instance = new AsyncLogger();
+            std::atexit([]
+                        { asyncLogger().flush(); });
+            return instance;
+        }();
+        return *logger;
+    }
+
+} // namespace quantis
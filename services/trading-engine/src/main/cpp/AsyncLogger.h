@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "RingBuffer.h"
+
+// Lowest level compiled in: 0 trace, 1 debug, 2 info, 3 warn, 4 error.
+// Calls below it expand to nothing, so release builds pay nothing for debug traces.
+#ifndef QUANTIS_LOG_LEVEL
+#ifdef NDEBUG
+#define QUANTIS_LOG_LEVEL 2
+#else
+#define QUANTIS_LOG_LEVEL 1
+#endif
+#endif
+
+namespace quantis
+{
+
+    enum class LogLevel : uint8_t
+    {
+        Trace = 0,
+        Debug = 1,
+        Info = 2,
+        Warn = 3,
+        Error = 4
+    };
+
+    // One per log statement, with static storage; its address is the format ID
+    struct LogSite
+    {
+        LogLevel level;
+        const char *format; // "{}" marks each argument
+    };
+
+    enum class LogArgType : uint8_t
+    {
+        Signed,
+        Unsigned,
+        Double,
+        String // must point at storage that outlives the record (e.g. a literal)
+    };
+
+    /**
+     * Fixed-size binary log record: a site pointer plus raw arguments
+     *
+     * Formatting is deferred to the logger thread, so the producer only
+     * copies a few words into its ring.
+     */
+    struct LogRecord
+    {
+        static constexpr size_t MAX_ARGS = 4;
+
+        uint64_t timestampNs;
+        const LogSite *site;
+        uint32_t argCount;
+        LogArgType argTypes[MAX_ARGS];
+        union
+        {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const char *s;
+        } args[MAX_ARGS];
+    };
+
+    static_assert(sizeof(LogRecord) <= 64 && std::is_trivially_copyable_v<LogRecord>);
+
+    /**
+     * Background logger fed by per-thread SPSC rings
+     *
+     * Each logging thread gets its own ring on first use, so the hot path is
+     * a couple of relaxed loads and one release store, with no locks and no
+     * syscalls. The logger thread drains every ring, formats the records and
+     * writes them in batches (info and below to stdout, warnings and errors
+     * to stderr), flushing once per batch. If a ring is full the record is
+     * dropped and counted rather than blocking the caller.
+     */
+    class AsyncLogger
+    {
+    public:
+        static constexpr size_t RING_CAPACITY = 4096;
+
+    private:
+        struct ThreadRing
+        {
+            SpscRing<LogRecord> ring{RING_CAPACITY};
+            std::atomic<bool> retired{false}; // owning thread exited
+        };
+
+        // Registered per thread; retires its ring when the thread exits
+        struct ThreadHandle
+        {
+            ~ThreadHandle();
+        };
+
+        std::mutex ringsMutex_;
+        std::vector<std::unique_ptr<ThreadRing>> rings_;
+
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<uint64_t> flushRequests_{0};
+        std::atomic<uint64_t> flushesDone_{0};
+        std::atomic<bool> running_{true};
+        std::mutex flushMutex_;
+        std::condition_variable flushed_;
+        std::thread thread_;
+
+        // Kept outside ThreadHandle: stores into an object being destroyed may be elided
+        static thread_local ThreadRing *threadRing_;
+        static thread_local bool threadExited_; // ring retired; later records are dropped
+        static thread_local ThreadHandle threadHandle_;
+
+        // nullptr once this thread's handle is destroyed, e.g. for a log from another thread_local destructor
+        ThreadRing *localRing();
+        void run();
+        bool drain(std::vector<char> &out, std::vector<char> &err);
+
+        template <typename T>
+        static void encode(LogRecord &record, T value) noexcept
+        {
+            size_t i = record.argCount++;
+            if constexpr (std::is_same_v<std::decay_t<T>, const char *> || std::is_same_v<std::decay_t<T>, char *>)
+            {
+                record.argTypes[i] = LogArgType::String;
+                record.args[i].s = value;
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                record.argTypes[i] = LogArgType::Double;
+                record.args[i].d = static_cast<double>(value);
+            }
+            else if constexpr (std::is_signed_v<T>)
+            {
+                record.argTypes[i] = LogArgType::Signed;
+                record.args[i].i = static_cast<int64_t>(value);
+            }
+            else
+            {
+                static_assert(std::is_unsigned_v<T>, "log arguments must be numbers or static strings");
+                record.argTypes[i] = LogArgType::Unsigned;
+                record.args[i].u = static_cast<uint64_t>(value);
+            }
+        }
+
+    public:
+        AsyncLogger();
+        ~AsyncLogger();
+
+        AsyncLogger(const AsyncLogger &) = delete;
+        AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+        template <typename... Args>
+        void log(const LogSite &site, Args... args) noexcept
+        {
+            static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "too many log arguments");
+
+            LogRecord record;
+            record.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                           std::chrono::system_clock::now().time_since_epoch())
+                                                           .count());
+            record.site = &site;
+            record.argCount = 0;
+            (encode(record, args), ...);
+
+            ThreadRing *ring = localRing();
+            if (!ring || !ring->ring.tryPush(record))
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * Block until everything logged before the call has been written
+         */
+        void flush();
+
+        uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    };
+
+    // Process-wide logger, started on first use
+    AsyncLogger &asyncLogger();
+
+} // namespace quantis
+
+#define QUANTIS_LOG_AT(lvl, fmt, ...)                                                              \
+    do                                                                                             \
+    {                                                                                              \
+        if constexpr (static_cast<int>(lvl) >= QUANTIS_LOG_LEVEL)                                  \
+        {                                                                                          \
+            static constexpr ::quantis::LogSite quantisLogSite{lvl, fmt};                          \
+            ::quantis::asyncLogger().log(quantisLogSite __VA_OPT__(, ) __VA_ARGS__);               \
+        }                                                                                          \
+    } while (0)
+
+#define QLOG_TRACE(fmt, ...) QUANTIS_LOG_AT(::quantis::LogLevel::Trace, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define QLOG_DEBUG(fmt, ...) QUANTIS_LOG_AT(::quantis::LogLevel::Debug, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define QLOG_INFO(fmt, ...) QUANTIS_LOG_AT(::quantis::LogLevel::Info, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define QLOG_WARN(fmt, ...) QUANTIS_LOG_AT(::quantis::LogLevel::Warn, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define QLOG_ERROR(fmt, ...) QUANTIS_LOG_AT(::quantis::LogLevel::Error, fmt __VA_OPT__(, ) __VA_ARGS__)
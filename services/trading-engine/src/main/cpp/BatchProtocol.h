@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "Order.h"
+
+namespace quantis
+{
+
+    /**
+     * Fixed-layout records exchanged with Java through direct ByteBuffers
+     *
+     * Java writes OrderRecords back to back into an input buffer and makes one
+     * native call; the engine answers in an output buffer that starts with a
+     * BatchHeader followed by ResultRecords. All fields are native-endian
+     * (Java must set ByteOrder.nativeOrder()); offsets are fixed by the
+     * static_asserts below and mirrored in TradingEngineJNI.java.
+     *
+     * Symbols and users travel as indices obtained once from resolveSymbol /
+     * resolveUser, and resting orders are addressed by the handle returned in
+     * their ack, so no strings cross the boundary per record.
+     */
+
+    enum class BatchOp : uint8_t
+    {
+        New = 1,
+        Cancel = 2,
+        Amend = 3
+    };
+
+    enum class ResultType : uint8_t
+    {
+        Ack = 1,    // order accepted; quantity = remainder left resting
+        Reject = 2, // order refused; nothing changed
+        Fill = 3    // one execution against a resting order
+    };
+
+    struct OrderRecord
+    {
+        uint8_t op;    // BatchOp
+        uint8_t side;  // 0 = buy, 1 = sell
+        uint16_t reserved0;
+        uint32_t symbolIndex; // from resolveSymbol (ignored for Cancel)
+        uint32_t userIndex;   // from resolveUser
+        uint32_t reserved1;
+        uint64_t clientOrderId; // caller correlation ID, echoed in every result
+        uint64_t handle;        // Cancel / Amend: handle from the order's ack
+        int64_t quantity;
+        double price;
+    };
+
+    struct ResultRecord
+    {
+        uint8_t type; // ResultType
+        uint8_t side; // aggressor side
+        uint8_t flags;
+        uint8_t reason; // Reject: RiskReject, 0 if the book refused it
+        uint32_t symbolIndex;
+        uint64_t clientOrderId;
+        uint64_t handle;        // Ack: assigned handle; Fill: aggressor handle
+        uint64_t tradeId;       // Fill only
+        uint64_t restingHandle; // Fill only
+        int64_t quantity;       // Ack: resting remainder; Fill: executed quantity
+        double price;           // Fill: execution price
+        uint32_t userIndex;
+        uint32_t restingUserIndex;
+    };
+
+    inline constexpr uint8_t RESULT_FLAG_RESTING_FILLED = 0x01; // Fill: passive order left the book
+
+    struct BatchHeader
+    {
+        uint32_t processed; // input records consumed
+        uint32_t results;   // ResultRecords written after the header
+        uint32_t pending;   // results held back for the next call (output buffer was full)
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(OrderRecord) == 48 && std::is_trivially_copyable_v<OrderRecord>);
+    static_assert(sizeof(ResultRecord) == 64 && std::is_trivially_copyable_v<ResultRecord>);
+    static_assert(sizeof(BatchHeader) == 16 && std::is_trivially_copyable_v<BatchHeader>);
+
+} // namespace quantis
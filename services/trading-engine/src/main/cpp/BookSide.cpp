@@ -0,0 +1,264 @@
+#include "BookSide.h"
+#include <bit>
+
+namespace quantis
+{
+
+    // ==================== MapBookSide ====================
+
+    PriceLevel *MapBookSide::findOrCreate(Price price)
+    {
+        auto [it, inserted] = levels_.try_emplace(price);
+        if (inserted)
+        {
+            it->second.price = price;
+        }
+        return &it->second;
+    }
+
+    PriceLevel *MapBookSide::find(Price price)
+    {
+        auto it = levels_.find(price);
+        return it != levels_.end() ? &it->second : nullptr;
+    }
+
+    void MapBookSide::erase(PriceLevel *level)
+    {
+        levels_.erase(level->price);
+    }
+
+    PriceLevel *MapBookSide::best()
+    {
+        if (levels_.empty())
+        {
+            return nullptr;
+        }
+        return side_ == Side::Buy ? &levels_.rbegin()->second : &levels_.begin()->second;
+    }
+
+    PriceLevel *MapBookSide::next(const PriceLevel *level)
+    {
+        if (side_ == Side::Buy)
+        {
+            auto it = levels_.lower_bound(level->price);
+            if (it == levels_.begin())
+            {
+                return nullptr;
+            }
+            return &(--it)->second;
+        }
+
+        auto it = levels_.upper_bound(level->price);
+        return it != levels_.end() ? &it->second : nullptr;
+    }
+
+    // ==================== LadderBookSide ====================
+
+    LadderBookSide::LadderBookSide(Side side, size_t windowLevels, BlockPool *pool)
+        : BookSide(side), overflow_(std::less<Price>{}, PoolAllocator<std::pair<const Price, PriceLevel>>(pool))
+    {
+        size_t slots = windowLevels < 64 ? 64 : (windowLevels + 63) & ~size_t{63};
+        levels_.resize(slots);
+        occupied_.resize(slots / 64, 0);
+    }
+
+    void LadderBookSide::anchor(Price price)
+    {
+        // Only called once the window has drained, so every slot is empty
+        base_ = price - static_cast<Price>(levels_.size() / 2);
+        anchored_ = true;
+        bestSlot_ = npos;
+
+        // Pull overflow levels that now fall inside the window into their slots
+        auto it = overflow_.lower_bound(base_);
+        while (it != overflow_.end() && inWindow(it->first))
+        {
+            size_t slot = static_cast<size_t>(it->first - base_);
+            levels_[slot] = it->second;
+            setOccupied(slot);
+            ++ladderLevelCount_;
+            if (bestSlot_ == npos || better(it->first, levels_[bestSlot_].price))
+            {
+                bestSlot_ = slot;
+            }
+            it = overflow_.erase(it);
+        }
+    }
+
+    PriceLevel *LadderBookSide::findOrCreate(Price price)
+    {
+        if (!inWindow(price) && ladderLevelCount_ == 0)
+        {
+            anchor(price);
+        }
+
+        if (!inWindow(price))
+        {
+            auto [it, inserted] = overflow_.try_emplace(price);
+            if (inserted)
+            {
+                it->second.price = price;
+            }
+            return &it->second;
+        }
+
+        size_t slot = static_cast<size_t>(price - base_);
+        PriceLevel &level = levels_[slot];
+        if (!(occupied_[slot >> 6] & (uint64_t{1} << (slot & 63))))
+        {
+            level = PriceLevel{};
+            level.price = price;
+            setOccupied(slot);
+            ++ladderLevelCount_;
+            if (bestSlot_ == npos || better(price, levels_[bestSlot_].price))
+            {
+                bestSlot_ = slot;
+            }
+        }
+        return &level;
+    }
+
+    PriceLevel *LadderBookSide::find(Price price)
+    {
+        if (inWindow(price))
+        {
+            size_t slot = static_cast<size_t>(price - base_);
+            return (occupied_[slot >> 6] & (uint64_t{1} << (slot & 63))) ? &levels_[slot] : nullptr;
+        }
+
+        auto it = overflow_.find(price);
+        return it != overflow_.end() ? &it->second : nullptr;
+    }
+
+    void LadderBookSide::erase(PriceLevel *level)
+    {
+        if (!ownsSlot(level))
+        {
+            overflow_.erase(level->price);
+            return;
+        }
+
+        size_t slot = static_cast<size_t>(level - levels_.data());
+        clearOccupied(slot);
+        *level = PriceLevel{};
+        --ladderLevelCount_;
+
+        if (slot == bestSlot_)
+        {
+            bestSlot_ = side_ == Side::Buy ? findOccupiedDown(slot) : findOccupiedUp(slot);
+        }
+    }
+
+    PriceLevel *LadderBookSide::best()
+    {
+        PriceLevel *ladder = bestSlot_ != npos ? &levels_[bestSlot_] : nullptr;
+        PriceLevel *overflow = overflowBehind(nullptr);
+
+        if (!ladder)
+        {
+            return overflow;
+        }
+        if (!overflow)
+        {
+            return ladder;
+        }
+        return better(overflow->price, ladder->price) ? overflow : ladder;
+    }
+
+    PriceLevel *LadderBookSide::next(const PriceLevel *level)
+    {
+        PriceLevel *ladder = nullptr;
+        if (ownsSlot(level))
+        {
+            size_t slot = nextSlot(static_cast<size_t>(level - levels_.data()));
+            ladder = slot != npos ? &levels_[slot] : nullptr;
+        }
+        else if (bestSlot_ != npos && better(level->price, levels_[bestSlot_].price))
+        {
+            // An overflow level ahead of the window: the whole window is behind it
+            ladder = &levels_[bestSlot_];
+        }
+
+        PriceLevel *overflow = overflowBehind(&level->price);
+
+        if (!ladder)
+        {
+            return overflow;
+        }
+        if (!overflow)
+        {
+            return ladder;
+        }
+        return better(overflow->price, ladder->price) ? overflow : ladder;
+    }
+
+    size_t LadderBookSide::findOccupiedDown(size_t from) const noexcept
+    {
+        size_t word = from >> 6;
+        unsigned bit = static_cast<unsigned>(from & 63);
+        uint64_t bits = occupied_[word] & (bit == 63 ? ~uint64_t{0} : ((uint64_t{1} << (bit + 1)) - 1));
+
+        while (true)
+        {
+            if (bits)
+            {
+                return word * 64 + 63 - static_cast<size_t>(std::countl_zero(bits));
+            }
+            if (word == 0)
+            {
+                return npos;
+            }
+            bits = occupied_[--word];
+        }
+    }
+
+    size_t LadderBookSide::findOccupiedUp(size_t from) const noexcept
+    {
+        if (from >= levels_.size())
+        {
+            return npos;
+        }
+
+        size_t word = from >> 6;
+        uint64_t bits = occupied_[word] & (~uint64_t{0} << (from & 63));
+
+        while (true)
+        {
+            if (bits)
+            {
+                return word * 64 + static_cast<size_t>(std::countr_zero(bits));
+            }
+            if (++word == occupied_.size())
+            {
+                return npos;
+            }
+            bits = occupied_[word];
+        }
+    }
+
+    size_t LadderBookSide::nextSlot(size_t slot) const noexcept
+    {
+        if (side_ == Side::Buy)
+        {
+            return slot == 0 ? npos : findOccupiedDown(slot - 1);
+        }
+        return findOccupiedUp(slot + 1);
+    }
+
+    PriceLevel *LadderBookSide::overflowBehind(const Price *price)
+    {
+        if (side_ == Side::Buy)
+        {
+            auto it = price ? overflow_.lower_bound(*price) : overflow_.end();
+            if (it == overflow_.begin())
+            {
+                return nullptr;
+            }
+            return &(--it)->second;
+        }
+
+        auto it = price ? overflow_.upper_bound(*price) : overflow_.begin();
+        return it != overflow_.end() ? &it->second : nullptr;
+    }
+
+} // namespace quantis
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Order.h"
+#include "Slab.h"
+
+namespace quantis
+{
+
+    /**
+     * One price level: an intrusive FIFO of resting orders
+     *
+     * Orders are linked through their own prev/next pointers, so append and
+     * unlink are O(1) and never allocate or touch a refcount.
+     */
+    struct PriceLevel
+    {
+        Price price{0};
+        int64_t totalQuantity{0};
+        uint32_t orderCount{0};
+        Order *head{nullptr};
+        Order *tail{nullptr};
+
+        bool empty() const noexcept { return head == nullptr; }
+
+        void pushBack(Order *order) noexcept
+        {
+            order->prev = tail;
+            order->next = nullptr;
+            if (tail)
+            {
+                tail->next = order;
+            }
+            else
+            {
+                head = order;
+            }
+            tail = order;
+            totalQuantity += order->quantity;
+            ++orderCount;
+        }
+
+        void unlink(Order *order) noexcept
+        {
+            if (order->prev)
+            {
+                order->prev->next = order->next;
+            }
+            else
+            {
+                head = order->next;
+            }
+            if (order->next)
+            {
+                order->next->prev = order->prev;
+            }
+            else
+            {
+                tail = order->prev;
+            }
+            order->prev = nullptr;
+            order->next = nullptr;
+            totalQuantity -= order->quantity;
+            --orderCount;
+        }
+    };
+
+    /**
+     * Sparse levels keyed by tick price, with nodes drawn from a pool. The
+     * node block size covers the value plus the tree links and colour of both
+     * libstdc++ and libc++; a larger node would fall back to the heap.
+     */
+    using LevelMap = std::map<Price, PriceLevel, std::less<Price>, PoolAllocator<std::pair<const Price, PriceLevel>>>;
+
+    inline constexpr size_t LEVEL_NODE_BYTES = sizeof(std::pair<const Price, PriceLevel>) + 4 * sizeof(void *);
+
+    /**
+     * One side of an order book, keyed by integer tick price
+     *
+     * Bids rank higher prices first, asks lower prices first. Level pointers
+     * stay valid until the level is erased.
+     */
+    class BookSide
+    {
+    protected:
+        Side side_;
+
+        // True if price a ranks ahead of price b on this side
+        bool better(Price a, Price b) const noexcept { return side_ == Side::Buy ? a > b : a < b; }
+
+    public:
+        explicit BookSide(Side side) : side_(side) {}
+        virtual ~BookSide() = default;
+
+        BookSide(const BookSide &) = delete;
+        BookSide &operator=(const BookSide &) = delete;
+
+        Side side() const noexcept { return side_; }
+
+        // Level at price, creating an empty one if needed
+        virtual PriceLevel *findOrCreate(Price price) = 0;
+
+        // Level at price, or nullptr
+        virtual PriceLevel *find(Price price) = 0;
+
+        // Drop a level that no longer holds orders
+        virtual void erase(PriceLevel *level) = 0;
+
+        // Best (most aggressive) level, or nullptr if the side is empty
+        virtual PriceLevel *best() = 0;
+
+        // Next level behind the given one in priority order, or nullptr
+        virtual PriceLevel *next(const PriceLevel *level) = 0;
+
+        virtual size_t levelCount() const = 0;
+
+        bool empty() const { return levelCount() == 0; }
+    };
+
+    /**
+     * Sparse side backed by an ordered map of levels
+     *
+     * Suits instruments whose resting prices spread far from the touch.
+     */
+    class MapBookSide final : public BookSide
+    {
+    private:
+        LevelMap levels_;
+
+    public:
+        // Level nodes come from pool when given (shared with the other side of the book)
+        explicit MapBookSide(Side side, BlockPool *pool = nullptr)
+            : BookSide(side), levels_(std::less<Price>{}, PoolAllocator<std::pair<const Price, PriceLevel>>(pool)) {}
+
+        PriceLevel *findOrCreate(Price price) override;
+        PriceLevel *find(Price price) override;
+        void erase(PriceLevel *level) override;
+        PriceLevel *best() override;
+        PriceLevel *next(const PriceLevel *level) override;
+        size_t levelCount() const override { return levels_.size(); }
+    };
+
+    /**
+     * Dense side backed by a fixed window of levels around the touch
+     *
+     * Levels inside the window live in a contiguous array indexed by
+     * (price - base), with an occupancy bitmap so the next best level is
+     * found with a handful of word scans. The window re-anchors on the next
+     * insert once it drains; prices outside it fall back to a sparse map.
+     */
+    class LadderBookSide final : public BookSide
+    {
+    private:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        std::vector<PriceLevel> levels_;
+        std::vector<uint64_t> occupied_;
+        LevelMap overflow_;
+
+        Price base_{0};
+        bool anchored_{false};
+        size_t ladderLevelCount_{0};
+        size_t bestSlot_{npos};
+
+        bool inWindow(Price price) const noexcept
+        {
+            return anchored_ && price >= base_ && price < base_ + static_cast<Price>(levels_.size());
+        }
+
+        bool ownsSlot(const PriceLevel *level) const noexcept
+        {
+            return level >= levels_.data() && level < levels_.data() + levels_.size();
+        }
+
+        void anchor(Price price);
+        void setOccupied(size_t slot) noexcept { occupied_[slot >> 6] |= uint64_t{1} << (slot & 63); }
+        void clearOccupied(size_t slot) noexcept { occupied_[slot >> 6] &= ~(uint64_t{1} << (slot & 63)); }
+
+        // Highest occupied slot <= from, or npos
+        size_t findOccupiedDown(size_t from) const noexcept;
+
+        // Lowest occupied slot >= from, or npos
+        size_t findOccupiedUp(size_t from) const noexcept;
+
+        // Next occupied slot behind slot in priority order, or npos
+        size_t nextSlot(size_t slot) const noexcept;
+
+        // Best overflow level strictly behind price (any level if price is unset)
+        PriceLevel *overflowBehind(const Price *price);
+
+    public:
+        /**
+         * @param windowLevels number of tick levels held densely (rounded up to a multiple of 64)
+         * @param pool where overflow level nodes come from, or nullptr for the heap
+         */
+        LadderBookSide(Side side, size_t windowLevels, BlockPool *pool = nullptr);
+
+        PriceLevel *findOrCreate(Price price) override;
+        PriceLevel *find(Price price) override;
+        void erase(PriceLevel *level) override;
+        PriceLevel *best() override;
+        PriceLevel *next(const PriceLevel *level) override;
+        size_t levelCount() const override { return ladderLevelCount_ + overflow_.size(); }
+    };
+
+} // namespace quantis
@@ -1,6 +1,8 @@
 #include "CppMarketDataService.h"
+#include "WebSocketFeed.h"
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
 #include <thread>
 
 namespace quantis
@@ -11,7 +13,9 @@ namespace quantis
           ,
           updateInterval_(std::chrono::milliseconds(12)) // ~83 updates/second
           ,
-          startTime_(std::chrono::steady_clock::now())
+          startTime_(std::chrono::steady_clock::now()),
+          scheduler_(store),
+          ingest_(store)
     {
 
         // Initialize components
@@ -20,6 +24,18 @@ namespace quantis
 
         // Default symbols
         symbols_ = {"AAPL", "GOOGL", "MSFT", "TSLA", "AMZN", "META", "NVDA", "NFLX"};
+        scheduler_.setSymbols(symbols_);
+
+        WebSocketFeedConfig feedConfig = WebSocketFeedConfig::fromEnvironment();
+        if (feedConfig.enabled())
+        {
+            feeds_.push_back(std::make_unique<WebSocketFeed>(store, feedConfig));
+        }
+
+        if (const char *inFlight = std::getenv("QUANTIS_MD_MAX_IN_FLIGHT"))
+        {
+            maxInFlight_.store(std::max<size_t>(1, std::strtoul(inFlight, nullptr, 10)));
+        }
 
         std::cout << "CppMarketDataService initialized with " << symbols_.size() << " symbols" << std::endl;
     }
@@ -39,6 +55,15 @@ namespace quantis
 
         try
         {
+            {
+                std::lock_guard<std::mutex> lock(configMutex_);
+                for (auto &feed : feeds_)
+                {
+                    feed->start();
+                }
+            }
+
+            ingest_.start();
             workerThread_ = std::thread(&CppMarketDataService::workerThread, this);
             std::cout << "CppMarketDataService started successfully" << std::endl;
             return true;
@@ -46,6 +71,7 @@ namespace quantis
         catch (const std::exception &e)
         {
             running_.store(false);
+            ingest_.stop();
             std::cerr << "Failed to start CppMarketDataService: " << e.what() << std::endl;
             return false;
         }
@@ -63,6 +89,17 @@ namespace quantis
             workerThread_.join();
         }
 
+        // Fetching has stopped: publish what is already in the pipeline
+        ingest_.stop();
+
+        {
+            std::lock_guard<std::mutex> lock(configMutex_);
+            for (auto &feed : feeds_)
+            {
+                feed->stop();
+            }
+        }
+
         std::cout << "CppMarketDataService stopped" << std::endl;
     }
 
@@ -70,6 +107,7 @@ namespace quantis
     {
         std::lock_guard<std::mutex> lock(configMutex_);
         symbols_ = symbols;
+        scheduler_.setSymbols(symbols_);
         std::cout << "Updated symbols: " << symbols_.size() << " symbols" << std::endl;
     }
 
@@ -80,6 +118,7 @@ namespace quantis
         if (it == symbols_.end())
         {
             symbols_.push_back(symbol);
+            scheduler_.setSymbols(symbols_);
             std::cout << "Added symbol: " << symbol << std::endl;
         }
     }
@@ -91,6 +130,7 @@ namespace quantis
         if (it != symbols_.end())
         {
             symbols_.erase(it);
+            scheduler_.setSymbols(symbols_);
             std::cout << "Removed symbol: " << symbol << std::endl;
         }
     }
@@ -106,9 +146,54 @@ namespace quantis
     {
         std::lock_guard<std::mutex> lock(configMutex_);
         updateInterval_ = interval;
+        scheduler_.setMinRefreshInterval(interval);
         std::cout << "Updated interval: " << interval.count() << "ms" << std::endl;
     }
 
+    void CppMarketDataService::setRateLimit(double requestsPerSecond, double burst)
+    {
+        scheduler_.setRate(requestsPerSecond, burst);
+        std::cout << "Updated rate limit: " << requestsPerSecond << " requests/s, burst " << burst << std::endl;
+    }
+
+    void CppMarketDataService::setActivitySource(ActivitySource source)
+    {
+        scheduler_.setActivitySource(std::move(source));
+    }
+
+    void CppMarketDataService::setMaxInFlight(size_t maxInFlight)
+    {
+        maxInFlight_.store(std::max<size_t>(1, maxInFlight));
+        std::cout << "Updated max in-flight requests: " << maxInFlight_.load() << std::endl;
+    }
+
+    void CppMarketDataService::addFeed(std::unique_ptr<MarketDataFeed> feed)
+    {
+        if (!feed)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(configMutex_);
+        if (running_.load())
+        {
+            feed->start();
+        }
+        feeds_.push_back(std::move(feed));
+    }
+
+    std::vector<FeedStats> CppMarketDataService::getFeedStats() const
+    {
+        std::lock_guard<std::mutex> lock(const_cast<std::mutex &>(configMutex_));
+        std::vector<FeedStats> stats;
+        stats.reserve(feeds_.size());
+        for (const auto &feed : feeds_)
+        {
+            stats.push_back(feed->getStats());
+        }
+        return stats;
+    }
+
     std::vector<std::string> CppMarketDataService::getSymbols() const
     {
         std::lock_guard<std::mutex> lock(const_cast<std::mutex &>(configMutex_));
@@ -120,9 +205,11 @@ namespace quantis
         auto now = std::chrono::steady_clock::now();
         auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - startTime_);
 
-        uint64_t total = totalUpdates_.load();
-        uint64_t failed = failedUpdates_.load();
-        uint64_t latencyNs = totalLatencyNs_.load();
+        // Forced updates and fetch failures are counted here, polled quotes by the pipeline
+        IngestStats ingest = ingest_.getStats();
+        uint64_t total = totalUpdates_.load() + ingest.published;
+        uint64_t failed = failedUpdates_.load() + ingest.rejected;
+        uint64_t latencyNs = totalLatencyNs_.load() + ingest.latencyNs;
 
         PerformanceMetrics metrics;
         metrics.totalUpdates = total;
@@ -137,10 +224,20 @@ namespace quantis
             metrics.httpMetrics = httpClient_->getPerformanceMetrics();
         }
 
+        metrics.parserMetrics = ingest_.getParserMetrics();
         if (jsonParser_)
         {
-            metrics.parserMetrics = jsonParser_->getPerformanceMetrics();
+            FastJsonParser::PerformanceMetrics forced = jsonParser_->getPerformanceMetrics();
+            FastJsonParser::PerformanceMetrics &parser = metrics.parserMetrics;
+            uint64_t parses = parser.totalParses + forced.totalParses;
+            double parseTimeMs = parser.avgParseTimeMs * parser.totalParses + forced.avgParseTimeMs * forced.totalParses;
+            parser.totalParses = parses;
+            parser.failedParses += forced.failedParses;
+            parser.avgParseTimeMs = parses > 0 ? parseTimeMs / parses : 0.0;
+            parser.successRate = parses > 0 ? (double)(parses - parser.failedParses) / parses * 100.0 : 0.0;
+            parser.parsesPerSecond = parseTimeMs > 0 ? parses / (parseTimeMs / 1e3) : 0.0;
         }
+        metrics.ingest = ingest;
 
         return metrics;
     }
@@ -160,6 +257,7 @@ namespace quantis
         {
             jsonParser_->resetMetrics();
         }
+        ingest_.resetMetrics();
 
         startTime_ = std::chrono::steady_clock::now();
         std::cout << "Performance metrics reset" << std::endl;
@@ -169,11 +267,13 @@ namespace quantis
     {
         return running_.load() &&
                httpClient_ && httpClient_->isHealthy() &&
-               jsonParser_ && jsonParser_->isHealthy();
+               jsonParser_ && (ingest_.isHealthy() || jsonParser_->isHealthy());
     }
 
     bool CppMarketDataService::updateSymbol(const std::string &symbol)
     {
+        // A forced update always runs; the background poll pays for it
+        scheduler_.charge(symbol, FetchScheduler::nowNs());
         return updateMarketData(symbol);
     }
 
@@ -185,28 +285,30 @@ namespace quantis
         {
             try
             {
-                // Get current symbols (thread-safe copy)
-                std::vector<std::string> currentSymbols;
+                std::string apiKey;
                 {
                     std::lock_guard<std::mutex> lock(configMutex_);
-                    currentSymbols = symbols_;
+                    apiKey = apiKey_;
+                }
+
+                // Hottest and stalest symbols first, as many as the request budget allows
+                size_t maxInFlight = maxInFlight_.load();
+                due_.clear();
+                uint64_t now = FetchScheduler::nowNs();
+                if (scheduler_.next(now, maxInFlight, due_) == 0)
+                {
+                    auto wait = std::chrono::nanoseconds(scheduler_.waitNs(now));
+                    std::this_thread::sleep_for(std::clamp<std::chrono::nanoseconds>(wait, std::chrono::milliseconds(1), std::chrono::milliseconds(100)));
+                    continue;
                 }
 
-                // Update each symbol
-                for (const auto &symbol : currentSymbols)
+                if (maxInFlight > 1)
                 {
-                    if (!running_.load())
-                        break;
-
-                    if (canUpdate())
-                    {
-                        updateMarketData(symbol);
-                        updateRateLimit();
-                    }
+                    refreshConcurrent(due_, apiKey);
+                    continue;
                 }
 
-                // Sleep for update interval
-                std::this_thread::sleep_for(updateInterval_);
+                refreshSequential(due_, apiKey);
             }
             catch (const std::exception &e)
             {
@@ -274,21 +376,70 @@ namespace quantis
         }
     }
 
-    bool CppMarketDataService::canUpdate() const
+    void CppMarketDataService::refreshSequential(const std::vector<std::string> &symbols, const std::string &apiKey)
     {
-        auto now = std::chrono::steady_clock::now();
-        auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+        for (const auto &symbol : symbols)
+        {
+            uint64_t start = FetchScheduler::nowNs();
+            std::string response = httpClient_->get(FastHttpClient::buildAlphaVantageUrl(symbol, apiKey));
+            if (response.empty())
+            {
+                failedUpdates_.fetch_add(1);
+                continue;
+            }
+            submitResponse(symbol, response, start);
+        }
+    }
+
+    void CppMarketDataService::refreshConcurrent(const std::vector<std::string> &symbols, const std::string &apiKey)
+    {
+        if (symbols.empty())
+        {
+            return;
+        }
+
+        uint64_t start = FetchScheduler::nowNs();
+
+        requests_.resize(symbols.size());
+        for (size_t i = 0; i < symbols.size(); ++i)
+        {
+            requests_[i].url = FastHttpClient::buildAlphaVantageUrl(symbols[i], apiKey);
+        }
 
-        uint64_t lastUpdate = lastUpdateTime_.load();
-        uint64_t intervalMs = static_cast<uint64_t>(minUpdateInterval_.count());
-        return (static_cast<uint64_t>(nowMs) - lastUpdate) >= intervalMs;
+        // The scheduler already spent a token per symbol, so the requests start together
+        httpClient_->getMany(requests_, maxInFlight_.load());
+
+        // Parsing and store writes run on the pipeline while the next round is fetched
+        uint64_t failed = 0;
+        for (size_t i = 0; i < requests_.size(); ++i)
+        {
+            if (requests_[i].ok && !requests_[i].body.empty())
+            {
+                submitResponse(symbols[i], requests_[i].body, start);
+            }
+            else
+            {
+                ++failed;
+            }
+        }
+        failedUpdates_.fetch_add(failed);
     }
 
-    void CppMarketDataService::updateRateLimit()
+    void CppMarketDataService::submitResponse(const std::string &symbol, std::string &body, uint64_t fetchedAtNs)
     {
-        auto now = std::chrono::steady_clock::now();
-        auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-        lastUpdateTime_.store(nowMs);
+        uint32_t index = marketDataStore_.getOrCreateSymbolIndex(symbol);
+        if (index >= marketDataStore_.getSymbolCapacity())
+        {
+            failedUpdates_.fetch_add(1);
+            return;
+        }
+
+        // Swap rather than copy: the caller's buffer comes back with the recycled one's capacity
+        IngestPipeline::Response *response = ingest_.acquire();
+        response->symbolIndex = index;
+        response->fetchedAtNs = fetchedAtNs;
+        response->body.swap(body);
+        ingest_.submit(response);
     }
 
 } // namespace quantis
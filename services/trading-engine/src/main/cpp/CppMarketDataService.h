@@ -2,9 +2,13 @@
 
 #include "FastHttpClient.h"
 #include "FastJsonParser.h"
+#include "FetchScheduler.h"
+#include "IngestPipeline.h"
+#include "MarketDataFeed.h"
 #include "MarketDataStore.h"
 #include <vector>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <atomic>
 #include <chrono>
@@ -34,7 +38,7 @@ namespace quantis
     private:
         // Core components
         std::unique_ptr<FastHttpClient> httpClient_;
-        std::unique_ptr<FastJsonParser> jsonParser_;
+        std::unique_ptr<FastJsonParser> jsonParser_; // forced updates; the poller parses in ingest_
         MarketDataStore &marketDataStore_;
 
         // Configuration
@@ -53,9 +57,21 @@ namespace quantis
         std::atomic<uint64_t> totalLatencyNs_{0};
         std::chrono::steady_clock::time_point startTime_;
 
-        // Rate limiting
-        std::atomic<uint64_t> lastUpdateTime_{0};
-        std::chrono::milliseconds minUpdateInterval_{12}; // Alpha Vantage limit
+        // Streaming feeds pushing into the store alongside the poller
+        std::vector<std::unique_ptr<MarketDataFeed>> feeds_;
+
+        // Rate limiting: which symbols to fetch, within the provider's request budget
+        FetchScheduler scheduler_;
+
+        // Concurrent refresh; 1 fetches symbols one after another
+        std::atomic<size_t> maxInFlight_{8};
+
+        // Parse and store-write stages behind the fetching worker thread
+        IngestPipeline ingest_;
+
+        // Worker-thread buffers reused across refresh cycles
+        std::vector<std::string> due_;
+        std::vector<HttpRequest> requests_;
 
     public:
         /**
@@ -108,10 +124,35 @@ namespace quantis
         void setApiKey(const std::string &apiKey);
 
         /**
-         * Set update interval
+         * Set the shortest interval between two fetches of one symbol
          */
         void setUpdateInterval(std::chrono::milliseconds interval);
 
+        /**
+         * Set the provider request budget: a steady rate plus a burst allowance
+         */
+        void setRateLimit(double requestsPerSecond, double burst);
+
+        /**
+         * Report order and trade activity per symbol, so busy symbols are
+         * refreshed more often than idle ones
+         */
+        void setActivitySource(ActivitySource source);
+
+        /**
+         * Set how many symbol requests may be in flight at once (1 = sequential).
+         * Defaults to QUANTIS_MD_MAX_IN_FLIGHT, or 8.
+         */
+        void setMaxInFlight(size_t maxInFlight);
+
+        /**
+         * Add a streaming feed; started with the service, or at once if it is
+         * running. Symbols a feed keeps fresh are polled only when it goes quiet.
+         */
+        void addFeed(std::unique_ptr<MarketDataFeed> feed);
+
+        std::vector<FeedStats> getFeedStats() const;
+
         /**
          * Get current symbols
          */
@@ -129,7 +170,8 @@ namespace quantis
             double successRate;
             double uptimeSeconds;
             FastHttpClient::PerformanceMetrics httpMetrics;
-            FastJsonParser::PerformanceMetrics parserMetrics;
+            FastJsonParser::PerformanceMetrics parserMetrics; // forced updates and every ingest worker
+            IngestStats ingest;
         };
 
         PerformanceMetrics getPerformanceMetrics() const;
@@ -151,7 +193,7 @@ namespace quantis
 
     private:
         /**
-         * Main worker thread function
+         * Main worker thread function: the fetch stage of the ingest pipeline
          */
         void workerThread();
 
@@ -161,14 +203,17 @@ namespace quantis
         bool updateMarketData(const std::string &symbol);
 
         /**
-         * Check if enough time has passed since last update
+         * Fetch the symbols one after another and hand each response to ingest
          */
-        bool canUpdate() const;
+        void refreshSequential(const std::vector<std::string> &symbols, const std::string &apiKey);
 
         /**
-         * Update rate limiting timestamp
+         * Fetch the symbols concurrently and hand the responses to ingest
          */
-        void updateRateLimit();
+        void refreshConcurrent(const std::vector<std::string> &symbols, const std::string &apiKey);
+
+        // Queue one fetched body, swapped into a pipeline buffer, for parsing
+        void submitResponse(const std::string &symbol, std::string &body, uint64_t fetchedAtNs);
     };
 
 } // namespace quantis
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <chrono>
+#include "FetchScheduler.h"
 
 namespace quantis
 {
@@ -12,17 +14,19 @@ namespace quantis
     class CppMarketDataService
     {
     public:
-        explicit CppMarketDataService(MarketDataStore &store) {}
+        explicit CppMarketDataService([[maybe_unused]] MarketDataStore &store) {}
 
         bool start() { return false; }
         void stop() {}
         bool isRunning() const { return false; }
 
-        void setSymbols(const std::vector<std::string> &symbols) {}
-        void addSymbol(const std::string &symbol) {}
-        void removeSymbol(const std::string &symbol) {}
-        void setApiKey(const std::string &apiKey) {}
-        void setUpdateInterval(std::chrono::milliseconds interval) {}
+        void setSymbols([[maybe_unused]] const std::vector<std::string> &symbols) {}
+        void addSymbol([[maybe_unused]] const std::string &symbol) {}
+        void removeSymbol([[maybe_unused]] const std::string &symbol) {}
+        void setApiKey([[maybe_unused]] const std::string &apiKey) {}
+        void setUpdateInterval([[maybe_unused]] std::chrono::milliseconds interval) {}
+        void setRateLimit([[maybe_unused]] double requestsPerSecond, [[maybe_unused]] double burst) {}
+        void setActivitySource([[maybe_unused]] ActivitySource source) {}
 
         struct PerformanceMetrics
         {
@@ -0,0 +1,20 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace quantis
+{
+
+    // Spin-wait hint: lets the sibling hyperthread run and avoids a memory-order flush on loop exit
+    inline void cpuRelax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+} // namespace quantis
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "BookSide.h"
+#include "MarketDataStore.h"
+
+namespace quantis
+{
+
+    /**
+     * Incrementally maintained top levels of one book side
+     *
+     * The book reports each level whose quantity or order count changed, or
+     * that it created or erased. Levels behind the top LEVELS are ignored
+     * unless they now rank inside it, and when a level drops out the one
+     * behind the last kept level is pulled in with a single next() step, so
+     * the side is never walked. The first position touched since the last
+     * flush is tracked so a publish only rewrites levels from there on.
+     */
+    class DepthTracker
+    {
+    public:
+        static constexpr size_t LEVELS = BookDepth::LEVELS;
+
+        explicit DepthTracker(BookSide &side) : side_(side) {}
+
+        /**
+         * Record a change to the level at price: level is its new state, or
+         * nullptr once it has been erased from the side
+         */
+        void levelChanged(Price price, const PriceLevel *level) noexcept
+        {
+            uint32_t i = 0;
+            while (i < count_ && better(entries_[i].price, price))
+            {
+                ++i;
+            }
+
+            if (i < count_ && entries_[i].price == price)
+            {
+                if (level)
+                {
+                    entries_[i].quantity = level->totalQuantity;
+                    entries_[i].orderCount = level->orderCount;
+                }
+                else
+                {
+                    remove(i);
+                }
+                touch(i);
+                return;
+            }
+
+            // A new level ranks inside the top only ahead of the last kept one, or while the top is short
+            if (!level || i >= LEVELS)
+            {
+                return;
+            }
+            count_ = std::min<uint32_t>(count_ + 1, LEVELS);
+            for (uint32_t j = count_ - 1; j > i; --j)
+            {
+                entries_[j] = entries_[j - 1];
+            }
+            entries_[i] = Entry{price, level->totalQuantity, level->orderCount};
+            touch(i);
+        }
+
+        bool dirty() const noexcept { return firstDirty_ != CLEAN; }
+        uint32_t count() const noexcept { return count_; }
+
+        /**
+         * Convert the levels changed since the last flush into out, at the
+         * same positions, and mark the side clean. Returns the first position
+         * written (count() if nothing changed).
+         */
+        uint32_t flush(std::array<DepthLevel, LEVELS> &out, double tickSize) noexcept
+        {
+            uint32_t first = std::min(firstDirty_, count_);
+            for (uint32_t i = first; i < count_; ++i)
+            {
+                out[i].price = static_cast<double>(entries_[i].price) * tickSize;
+                out[i].quantity = entries_[i].quantity;
+                out[i].orderCount = entries_[i].orderCount;
+            }
+            firstDirty_ = CLEAN;
+            return first;
+        }
+
+    private:
+        static constexpr uint32_t CLEAN = UINT32_MAX;
+
+        struct Entry
+        {
+            Price price;
+            int64_t quantity;
+            uint32_t orderCount;
+        };
+
+        BookSide &side_;
+        std::array<Entry, LEVELS> entries_{};
+        uint32_t count_{0};
+        uint32_t firstDirty_{CLEAN};
+
+        bool better(Price a, Price b) const noexcept { return side_.side() == Side::Buy ? a > b : a < b; }
+
+        void touch(uint32_t position) noexcept { firstDirty_ = std::min(firstDirty_, position); }
+
+        // Drop entry i and refill the top from the level behind the last kept one
+        void remove(uint32_t i) noexcept
+        {
+            bool wasFull = count_ == LEVELS;
+            for (uint32_t j = i + 1; j < count_; ++j)
+            {
+                entries_[j - 1] = entries_[j];
+            }
+            --count_;
+            if (!wasFull)
+            {
+                return;
+            }
+
+            const PriceLevel *next = count_ == 0 ? side_.best() : side_.next(side_.find(entries_[count_ - 1].price));
+            if (next)
+            {
+                entries_[count_++] = Entry{next->price, next->totalQuantity, next->orderCount};
+            }
+        }
+    };
+
+} // namespace quantis
@@ -0,0 +1,741 @@
+#include "EnginePersistence.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace quantis
+{
+
+    namespace
+    {
+        constexpr char SNAPSHOT_MAGIC[8] = {'Q', 'N', 'T', 'Q', 'S', 'N', 'P', '1'};
+        constexpr uint32_t SNAPSHOT_VERSION = 1;
+        constexpr const char *SNAPSHOT_PREFIX = "snapshot-";
+        constexpr const char *SNAPSHOT_SUFFIX = ".qsn";
+
+        // Snapshot layout: header, books (each followed by its symbol and
+        // orders), users, order IDs, then an FNV-1a checksum of all of it
+        struct SnapshotHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t bookCount;
+            uint64_t minSequence; // replay the journal after this
+            uint64_t nextOrderSequence;
+            uint64_t maxTradeSequence;
+            uint64_t userCount;
+            uint64_t bindingCount;
+        };
+
+        struct SnapshotBook
+        {
+            uint32_t symbolIndex; // for remapping handles written before the restart
+            uint8_t bookType;
+            uint8_t reserved0;
+            uint16_t symbolLength;
+            double tickSize;
+            uint64_t ladderLevels;
+            uint64_t eventSequence;
+            double lastTradePrice;
+            uint64_t orderCount;
+        };
+
+        struct SnapshotOrder
+        {
+            OrderHandle handle;
+            Price price;
+            int64_t quantity;
+            uint64_t timestamp;
+            uint32_t userIndex;
+            uint8_t side;
+            uint8_t reserved[3];
+        };
+
+        static_assert(sizeof(SnapshotHeader) == 56 && std::is_trivially_copyable_v<SnapshotHeader>);
+        static_assert(sizeof(SnapshotBook) == 48 && std::is_trivially_copyable_v<SnapshotBook>);
+        static_assert(sizeof(SnapshotOrder) == 40 && std::is_trivially_copyable_v<SnapshotOrder>);
+
+        struct LoadedBook
+        {
+            std::string symbol;
+            uint32_t symbolIndex;
+            BookConfig config;
+            BookImage image;
+        };
+
+        struct LoadedSnapshot
+        {
+            uint64_t minSequence{0};
+            uint64_t nextOrderSequence{1};
+            uint64_t maxTradeSequence{0};
+            std::vector<LoadedBook> books;
+            std::vector<std::string> users;
+            std::vector<std::pair<OrderHandle, std::string>> orderIds;
+        };
+
+        uint32_t checksum(const uint8_t *data, size_t length)
+        {
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < length; ++i)
+            {
+                hash = (hash ^ data[i]) * 16777619u;
+            }
+            return hash;
+        }
+
+        class SnapshotWriter
+        {
+        private:
+            std::vector<uint8_t> buffer_;
+
+        public:
+            void put(const void *data, size_t length)
+            {
+                const auto *bytes = static_cast<const uint8_t *>(data);
+                buffer_.insert(buffer_.end(), bytes, bytes + length);
+            }
+
+            const uint8_t *data() const noexcept { return buffer_.data(); }
+            size_t size() const noexcept { return buffer_.size(); }
+
+            void putString32(const std::string &text)
+            {
+                uint32_t length = static_cast<uint32_t>(text.size());
+                put(&length, sizeof(length));
+                put(text.data(), text.size());
+            }
+
+            // Write to a temporary file, make it durable, then rename it into place
+            bool commit(const std::filesystem::path &path)
+            {
+                uint32_t sum = checksum(buffer_.data(), buffer_.size());
+                put(&sum, sizeof(sum));
+
+                std::string temporary = path.string() + ".tmp";
+                int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                if (fd < 0)
+                {
+                    std::cerr << "Snapshot cannot create " << temporary << ": " << std::strerror(errno) << std::endl;
+                    return false;
+                }
+
+                size_t written = 0;
+                while (written < buffer_.size())
+                {
+                    ssize_t result = ::write(fd, buffer_.data() + written, buffer_.size() - written);
+                    if (result < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (result <= 0)
+                    {
+                        std::cerr << "Snapshot write failed for " << temporary << ": " << std::strerror(errno) << std::endl;
+                        ::close(fd);
+                        ::unlink(temporary.c_str());
+                        return false;
+                    }
+                    written += static_cast<size_t>(result);
+                }
+
+                bool durable = ::fsync(fd) == 0;
+                ::close(fd);
+                if (!durable || ::rename(temporary.c_str(), path.c_str()) != 0)
+                {
+                    std::cerr << "Snapshot commit failed for " << path.string() << ": " << std::strerror(errno) << std::endl;
+                    ::unlink(temporary.c_str());
+                    return false;
+                }
+
+                int directory = ::open(path.parent_path().c_str(), O_RDONLY | O_DIRECTORY);
+                if (directory >= 0)
+                {
+                    ::fsync(directory);
+                    ::close(directory);
+                }
+                return true;
+            }
+        };
+
+        class SnapshotReader
+        {
+        private:
+            const uint8_t *data_;
+            size_t size_;
+            size_t offset_{0};
+
+        public:
+            SnapshotReader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+            bool take(void *out, size_t length)
+            {
+                if (length > size_ - offset_)
+                {
+                    return false;
+                }
+                std::memcpy(out, data_ + offset_, length);
+                offset_ += length;
+                return true;
+            }
+
+            bool takeString(std::string &out, size_t length)
+            {
+                if (length > size_ - offset_)
+                {
+                    return false;
+                }
+                out.assign(reinterpret_cast<const char *>(data_ + offset_), length);
+                offset_ += length;
+                return true;
+            }
+
+            bool takeString32(std::string &out)
+            {
+                uint32_t length;
+                return take(&length, sizeof(length)) && takeString(out, length);
+            }
+
+            bool atEnd() const noexcept { return offset_ == size_; }
+        };
+
+        // Snapshot files, newest first
+        std::vector<std::filesystem::path> listSnapshots(const std::string &directory)
+        {
+            std::vector<std::pair<uint64_t, std::filesystem::path>> found;
+            std::error_code error;
+            for (const auto &entry : std::filesystem::directory_iterator(directory, error))
+            {
+                std::string name = entry.path().filename().string();
+                if (name.rfind(SNAPSHOT_PREFIX, 0) == 0 && entry.path().extension() == SNAPSHOT_SUFFIX)
+                {
+                    found.emplace_back(std::strtoull(name.c_str() + std::strlen(SNAPSHOT_PREFIX), nullptr, 10), entry.path());
+                }
+            }
+            std::sort(found.begin(), found.end(), [](const auto &a, const auto &b)
+                      { return a.first > b.first; });
+
+            std::vector<std::filesystem::path> paths;
+            for (auto &[sequence, path] : found)
+            {
+                paths.push_back(std::move(path));
+            }
+            return paths;
+        }
+
+        bool loadSnapshot(const std::filesystem::path &path, LoadedSnapshot &snapshot)
+        {
+            std::ifstream file(path, std::ios::binary);
+            std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            uint32_t stored;
+            if (bytes.size() < sizeof(SnapshotHeader) + sizeof(stored))
+            {
+                return false;
+            }
+            size_t body = bytes.size() - sizeof(stored);
+            std::memcpy(&stored, bytes.data() + body, sizeof(stored));
+            if (stored != checksum(bytes.data(), body))
+            {
+                return false;
+            }
+
+            SnapshotReader reader(bytes.data(), body);
+            SnapshotHeader header;
+            reader.take(&header, sizeof(header));
+            if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header.version != SNAPSHOT_VERSION)
+            {
+                return false;
+            }
+            snapshot.minSequence = header.minSequence;
+            snapshot.nextOrderSequence = header.nextOrderSequence;
+            snapshot.maxTradeSequence = header.maxTradeSequence;
+
+            for (uint32_t i = 0; i < header.bookCount; ++i)
+            {
+                SnapshotBook record;
+                LoadedBook &book = snapshot.books.emplace_back();
+                if (!reader.take(&record, sizeof(record)) || !reader.takeString(book.symbol, record.symbolLength))
+                {
+                    return false;
+                }
+                book.symbolIndex = record.symbolIndex;
+                book.config.type = static_cast<BookType>(record.bookType);
+                book.config.tickSize = record.tickSize;
+                book.config.ladderLevels = record.ladderLevels;
+                book.image.eventSequence = record.eventSequence;
+                book.image.lastTradePrice = record.lastTradePrice;
+
+                book.image.orders.reserve(record.orderCount);
+                for (uint64_t j = 0; j < record.orderCount; ++j)
+                {
+                    SnapshotOrder order;
+                    if (!reader.take(&order, sizeof(order)))
+                    {
+                        return false;
+                    }
+                    book.image.orders.push_back(BookImage::RestingOrder{order.handle, order.price, order.quantity, order.timestamp,
+                                                                        order.userIndex, static_cast<Side>(order.side)});
+                }
+            }
+
+            snapshot.users.resize(header.userCount);
+            for (std::string &user : snapshot.users)
+            {
+                if (!reader.takeString32(user))
+                {
+                    return false;
+                }
+            }
+
+            snapshot.orderIds.resize(header.bindingCount);
+            for (auto &[handle, orderId] : snapshot.orderIds)
+            {
+                if (!reader.take(&handle, sizeof(handle)) || !reader.takeString32(orderId))
+                {
+                    return false;
+                }
+            }
+            return reader.atEnd();
+        }
+
+        unsigned readUnsigned(const char *name, unsigned fallback)
+        {
+            const char *value = std::getenv(name);
+            return value && *value ? static_cast<unsigned>(std::strtoul(value, nullptr, 10)) : fallback;
+        }
+    }
+
+    PersistenceConfig PersistenceConfig::fromEnvironment()
+    {
+        PersistenceConfig config;
+        if (const char *directory = std::getenv("QUANTIS_JOURNAL_DIR"))
+        {
+            config.directory = directory;
+        }
+        if (unsigned megabytes = readUnsigned("QUANTIS_JOURNAL_SEGMENT_MB", 0))
+        {
+            config.segmentBytes = static_cast<size_t>(megabytes) * 1024 * 1024;
+        }
+        config.syncIntervalMs = std::max(1u, readUnsigned("QUANTIS_JOURNAL_SYNC_MS", config.syncIntervalMs));
+        config.snapshotIntervalSeconds = readUnsigned("QUANTIS_SNAPSHOT_INTERVAL_S", config.snapshotIntervalSeconds);
+        return config;
+    }
+
+    EnginePersistence::EnginePersistence(MatchingEngine &engine, BindingStore *bindings, const PersistenceConfig &config, std::unique_ptr<EventJournal> journal)
+        : engine_(engine), bindings_(bindings), config_(config), journal_(std::move(journal))
+    {
+    }
+
+    EnginePersistence::~EnginePersistence()
+    {
+        {
+            std::lock_guard<std::mutex> lock(timerMutex_);
+            stopping_ = true;
+        }
+        timerWake_.notify_all();
+        if (snapshotThread_.joinable())
+        {
+            snapshotThread_.join();
+        }
+
+        // A shutdown snapshot makes the next start a pure snapshot load
+        snapshot();
+        engine_.attachEventJournal(nullptr);
+    }
+
+    std::unique_ptr<EnginePersistence> EnginePersistence::open(MatchingEngine &engine, BindingStore *bindings, const PersistenceConfig &config)
+    {
+        EventJournal::Options options;
+        options.directory = config.directory;
+        options.segmentBytes = config.segmentBytes;
+        options.syncIntervalMs = config.syncIntervalMs;
+
+        auto journal = EventJournal::open(options);
+        if (!journal)
+        {
+            return nullptr;
+        }
+
+        std::unique_ptr<EnginePersistence> persistence(new EnginePersistence(engine, bindings, config, std::move(journal)));
+        if (!persistence->recover())
+        {
+            return nullptr;
+        }
+
+        // From here on every command is journaled; a fresh snapshot bounds the next replay
+        engine.attachEventJournal(persistence->journal_.get());
+        persistence->snapshot();
+
+        if (config.snapshotIntervalSeconds > 0)
+        {
+            persistence->snapshotThread_ = std::thread([raw = persistence.get()]
+                                                       { raw->runSnapshots(); });
+        }
+        return persistence;
+    }
+
+    bool EnginePersistence::recover()
+    {
+        auto started = std::chrono::steady_clock::now();
+
+        // Replayed fills were published before the restart; keep them off the trade rings
+        engine_.attachTradeRings(false);
+
+        LoadedSnapshot snapshot;
+        for (const auto &path : listSnapshots(config_.directory))
+        {
+            snapshot = LoadedSnapshot{};
+            if (loadSnapshot(path, snapshot))
+            {
+                std::cout << "Loaded snapshot " << path.string() << std::endl;
+                break;
+            }
+            std::cerr << "Ignoring damaged snapshot " << path.string() << std::endl;
+            snapshot = LoadedSnapshot{};
+        }
+
+        // Symbol indices can change across restarts, and handles carry them,
+        // so every handle read back is re-homed onto its book's current index
+        struct RecoveredBook
+        {
+            OrderBook *book;
+            uint64_t appliedThrough; // events up to here are already in the book
+        };
+        std::unordered_map<uint32_t, RecoveredBook> byIndex; // symbol index as written -> book
+        std::unordered_map<OrderBook *, uint64_t> appliedThrough;
+        uint64_t maxHandleSequence = 0;
+
+        auto remap = [&](OrderHandle handle) -> OrderHandle
+        {
+            auto it = byIndex.find(handleSymbolIndex(handle));
+            return it != byIndex.end() ? makeOrderHandle(it->second.book->getSymbolIndex(), handleSequence(handle)) : handle;
+        };
+
+        auto restoreBook = [&](const std::string &symbol, uint32_t symbolIndex, const BookConfig &config)
+        {
+            engine_.configureBook(symbol, config);
+            OrderBook *book = engine_.getOrCreateBook(symbol);
+            if (book)
+            {
+                byIndex[symbolIndex] = RecoveredBook{book, appliedThrough[book]};
+            }
+            return book;
+        };
+
+        for (LoadedBook &loaded : snapshot.books)
+        {
+            OrderBook *book = restoreBook(loaded.symbol, loaded.symbolIndex, loaded.config);
+            if (!book)
+            {
+                continue;
+            }
+            appliedThrough[book] = loaded.image.eventSequence;
+            byIndex[loaded.symbolIndex].appliedThrough = loaded.image.eventSequence;
+            for (BookImage::RestingOrder &order : loaded.image.orders)
+            {
+                maxHandleSequence = std::max(maxHandleSequence, handleSequence(order.handle));
+                order.handle = remap(order.handle);
+            }
+            book->restore(loaded.image);
+        }
+
+        // First pass: trade numbering and user bindings, so replayed fills get fresh IDs
+        uint64_t maxTradeSequence = snapshot.maxTradeSequence;
+        std::map<uint32_t, std::string> users;
+        for (size_t i = 0; i < snapshot.users.size(); ++i)
+        {
+            users[static_cast<uint32_t>(i + 1)] = snapshot.users[i];
+        }
+
+        uint64_t firstReplayed = 0;
+        journal_->replay(snapshot.minSequence, [&](const EventHeader &header, const uint8_t *payload, size_t size)
+                         {
+            if (!firstReplayed)
+            {
+                firstReplayed = header.sequence;
+            }
+            if (header.type == static_cast<uint16_t>(EventType::Fill) && size >= sizeof(Trade))
+            {
+                Trade trade;
+                std::memcpy(&trade, payload, sizeof(trade));
+                maxTradeSequence = std::max(maxTradeSequence, tradeSequence(trade.tradeId));
+            }
+            else if (header.type == static_cast<uint16_t>(EventType::BindUser) && size >= sizeof(BindEvent))
+            {
+                BindEvent bind;
+                std::memcpy(&bind, payload, sizeof(bind));
+                if (bind.length <= size - sizeof(bind))
+                {
+                    users.try_emplace(static_cast<uint32_t>(bind.id), reinterpret_cast<const char *>(payload + sizeof(bind)), bind.length);
+                }
+            } });
+
+        if (firstReplayed > snapshot.minSequence + 1)
+        {
+            std::cerr << "Event journal is missing sequences " << snapshot.minSequence + 1 << " to " << firstReplayed - 1
+                      << "; recovered state may be incomplete" << std::endl;
+        }
+
+        engine_.advanceTradeSequences(maxTradeSequence);
+        if (bindings_)
+        {
+            for (const auto &[index, name] : users)
+            {
+                bindings_->restoreUser(index, name);
+            }
+        }
+
+        // Second pass: rebuild the books, applying each command once
+        std::unordered_map<OrderHandle, std::string> orderIds;
+        for (const auto &[handle, orderId] : snapshot.orderIds)
+        {
+            maxHandleSequence = std::max(maxHandleSequence, handleSequence(handle));
+            orderIds[remap(handle)] = orderId;
+        }
+
+        std::vector<Trade> trades;
+        size_t replayed = 0;
+        journal_->replay(snapshot.minSequence, [&](const EventHeader &header, const uint8_t *payload, size_t size)
+                         {
+            switch (static_cast<EventType>(header.type))
+            {
+            case EventType::Book:
+            {
+                BookEvent event;
+                if (size < sizeof(event))
+                {
+                    return;
+                }
+                std::memcpy(&event, payload, sizeof(event));
+                if (event.symbolLength > size - sizeof(event))
+                {
+                    return;
+                }
+                BookConfig config;
+                config.type = static_cast<BookType>(event.bookType);
+                config.tickSize = event.tickSize;
+                config.ladderLevels = event.ladderLevels;
+                restoreBook(std::string(reinterpret_cast<const char *>(payload + sizeof(event)), event.symbolLength), event.symbolIndex, config);
+                return;
+            }
+            case EventType::New:
+            case EventType::Cancel:
+            case EventType::Amend:
+            {
+                OrderEvent event;
+                if (size < sizeof(event))
+                {
+                    return;
+                }
+                std::memcpy(&event, payload, sizeof(event));
+                auto it = byIndex.find(handleSymbolIndex(event.handle));
+                if (it == byIndex.end() || header.sequence <= it->second.appliedThrough)
+                {
+                    return;
+                }
+                maxHandleSequence = std::max(maxHandleSequence, handleSequence(event.handle));
+
+                OrderBook &book = *it->second.book;
+                OrderRequest request;
+                request.handle = remap(event.handle);
+                request.userIndex = event.userIndex;
+                request.side = static_cast<Side>(event.side);
+                request.price = event.price;
+                request.quantity = event.quantity;
+
+                if (header.type == static_cast<uint16_t>(EventType::Cancel))
+                {
+                    book.removeOrder(request.handle);
+                }
+                else if (header.type == static_cast<uint16_t>(EventType::Amend))
+                {
+                    book.updateOrder(request);
+                }
+                else if (event.flags & ORDER_EVENT_REST_ONLY)
+                {
+                    book.addOrder(request);
+                }
+                else
+                {
+                    trades.clear();
+                    book.matchOrder(request, trades);
+                }
+                ++replayed;
+                return;
+            }
+            case EventType::BindOrder:
+            {
+                BindEvent bind;
+                if (size < sizeof(bind))
+                {
+                    return;
+                }
+                std::memcpy(&bind, payload, sizeof(bind));
+                if (bind.length <= size - sizeof(bind))
+                {
+                    maxHandleSequence = std::max(maxHandleSequence, handleSequence(bind.id));
+                    orderIds[remap(bind.id)].assign(reinterpret_cast<const char *>(payload + sizeof(bind)), bind.length);
+                }
+                return;
+            }
+            case EventType::Fill:
+            case EventType::BindUser:
+                return;
+            } });
+
+        if (bindings_)
+        {
+            for (const auto &[handle, orderId] : orderIds)
+            {
+                bindings_->restoreOrderId(handle, orderId);
+            }
+        }
+        engine_.reserveOrderSequence(std::max(snapshot.nextOrderSequence, maxHandleSequence + 1));
+        engine_.attachTradeRings(true);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        std::cout << "Recovered " << engine_.getBookCount() << " book(s) from " << config_.directory << ": "
+                  << replayed << " journaled command(s) replayed after sequence " << snapshot.minSequence
+                  << " in " << elapsed.count() << " ms" << std::endl;
+        return true;
+    }
+
+    bool EnginePersistence::snapshot()
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+
+        // Bindings journaled up to here are in the copy taken next; later ones replay
+        uint64_t minSequence = journal_->lastSequence();
+        std::vector<std::string> users;
+        std::vector<std::pair<OrderHandle, std::string>> orderIds;
+        if (bindings_)
+        {
+            bindings_->saveBindings(users, orderIds);
+        }
+
+        SnapshotWriter books;
+        uint32_t bookCount = 0;
+        BookImage image;
+        for (OrderBook *book : engine_.getBooks())
+        {
+            if (!engine_.captureBook(*book, image))
+            {
+                std::cerr << "Snapshot could not capture " << book->getSymbol() << std::endl;
+                return false;
+            }
+            minSequence = std::min(minSequence, image.eventSequence);
+
+            const BookConfig &config = book->getConfig();
+            SnapshotBook record{};
+            record.symbolIndex = book->getSymbolIndex();
+            record.bookType = static_cast<uint8_t>(config.type);
+            record.symbolLength = static_cast<uint16_t>(book->getSymbol().size());
+            record.tickSize = config.tickSize;
+            record.ladderLevels = config.ladderLevels;
+            record.eventSequence = image.eventSequence;
+            record.lastTradePrice = image.lastTradePrice;
+            record.orderCount = image.orders.size();
+            books.put(&record, sizeof(record));
+            books.put(book->getSymbol().data(), book->getSymbol().size());
+
+            for (const BookImage::RestingOrder &order : image.orders)
+            {
+                SnapshotOrder entry{};
+                entry.handle = order.handle;
+                entry.price = order.price;
+                entry.quantity = order.quantity;
+                entry.timestamp = order.timestamp;
+                entry.userIndex = order.userIndex;
+                entry.side = static_cast<uint8_t>(order.side);
+                books.put(&entry, sizeof(entry));
+            }
+            ++bookCount;
+        }
+
+        uint64_t maxTradeSequence = 0;
+        for (size_t i = 0; i < engine_.getTradeJournalCount(); ++i)
+        {
+            maxTradeSequence = std::max(maxTradeSequence, engine_.getTradeJournal(i).lastSequence());
+        }
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.bookCount = bookCount;
+        header.minSequence = minSequence;
+        header.nextOrderSequence = engine_.getNextOrderSequence();
+        header.maxTradeSequence = maxTradeSequence;
+        header.userCount = users.size();
+        header.bindingCount = orderIds.size();
+
+        // Books were serialized first so the header could carry the final minSequence
+        SnapshotWriter writer;
+        writer.put(&header, sizeof(header));
+        writer.put(books.data(), books.size());
+        for (const std::string &user : users)
+        {
+            writer.putString32(user);
+        }
+        for (const auto &[handle, orderId] : orderIds)
+        {
+            writer.put(&handle, sizeof(handle));
+            writer.putString32(orderId);
+        }
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s%020" PRIu64 "%s", SNAPSHOT_PREFIX, minSequence, SNAPSHOT_SUFFIX);
+        if (!writer.commit(std::filesystem::path(config_.directory) / name))
+        {
+            return false;
+        }
+
+        // Keep a fallback snapshot; the journal must still reach back to the oldest one kept
+        auto snapshots = listSnapshots(config_.directory);
+        for (size_t i = SNAPSHOTS_KEPT; i < snapshots.size(); ++i)
+        {
+            std::error_code error;
+            std::filesystem::remove(snapshots[i], error);
+        }
+        snapshots.resize(std::min(snapshots.size(), SNAPSHOTS_KEPT));
+        uint64_t oldest = std::strtoull(snapshots.back().filename().string().c_str() + std::strlen(SNAPSHOT_PREFIX), nullptr, 10);
+        journal_->discardThrough(oldest);
+        return true;
+    }
+
+    void EnginePersistence::runSnapshots()
+    {
+        std::unique_lock<std::mutex> lock(timerMutex_);
+        while (!timerWake_.wait_for(lock, std::chrono::seconds(config_.snapshotIntervalSeconds), [this]
+                                    { return stopping_; }))
+        {
+            lock.unlock();
+            snapshot();
+            lock.lock();
+        }
+    }
+
+    void EnginePersistence::bindUser(uint32_t index, const std::string &name)
+    {
+        BindEvent event{};
+        event.id = index;
+        event.length = static_cast<uint32_t>(name.size());
+        journal_->append(EventType::BindUser, &event, sizeof(event), name.data(), name.size());
+    }
+
+    void EnginePersistence::bindOrder(OrderHandle handle, const std::string &orderId)
+    {
+        BindEvent event{};
+        event.id = handle;
+        event.length = static_cast<uint32_t>(orderId.size());
+        journal_->append(EventType::BindOrder, &event, sizeof(event), orderId.data(), orderId.size());
+    }
+
+} // namespace quantis
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "EventJournal.h"
+#include "MatchingEngine.h"
+
+namespace quantis
+{
+
+    /**
+     * The string side of user indices and order handles
+     *
+     * Only the JNI layer knows user and order IDs; it implements this so a
+     * snapshot can include them and recovery can hand them back.
+     */
+    class BindingStore
+    {
+    public:
+        virtual ~BindingStore() = default;
+
+        // Every interned user in index order (from 1), and the IDs of live orders
+        virtual void saveBindings(std::vector<std::string> &users, std::vector<std::pair<OrderHandle, std::string>> &orders) = 0;
+
+        // Recovery: users arrive in index order; order IDs once the books are rebuilt
+        virtual void restoreUser(uint32_t index, const std::string &name) = 0;
+        virtual void restoreOrderId(OrderHandle handle, const std::string &orderId) = 0;
+    };
+
+    struct PersistenceConfig
+    {
+        std::string directory;                   // empty = persistence off
+        size_t segmentBytes{64 * 1024 * 1024};   // journal segment size
+        unsigned syncIntervalMs{10};             // group commit interval
+        unsigned snapshotIntervalSeconds{60};    // 0 = only at startup and shutdown
+
+        // Reads QUANTIS_JOURNAL_DIR, QUANTIS_JOURNAL_SEGMENT_MB, QUANTIS_JOURNAL_SYNC_MS
+        // and QUANTIS_SNAPSHOT_INTERVAL_S
+        static PersistenceConfig fromEnvironment();
+
+        bool enabled() const noexcept { return !directory.empty(); }
+    };
+
+    /**
+     * Durable engine state: event journal plus periodic book snapshots
+     *
+     * Every accepted command and fill goes to the event journal. A snapshot
+     * ("snapshot-<sequence>.qsn") holds each book's resting orders, the
+     * bindings and the sequence counters, and lets journal segments it
+     * covers be deleted. On startup the newest valid snapshot is loaded and
+     * only the journal tail after it is replayed, so restart time depends on
+     * the snapshot interval rather than on the whole session's flow.
+     *
+     * Replay rebuilds the books but does not publish: the engine's trade
+     * rings are detached meanwhile, so the tail's fills, which went out
+     * before the restart, do not reach the trade consumer again as new trades.
+     */
+    class EnginePersistence
+    {
+    private:
+        MatchingEngine &engine_;
+        BindingStore *bindings_;
+        PersistenceConfig config_;
+        std::unique_ptr<EventJournal> journal_;
+
+        std::mutex snapshotMutex_; // one snapshot at a time
+        std::mutex timerMutex_;
+        std::condition_variable timerWake_;
+        bool stopping_{false};
+        std::thread snapshotThread_;
+
+        static constexpr size_t SNAPSHOTS_KEPT = 2;
+
+        EnginePersistence(MatchingEngine &engine, BindingStore *bindings, const PersistenceConfig &config, std::unique_ptr<EventJournal> journal);
+
+        bool recover();
+        void runSnapshots();
+
+    public:
+        ~EnginePersistence();
+
+        EnginePersistence(const EnginePersistence &) = delete;
+        EnginePersistence &operator=(const EnginePersistence &) = delete;
+
+        /**
+         * Open the journal, rebuild engine state from the latest snapshot and
+         * the journal tail, then start journaling. Call before the engine takes
+         * any orders. Returns nullptr (and logs why) if the journal cannot be
+         * opened; a damaged snapshot falls back to the previous one.
+         */
+        static std::unique_ptr<EnginePersistence> open(MatchingEngine &engine, BindingStore *bindings, const PersistenceConfig &config);
+
+        // Write a snapshot now and drop the journal segments it makes redundant
+        bool snapshot();
+
+        // Journal new bindings; called by the JNI layer as IDs are assigned
+        void bindUser(uint32_t index, const std::string &name);
+        void bindOrder(OrderHandle handle, const std::string &orderId);
+
+        EventJournal &journal() noexcept { return *journal_; }
+    };
+
+} // namespace quantis
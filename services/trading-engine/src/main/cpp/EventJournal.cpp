@@ -0,0 +1,424 @@
+#include "EventJournal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace quantis
+{
+
+    namespace
+    {
+        constexpr const char *SEGMENT_PREFIX = "events-";
+        constexpr const char *SEGMENT_SUFFIX = ".qej";
+
+        size_t alignRecord(size_t length)
+        {
+            return (length + EventJournal::RECORD_ALIGNMENT - 1) / EventJournal::RECORD_ALIGNMENT * EventJournal::RECORD_ALIGNMENT;
+        }
+
+        // FNV-1a over the record, treating the checksum field as zero
+        uint32_t checksum(const uint8_t *record, size_t length)
+        {
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < length; ++i)
+            {
+                uint8_t byte = (i >= offsetof(EventHeader, checksum) && i < offsetof(EventHeader, checksum) + sizeof(uint32_t)) ? 0 : record[i];
+                hash = (hash ^ byte) * 16777619u;
+            }
+            return hash;
+        }
+
+        std::string segmentName(uint64_t firstSequence)
+        {
+            char name[64];
+            std::snprintf(name, sizeof(name), "%s%020" PRIu64 "%s", SEGMENT_PREFIX, firstSequence, SEGMENT_SUFFIX);
+            return name;
+        }
+
+        void logError(const char *what, const std::string &path)
+        {
+            std::cerr << "EventJournal " << what << " failed for " << path << ": " << std::strerror(errno) << std::endl;
+        }
+
+        void syncDirectory(const std::string &directory)
+        {
+            int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+            if (fd >= 0)
+            {
+                ::fsync(fd);
+                ::close(fd);
+            }
+        }
+
+        void syncRange(uint8_t *base, size_t from, size_t to)
+        {
+            static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            size_t start = from / page * page;
+            if (to > start)
+            {
+                ::msync(base + start, to - start, MS_SYNC);
+            }
+        }
+    }
+
+    EventJournal::Segment::~Segment()
+    {
+        if (base)
+        {
+            ::munmap(base, size);
+        }
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+
+    EventJournal::~EventJournal()
+    {
+        {
+            std::lock_guard<std::mutex> lock(syncMutex_);
+            running_.store(false, std::memory_order_release);
+        }
+        syncWake_.notify_all();
+        if (flusher_.joinable())
+        {
+            flusher_.join();
+        }
+        syncPending();
+    }
+
+    std::unique_ptr<EventJournal> EventJournal::open(const Options &options)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(options.directory, error);
+        if (error)
+        {
+            std::cerr << "EventJournal cannot create " << options.directory << ": " << error.message() << std::endl;
+            return nullptr;
+        }
+
+        std::unique_ptr<EventJournal> journal(new EventJournal(options));
+        if (!journal->recover())
+        {
+            return nullptr;
+        }
+        journal->flusher_ = std::thread([raw = journal.get()]
+                                        { raw->runFlusher(); });
+        return journal;
+    }
+
+    std::vector<std::pair<uint64_t, std::string>> EventJournal::listSegments() const
+    {
+        std::vector<std::pair<uint64_t, std::string>> segments;
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(options_.directory, error))
+        {
+            std::string name = entry.path().filename().string();
+            if (name.rfind(SEGMENT_PREFIX, 0) != 0 || name.size() <= std::strlen(SEGMENT_SUFFIX) ||
+                name.compare(name.size() - std::strlen(SEGMENT_SUFFIX), std::string::npos, SEGMENT_SUFFIX) != 0)
+            {
+                continue;
+            }
+            uint64_t first = std::strtoull(name.c_str() + std::strlen(SEGMENT_PREFIX), nullptr, 10);
+            segments.emplace_back(first, entry.path().string());
+        }
+        std::sort(segments.begin(), segments.end());
+        return segments;
+    }
+
+    std::shared_ptr<EventJournal::Segment> EventJournal::mapSegment(const std::string &path, uint64_t firstSequence, bool create) const
+    {
+        auto segment = std::make_shared<Segment>();
+        segment->path = path;
+        segment->firstSequence = firstSequence;
+        segment->fd = ::open(path.c_str(), create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0644);
+        if (segment->fd < 0)
+        {
+            logError("open", path);
+            return nullptr;
+        }
+
+        if (create)
+        {
+            // Reserve the blocks up front so a full disk fails here, not as SIGBUS on a store
+            int result = ::posix_fallocate(segment->fd, 0, static_cast<off_t>(options_.segmentBytes));
+            if (result != 0 && ::ftruncate(segment->fd, static_cast<off_t>(options_.segmentBytes)) != 0)
+            {
+                logError("allocate", path);
+                return nullptr;
+            }
+        }
+
+        struct stat info;
+        if (::fstat(segment->fd, &info) != 0 || info.st_size <= 0)
+        {
+            logError("fstat", path);
+            return nullptr;
+        }
+        segment->size = static_cast<size_t>(info.st_size);
+
+        void *base = ::mmap(nullptr, segment->size, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+        if (base == MAP_FAILED)
+        {
+            logError("mmap", path);
+            return nullptr;
+        }
+        segment->base = static_cast<uint8_t *>(base);
+        return segment;
+    }
+
+    size_t EventJournal::scan(const Segment &segment, uint64_t expectedSequence, const Visitor *visitor, uint64_t afterSequence, uint64_t &lastSequence)
+    {
+        size_t offset = 0;
+        while (offset + sizeof(EventHeader) <= segment.size)
+        {
+            EventHeader header;
+            std::memcpy(&header, segment.base + offset, sizeof(header));
+            if (header.length < sizeof(EventHeader) || header.length % RECORD_ALIGNMENT != 0 ||
+                header.length > segment.size - offset || header.sequence != expectedSequence ||
+                header.checksum != checksum(segment.base + offset, header.length))
+            {
+                break;
+            }
+
+            if (visitor && header.sequence > afterSequence)
+            {
+                (*visitor)(header, segment.base + offset + sizeof(EventHeader), header.length - sizeof(EventHeader));
+            }
+            lastSequence = header.sequence;
+            ++expectedSequence;
+            offset += header.length;
+        }
+        return offset;
+    }
+
+    bool EventJournal::recover()
+    {
+        auto segments = listSegments();
+        // Older segments may have been discarded after a snapshot; the chain starts at the oldest left
+        uint64_t lastSequence = segments.empty() ? 0 : segments.front().first - 1;
+
+        for (size_t i = 0; i < segments.size(); ++i)
+        {
+            const auto &[first, path] = segments[i];
+            if (first != lastSequence + 1)
+            {
+                // A gap means an earlier segment lost its tail; nothing after it can be trusted
+                for (size_t j = i; j < segments.size(); ++j)
+                {
+                    std::cerr << "EventJournal discarding unreachable segment " << segments[j].second << std::endl;
+                    std::filesystem::rename(segments[j].second, segments[j].second + ".discarded");
+                }
+                segments.resize(i);
+                break;
+            }
+
+            auto segment = mapSegment(path, first, false);
+            if (!segment)
+            {
+                return false;
+            }
+            size_t end = scan(*segment, first, nullptr, 0, lastSequence);
+
+            if (i + 1 == segments.size() || segments[i + 1].first != lastSequence + 1)
+            {
+                // This is the tail: clear anything past the last good record so a
+                // stale record beyond a torn one can never be mistaken for a new one
+                for (size_t offset = end; offset < segment->size; offset += sizeof(uint64_t))
+                {
+                    uint64_t word;
+                    std::memcpy(&word, segment->base + offset, sizeof(word));
+                    if (word != 0)
+                    {
+                        std::memset(segment->base + end, 0, segment->size - end);
+                        std::cerr << "EventJournal trimmed a torn tail after sequence " << lastSequence << std::endl;
+                        break;
+                    }
+                }
+                active_ = segment;
+                writeOffset_ = end;
+            }
+        }
+
+        lastSequence_ = lastSequence;
+        if (!active_)
+        {
+            return roll(lastSequence_ + 1);
+        }
+        std::cout << "EventJournal opened " << options_.directory << " at sequence " << lastSequence_ << std::endl;
+        return true;
+    }
+
+    bool EventJournal::roll(uint64_t firstSequence)
+    {
+        std::string path = (std::filesystem::path(options_.directory) / segmentName(firstSequence)).string();
+        auto segment = mapSegment(path, firstSequence, true);
+        if (!segment)
+        {
+            return false;
+        }
+        syncDirectory(options_.directory);
+
+        if (active_)
+        {
+            retired_.push_back(std::move(active_));
+        }
+        active_ = std::move(segment);
+        writeOffset_ = 0;
+        syncWake_.notify_one();
+        return true;
+    }
+
+    uint64_t EventJournal::append(EventType type, const void *payload, size_t payloadSize, const void *tail, size_t tailSize)
+    {
+        size_t length = alignRecord(sizeof(EventHeader) + payloadSize + tailSize);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failed_)
+        {
+            return 0;
+        }
+        if (length > options_.segmentBytes)
+        {
+            // Not even a fresh segment could hold it; rolling would only map past its end
+            std::cerr << "EventJournal rejected a " << length << " byte record: segments are "
+                      << options_.segmentBytes << " bytes" << std::endl;
+            return 0;
+        }
+        if (writeOffset_ + length > active_->size && !roll(lastSequence_ + 1))
+        {
+            failed_ = true;
+            std::cerr << "EventJournal stopped: cannot start a new segment" << std::endl;
+            return 0;
+        }
+
+        uint8_t *record = active_->base + writeOffset_;
+        std::memcpy(record + sizeof(EventHeader), payload, payloadSize);
+        if (tailSize)
+        {
+            std::memcpy(record + sizeof(EventHeader) + payloadSize, tail, tailSize);
+        }
+
+        EventHeader header{};
+        header.length = static_cast<uint32_t>(length);
+        header.sequence = ++lastSequence_;
+        header.type = static_cast<uint16_t>(type);
+        std::memcpy(record, &header, sizeof(header));
+        header.checksum = checksum(record, length);
+        std::memcpy(record + offsetof(EventHeader, checksum), &header.checksum, sizeof(header.checksum));
+
+        writeOffset_ += length;
+        return header.sequence;
+    }
+
+    void EventJournal::replay(uint64_t afterSequence, const Visitor &visitor) const
+    {
+        auto segments = listSegments();
+        uint64_t lastSequence = segments.empty() ? 0 : segments.front().first - 1;
+        for (size_t i = 0; i < segments.size(); ++i)
+        {
+            const auto &[first, path] = segments[i];
+            if (first != lastSequence + 1)
+            {
+                break;
+            }
+            if (i + 1 < segments.size() && segments[i + 1].first <= afterSequence + 1)
+            {
+                // Every record here is at or before the replay point
+                lastSequence = segments[i + 1].first - 1;
+                continue;
+            }
+
+            auto segment = active_ && active_->path == path ? active_ : mapSegment(path, first, false);
+            if (!segment)
+            {
+                break;
+            }
+            scan(*segment, first, &visitor, afterSequence, lastSequence);
+        }
+    }
+
+    void EventJournal::syncPending()
+    {
+        std::lock_guard<std::mutex> serial(syncMutex_);
+
+        std::vector<std::shared_ptr<Segment>> retired;
+        std::shared_ptr<Segment> active;
+        size_t end;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            retired.swap(retired_);
+            active = active_;
+            end = writeOffset_;
+        }
+
+        // Rolled segments get one final full sync, then their mapping is dropped
+        for (auto &segment : retired)
+        {
+            ::msync(segment->base, segment->size, MS_SYNC);
+        }
+
+        if (active != syncedSegment_)
+        {
+            syncedSegment_ = active;
+            syncedOffset_ = 0;
+        }
+        if (active && end > syncedOffset_)
+        {
+            syncRange(active->base, syncedOffset_, end);
+            syncedOffset_ = end;
+        }
+    }
+
+    void EventJournal::runFlusher()
+    {
+        std::unique_lock<std::mutex> lock(syncMutex_);
+        while (running_.load(std::memory_order_acquire))
+        {
+            syncWake_.wait_for(lock, std::chrono::milliseconds(options_.syncIntervalMs));
+            lock.unlock();
+            syncPending();
+            lock.lock();
+        }
+    }
+
+    void EventJournal::sync()
+    {
+        syncPending();
+    }
+
+    void EventJournal::discardThrough(uint64_t sequence)
+    {
+        auto segments = listSegments();
+        std::string activePath;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            activePath = active_ ? active_->path : std::string();
+        }
+
+        // Segment i holds sequences [first(i), first(i + 1)); drop it once all are covered
+        for (size_t i = 0; i + 1 < segments.size(); ++i)
+        {
+            if (segments[i + 1].first <= sequence + 1 && segments[i].second != activePath)
+            {
+                std::error_code error;
+                std::filesystem::remove(segments[i].second, error);
+            }
+        }
+    }
+
+    uint64_t EventJournal::lastSequence()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lastSequence_;
+    }
+
+} // namespace quantis
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Order.h"
+
+namespace quantis
+{
+
+    /**
+     * Record types in the event journal
+     *
+     * Inbound commands are journaled once the book has accepted them, so
+     * replaying them in order rebuilds the book exactly; fills are the
+     * outbound side, kept for downstream consumers and to resume trade
+     * numbering. Bindings record the strings behind user indices and order
+     * handles, which only the JNI layer knows.
+     */
+    enum class EventType : uint16_t
+    {
+        Book = 1,      // BookEvent + symbol characters
+        New = 2,       // OrderEvent
+        Cancel = 3,    // OrderEvent (handle only)
+        Amend = 4,     // OrderEvent
+        Fill = 5,      // Trade
+        BindUser = 6,  // BindEvent (id = user index) + user ID characters
+        BindOrder = 7  // BindEvent (id = handle) + order ID characters
+    };
+
+    struct EventHeader
+    {
+        uint32_t length;   // whole record including this header, a multiple of 8
+        uint32_t checksum; // FNV-1a over the record with this field zeroed
+        uint64_t sequence; // 1, 2, 3, ... across all segments
+        uint16_t type;     // EventType
+        uint16_t reserved0;
+        uint32_t reserved1;
+    };
+
+    struct BookEvent
+    {
+        uint32_t symbolIndex; // index in the writing process, for remapping handles
+        uint8_t bookType;     // BookType
+        uint8_t reserved0;
+        uint16_t symbolLength;
+        double tickSize;
+        uint64_t ladderLevels;
+    };
+
+    // OrderEvent::flags
+    inline constexpr uint8_t ORDER_EVENT_REST_ONLY = 1; // New via OrderBook::addOrder: rested without matching
+
+    struct OrderEvent
+    {
+        OrderHandle handle;
+        uint32_t userIndex;
+        uint8_t side; // Side
+        uint8_t flags;
+        uint16_t reserved1;
+        double price;
+        int64_t quantity;
+    };
+
+    struct BindEvent
+    {
+        uint64_t id;
+        uint32_t length;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(EventHeader) == 24 && std::is_trivially_copyable_v<EventHeader>);
+    static_assert(sizeof(BookEvent) == 24 && std::is_trivially_copyable_v<BookEvent>);
+    static_assert(sizeof(OrderEvent) == 32 && std::is_trivially_copyable_v<OrderEvent>);
+    static_assert(sizeof(BindEvent) == 16 && std::is_trivially_copyable_v<BindEvent>);
+
+    /**
+     * Durable append-only journal in memory-mapped segment files
+     *
+     * Records are copied straight into a mapped, preallocated segment
+     * ("events-<first sequence>.qej") under a short mutex, so an append is a
+     * memcpy rather than a write(2). A background thread makes them durable
+     * with one msync per interval (group commit): a crash loses at most the
+     * last interval of records, and a torn record at the tail is detected
+     * by its checksum and dropped on the next open.
+     */
+    class EventJournal
+    {
+    public:
+        struct Options
+        {
+            std::string directory;
+            size_t segmentBytes{64 * 1024 * 1024};
+            unsigned syncIntervalMs{10};
+        };
+
+        // header and payload of one record, valid only inside the visitor call
+        using Visitor = std::function<void(const EventHeader &header, const uint8_t *payload, size_t payloadSize)>;
+
+    private:
+        struct Segment
+        {
+            std::string path;
+            uint64_t firstSequence{0};
+            int fd{-1};
+            uint8_t *base{nullptr};
+            size_t size{0};
+            ~Segment();
+        };
+
+        Options options_;
+
+        std::mutex mutex_; // guards everything below that appenders touch
+        std::shared_ptr<Segment> active_;
+        size_t writeOffset_{0};
+        uint64_t lastSequence_{0};
+        bool failed_{false};
+        std::vector<std::shared_ptr<Segment>> retired_; // rolled segments awaiting their final sync
+
+        std::mutex syncMutex_;
+        std::condition_variable syncWake_;
+        std::shared_ptr<Segment> syncedSegment_; // under syncMutex_
+        size_t syncedOffset_{0};                 // durable prefix of syncedSegment_
+        std::atomic<bool> running_{true};
+        std::thread flusher_;
+
+        explicit EventJournal(const Options &options) : options_(options) {}
+
+        bool recover();
+        bool roll(uint64_t firstSequence);
+        std::shared_ptr<Segment> mapSegment(const std::string &path, uint64_t firstSequence, bool create) const;
+        std::vector<std::pair<uint64_t, std::string>> listSegments() const;
+        void runFlusher();
+        void syncPending();
+
+        // Walk valid records of a mapped segment; returns the offset just past the last one
+        static size_t scan(const Segment &segment, uint64_t expectedSequence, const Visitor *visitor, uint64_t afterSequence, uint64_t &lastSequence);
+
+    public:
+        static constexpr size_t RECORD_ALIGNMENT = 8;
+
+        ~EventJournal();
+
+        EventJournal(const EventJournal &) = delete;
+        EventJournal &operator=(const EventJournal &) = delete;
+
+        /**
+         * Open (creating if needed) the journal in options.directory, trimming
+         * any torn tail. Returns nullptr (and logs why) on failure.
+         */
+        static std::unique_ptr<EventJournal> open(const Options &options);
+
+        /**
+         * Append one record: payload, then optional trailing bytes (strings).
+         * Returns its sequence, or 0 if the record could not be written.
+         */
+        uint64_t append(EventType type, const void *payload, size_t payloadSize, const void *tail = nullptr, size_t tailSize = 0);
+
+        /**
+         * Visit every record with sequence > afterSequence, in order. Call
+         * before the first append (recovery), not concurrently with writers.
+         */
+        void replay(uint64_t afterSequence, const Visitor &visitor) const;
+
+        // Make everything appended so far durable now
+        void sync();
+
+        // Delete whole segments that only hold records <= sequence
+        void discardThrough(uint64_t sequence);
+
+        uint64_t lastSequence();
+        const std::string &directory() const noexcept { return options_.directory; }
+    };
+
+} // namespace quantis
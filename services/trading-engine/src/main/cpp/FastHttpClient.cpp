@@ -1,4 +1,6 @@
 #include "FastHttpClient.h"
+#include "LatencyHistogram.h"
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <sstream>
@@ -9,7 +11,8 @@ namespace quantis
 
     // Static member definitions
     CURLSH *FastHttpClient::shareHandle_ = nullptr;
-    std::atomic<bool> FastHttpClient::shareInitialized_{false};
+    std::once_flag FastHttpClient::shareOnce_;
+    std::mutex FastHttpClient::shareLocks_[CURL_LOCK_DATA_LAST];
 
     FastHttpClient::FastHttpClient()
     {
@@ -22,33 +25,58 @@ namespace quantis
         // Initialize shared handle for connection pooling
         initializeShareHandle();
 
+        configureHandle(curl_);
+        curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &responseBuffer_);
+
+        // Streams of concurrent fetches to one host share a single HTTP/2 connection
+        multi_ = curl_multi_init();
+        if (multi_)
+        {
+            curl_multi_setopt(multi_, CURLMOPT_PIPELINING, static_cast<long>(CURLPIPE_MULTIPLEX));
+        }
+    }
+
+    void FastHttpClient::configureHandle(CURL *handle)
+    {
         // Configure CURL for maximum performance
-        curl_easy_setopt(curl_, CURLOPT_SHARE, shareHandle_);
-        curl_easy_setopt(curl_, CURLOPT_FOLLOWLOCATION, 1L);
-        curl_easy_setopt(curl_, CURLOPT_MAXREDIRS, 3L);
-        curl_easy_setopt(curl_, CURLOPT_TIMEOUT_MS, 100L);       // 100ms timeout
-        curl_easy_setopt(curl_, CURLOPT_CONNECTTIMEOUT_MS, 50L); // 50ms connect timeout
-        curl_easy_setopt(curl_, CURLOPT_TCP_KEEPALIVE, 1L);
-        curl_easy_setopt(curl_, CURLOPT_TCP_KEEPIDLE, 60L);
-        curl_easy_setopt(curl_, CURLOPT_TCP_KEEPINTVL, 60L);
+        curl_easy_setopt(handle, CURLOPT_SHARE, shareHandle_);
+        curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(handle, CURLOPT_MAXREDIRS, 3L);
+        curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, 100L);       // 100ms timeout
+        curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, 50L); // 50ms connect timeout
+        curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(handle, CURLOPT_TCP_KEEPIDLE, 60L);
+        curl_easy_setopt(handle, CURLOPT_TCP_KEEPINTVL, 60L);
 
         // Disable SSL verification for speed (use only for trusted APIs)
-        curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYPEER, 0L);
-        curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYHOST, 0L);
+        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
 
         // Enable compression
-        curl_easy_setopt(curl_, CURLOPT_ACCEPT_ENCODING, "gzip,deflate");
+        curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "gzip,deflate");
 
         // Set user agent
-        curl_easy_setopt(curl_, CURLOPT_USERAGENT, "QuantisTradingEngine/1.0");
+        curl_easy_setopt(handle, CURLOPT_USERAGENT, "QuantisTradingEngine/1.0");
 
         // Configure write callback
-        curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, writeCallback);
-        curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &responseBuffer_);
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeCallback);
+
+        // Negotiate HTTP/2 over TLS, falling back to HTTP/1.1
+        curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
     }
 
     FastHttpClient::~FastHttpClient()
     {
+        for (auto &transfer : transfers_)
+        {
+            curl_easy_cleanup(transfer->handle);
+        }
+
+        if (multi_)
+        {
+            curl_multi_cleanup(multi_);
+        }
+
         if (curl_)
         {
             curl_easy_cleanup(curl_);
@@ -57,16 +85,29 @@ namespace quantis
 
     void FastHttpClient::initializeShareHandle()
     {
-        if (!shareInitialized_.exchange(true))
-        {
+        std::call_once(shareOnce_, []
+                       {
             shareHandle_ = curl_share_init();
             if (shareHandle_)
             {
+                // Blocking and pooled handles use the caches from different threads
+                curl_share_setopt(shareHandle_, CURLSHOPT_LOCKFUNC, lockShare);
+                curl_share_setopt(shareHandle_, CURLSHOPT_UNLOCKFUNC, unlockShare);
                 curl_share_setopt(shareHandle_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
                 curl_share_setopt(shareHandle_, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
                 curl_share_setopt(shareHandle_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
-            }
-        }
+            } });
+    }
+
+    void FastHttpClient::lockShare([[maybe_unused]] CURL *handle, curl_lock_data data,
+                                   [[maybe_unused]] curl_lock_access access, [[maybe_unused]] void *user)
+    {
+        shareLocks_[data].lock();
+    }
+
+    void FastHttpClient::unlockShare([[maybe_unused]] CURL *handle, curl_lock_data data, [[maybe_unused]] void *user)
+    {
+        shareLocks_[data].unlock();
     }
 
     size_t FastHttpClient::writeCallback(void *contents, size_t size, size_t nmemb, std::string *s)
@@ -97,6 +138,7 @@ namespace quantis
         // Update performance counters
         totalRequests_.fetch_add(1);
         totalLatencyNs_.fetch_add(duration.count());
+        latencyHistogram(LatencyMetric::HttpFetch).record(static_cast<uint64_t>(duration.count()));
 
         if (res != CURLE_OK)
         {
@@ -142,6 +184,7 @@ namespace quantis
         // Update performance counters
         totalRequests_.fetch_add(1);
         totalLatencyNs_.fetch_add(duration.count());
+        latencyHistogram(LatencyMetric::HttpFetch).record(static_cast<uint64_t>(duration.count()));
 
         if (res != CURLE_OK)
         {
@@ -152,6 +195,160 @@ namespace quantis
         return responseBuffer_;
     }
 
+    bool FastHttpClient::growPool(size_t size)
+    {
+        while (transfers_.size() < size)
+        {
+            CURL *handle = curl_easy_init();
+            if (!handle)
+            {
+                break;
+            }
+
+            configureHandle(handle);
+
+            // Wait for an existing connection to multiplex on rather than opening another
+            curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+
+            auto transfer = std::make_unique<Transfer>();
+            transfer->handle = handle;
+            idle_.push_back(transfer.get());
+            transfers_.push_back(std::move(transfer));
+        }
+
+        return !transfers_.empty();
+    }
+
+    bool FastHttpClient::startTransfer(Transfer &transfer, HttpRequest &request)
+    {
+        request.body.clear();
+        request.status = 0;
+        request.ok = false;
+
+        transfer.request = &request;
+        transfer.start = std::chrono::steady_clock::now();
+
+        curl_easy_setopt(transfer.handle, CURLOPT_URL, request.url.c_str());
+        curl_easy_setopt(transfer.handle, CURLOPT_WRITEDATA, &request.body);
+        curl_easy_setopt(transfer.handle, CURLOPT_PRIVATE, &transfer);
+
+        return curl_multi_add_handle(multi_, transfer.handle) == CURLM_OK;
+    }
+
+    bool FastHttpClient::finishTransfer(Transfer &transfer, CURLcode result)
+    {
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - transfer.start);
+
+        HttpRequest &request = *transfer.request;
+        if (result == CURLE_OK)
+        {
+            curl_easy_getinfo(transfer.handle, CURLINFO_RESPONSE_CODE, &request.status);
+        }
+        request.ok = result == CURLE_OK && request.status >= 200 && request.status < 300;
+        transfer.request = nullptr;
+
+        totalRequests_.fetch_add(1);
+        totalLatencyNs_.fetch_add(duration.count());
+        latencyHistogram(LatencyMetric::HttpFetch).record(static_cast<uint64_t>(duration.count()));
+
+        if (!request.ok)
+        {
+            failedRequests_.fetch_add(1);
+        }
+
+        return request.ok;
+    }
+
+    size_t FastHttpClient::getMany(std::vector<HttpRequest> &requests, size_t maxInFlight, std::chrono::microseconds startInterval)
+    {
+        std::lock_guard<std::mutex> lock(multiMutex_);
+
+        if (requests.empty())
+        {
+            return 0;
+        }
+
+        if (!multi_ || !growPool(std::min(std::max<size_t>(maxInFlight, 1), requests.size())))
+        {
+            // No event loop: fall back to one request at a time on the blocking handle
+            size_t succeeded = 0;
+            for (auto &request : requests)
+            {
+                request.body = get(request.url);
+                request.ok = !request.body.empty();
+                request.status = request.ok ? 200 : 0;
+                succeeded += request.ok ? 1 : 0;
+            }
+            return succeeded;
+        }
+
+        size_t limit = std::min(std::max<size_t>(maxInFlight, 1), transfers_.size());
+        size_t next = 0;
+        size_t active = 0;
+        size_t succeeded = 0;
+        auto nextStart = std::chrono::steady_clock::now();
+
+        while (next < requests.size() || active > 0)
+        {
+            // Start as many requests as the in-flight limit and the start interval allow
+            auto now = std::chrono::steady_clock::now();
+            while (next < requests.size() && active < limit && now >= nextStart)
+            {
+                Transfer *transfer = idle_.back();
+                idle_.pop_back();
+
+                HttpRequest &request = requests[next++];
+                if (!startTransfer(*transfer, request))
+                {
+                    finishTransfer(*transfer, CURLE_FAILED_INIT);
+                    idle_.push_back(transfer);
+                    continue;
+                }
+
+                ++active;
+                nextStart = now + startInterval;
+            }
+
+            int running = 0;
+            curl_multi_perform(multi_, &running);
+
+            int queued = 0;
+            while (CURLMsg *message = curl_multi_info_read(multi_, &queued))
+            {
+                if (message->msg != CURLMSG_DONE)
+                {
+                    continue;
+                }
+
+                CURL *handle = message->easy_handle;
+                CURLcode result = message->data.result;
+                Transfer *transfer = nullptr;
+                curl_easy_getinfo(handle, CURLINFO_PRIVATE, reinterpret_cast<char **>(&transfer));
+                curl_multi_remove_handle(multi_, handle);
+
+                succeeded += finishTransfer(*transfer, result) ? 1 : 0;
+                idle_.push_back(transfer);
+                --active;
+            }
+
+            if (next == requests.size() && active == 0)
+            {
+                break;
+            }
+
+            // Sleep until a socket is ready, a curl timer fires or the next request may start
+            int timeoutMs = 1000;
+            if (next < requests.size() && active < limit)
+            {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextStart - std::chrono::steady_clock::now());
+                timeoutMs = static_cast<int>(std::max<int64_t>(0, wait.count() + 1));
+            }
+            curl_multi_poll(multi_, nullptr, 0, timeoutMs, nullptr);
+        }
+
+        return succeeded;
+    }
+
     std::string FastHttpClient::buildAlphaVantageUrl(const std::string &symbol, const std::string &apiKey)
     {
         std::ostringstream url;
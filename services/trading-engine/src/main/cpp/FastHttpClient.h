@@ -4,12 +4,27 @@
 #include <memory>
 #include <curl/curl.h>
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <vector>
 
 namespace quantis
 {
 
+    /**
+     * One request of a concurrent fetch
+     *
+     * body keeps its capacity from one fetch to the next, so a request reused
+     * every refresh cycle stops allocating once it has seen its largest response.
+     */
+    struct HttpRequest
+    {
+        std::string url;
+        std::string body;
+        long status{0}; // HTTP status; 0 if the transfer failed
+        bool ok{false}; // transfer completed with a 2xx status
+    };
+
     /**
      * Ultra-fast HTTP client optimized for market data fetching
      *
@@ -27,17 +42,38 @@ namespace quantis
         std::string responseBuffer_;
         std::mutex mutex_;
 
+        // Concurrent fetches: one multi handle and a pool of easy handles, one per in-flight request
+        struct Transfer
+        {
+            CURL *handle{nullptr};
+            HttpRequest *request{nullptr};
+            std::chrono::steady_clock::time_point start;
+        };
+
+        CURLM *multi_{nullptr};
+        std::vector<std::unique_ptr<Transfer>> transfers_;
+        std::vector<Transfer *> idle_;
+        std::mutex multiMutex_;
+
         // Performance counters
         std::atomic<uint64_t> totalRequests_{0};
         std::atomic<uint64_t> failedRequests_{0};
         std::atomic<uint64_t> totalLatencyNs_{0};
 
-        // Connection pooling
+        // Connection pooling: DNS, cookies and TLS sessions shared by every handle of every client
         static CURLSH *shareHandle_;
-        static std::atomic<bool> shareInitialized_;
+        static std::once_flag shareOnce_;
+        static std::mutex shareLocks_[CURL_LOCK_DATA_LAST]; // one per kind of shared data
 
         static size_t writeCallback(void *contents, size_t size, size_t nmemb, std::string *s);
         static void initializeShareHandle();
+        static void lockShare(CURL *handle, curl_lock_data data, curl_lock_access access, void *user);
+        static void unlockShare(CURL *handle, curl_lock_data data, void *user);
+        static void configureHandle(CURL *handle);
+
+        bool growPool(size_t size);
+        bool startTransfer(Transfer &transfer, HttpRequest &request);
+        bool finishTransfer(Transfer &transfer, CURLcode result);
 
     public:
         FastHttpClient();
@@ -58,6 +94,17 @@ namespace quantis
          */
         std::string get(const std::string &url, const std::vector<std::string> &headers);
 
+        /**
+         * Fetch every request concurrently on one event loop, at most
+         * maxInFlight at a time, and return the number that succeeded.
+         * Requests to the same host share a multiplexed HTTP/2 connection
+         * that stays open between calls. Successive requests start at least
+         * startInterval apart, so a provider rate limit holds however many
+         * are in flight. Blocks until every request has completed or failed.
+         */
+        size_t getMany(std::vector<HttpRequest> &requests, size_t maxInFlight,
+                       std::chrono::microseconds startInterval = std::chrono::microseconds(0));
+
         /**
          * Build Alpha Vantage URL for market data
          */
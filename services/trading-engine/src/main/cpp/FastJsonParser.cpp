@@ -1,214 +1,568 @@
 #include "FastJsonParser.h"
-#include <cstring>
-#include <cstdlib>
-#include <iostream>
+#include "LatencyHistogram.h"
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <system_error>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace quantis
 {
 
-    FastJsonParser::MarketData FastJsonParser::parseAlphaVantage(const std::string &symbol, const std::string &jsonResponse)
+    namespace
     {
-        auto start = std::chrono::high_resolution_clock::now();
-
-        totalParses_.fetch_add(1);
+        constexpr size_t BLOCK_SIZE = 64;
 
-        MarketData data;
-        data.symbol = symbol;
+        // Per-byte classification of one 64-byte block, bit i = byte i
+        struct BlockMasks
+        {
+            uint64_t quote;
+            uint64_t backslash;
+            uint64_t structural; // : , { } [ ]
+        };
 
-        try
-        {
-            // Alpha Vantage response format:
-            // {
-            //   "Global Quote": {
-            //     "01. symbol": "AAPL",
-            //     "02. open": "150.00",
-            //     "03. high": "155.00",
-            //     "04. low": "148.00",
-            //     "05. price": "152.50",
-            //     "06. volume": "1000000"
-            //   }
-            // }
-
-            const char *json = jsonResponse.c_str();
-
-            // Find "Global Quote" section
-            const char *globalQuote = strstr(json, "\"Global Quote\"");
-            if (!globalQuote)
+        BlockMasks classify(const char *block) noexcept
+        {
+            BlockMasks masks{0, 0, 0};
+#if defined(__AVX2__)
+            for (size_t i = 0; i < BLOCK_SIZE; i += 32)
             {
-                throw std::runtime_error("Global Quote not found");
+                __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i));
+                auto match = [&](char c)
+                {
+                    return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(c)))));
+                };
+                masks.quote |= match('"') << i;
+                masks.backslash |= match('\\') << i;
+                masks.structural |= (match(':') | match(',') | match('{') | match('}') | match('[') | match(']')) << i;
             }
+#elif defined(__SSE2__)
+            for (size_t i = 0; i < BLOCK_SIZE; i += 16)
+            {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+                auto match = [&](char c)
+                {
+                    return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(c)))));
+                };
+                masks.quote |= match('"') << i;
+                masks.backslash |= match('\\') << i;
+                masks.structural |= (match(':') | match(',') | match('{') | match('}') | match('[') | match(']')) << i;
+            }
+#else
+            for (size_t i = 0; i < BLOCK_SIZE; ++i)
+            {
+                uint64_t bit = uint64_t{1} << i;
+                switch (block[i])
+                {
+                case '"':
+                    masks.quote |= bit;
+                    break;
+                case '\\':
+                    masks.backslash |= bit;
+                    break;
+                case ':':
+                case ',':
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                    masks.structural |= bit;
+                    break;
+                default:
+                    break;
+                }
+            }
+#endif
+            return masks;
+        }
 
-            // Extract values using fast string operations
-            data.open = extractDouble(globalQuote, "02. open");
-            data.high = extractDouble(globalQuote, "03. high");
-            data.low = extractDouble(globalQuote, "04. low");
-            data.lastPrice = extractDouble(globalQuote, "05. price");
-            data.volume = extractLong(globalQuote, "06. volume");
-
-            // Calculate bid/ask from high/low (simplified)
-            data.bestBid = data.low;
-            data.bestAsk = data.high;
+        // Bit i of the result is the XOR of bits 0..i: 1 from an opening quote up to its closing one
+        uint64_t prefixXor(uint64_t bits) noexcept
+        {
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            bits ^= bits << 16;
+            bits ^= bits << 32;
+            return bits;
+        }
 
-            data.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                                 std::chrono::high_resolution_clock::now().time_since_epoch())
-                                 .count();
-            data.isValid = true;
+        bool isJsonSpace(char c) noexcept
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
         }
-        catch (const std::exception &e)
+
+        std::string_view trim(const char *begin, const char *end) noexcept
         {
-            failedParses_.fetch_add(1);
-            data.isValid = false;
+            while (begin < end && isJsonSpace(*begin))
+            {
+                ++begin;
+            }
+            while (end > begin && isJsonSpace(end[-1]))
+            {
+                --end;
+            }
+            return std::string_view(begin, static_cast<size_t>(end - begin));
         }
 
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-        totalParseTimeNs_.fetch_add(duration.count());
+        /**
+         * One pass over a document's structural characters
+         *
+         * Stage one classifies each 64-byte block into bitmasks and clears
+         * everything inside strings (escapes included); stage two visits only
+         * the surviving positions, so plain characters cost a few bit
+         * operations per block. The visitor sees members as spans into the
+         * input:
+         *   bool member(int depth, std::string_view key, std::string_view value)
+         *   bool object(int depth, std::string_view key) - an object-valued member
+         *   bool close(int depth)                        - after } or ], at the new depth
+         * Returning false from any of them stops the scan successfully.
+         */
+        template <typename Visitor>
+        JsonParseError scanStructure(std::string_view json, Visitor &visitor) noexcept
+        {
+            const char *text = json.data();
+            size_t size = json.size();
+
+            int depth = 0;
+            const char *stringBegin = nullptr; // inside a string while set
+            std::string_view candidate;        // last closed string, a key if ':' follows
+            bool haveCandidate = false;
+            std::string_view key;
+            bool pendingValue = false; // between a key's ':' and its value
+            const char *valueBegin = nullptr;
+
+            uint64_t escapeCarry = 0;   // previous block ended in an unescaped backslash
+            uint64_t inStringCarry = 0; // previous block ended inside a string
+
+            alignas(64) char tail[BLOCK_SIZE];
+            for (size_t offset = 0; offset < size; offset += BLOCK_SIZE)
+            {
+                const char *block = text + offset;
+                if (size - offset < BLOCK_SIZE)
+                {
+                    std::memset(tail, 0, sizeof(tail));
+                    std::memcpy(tail, block, size - offset);
+                    block = tail;
+                }
+                BlockMasks masks = classify(block);
+
+                // A backslash escapes the next byte unless it is itself escaped
+                uint64_t escaped = escapeCarry;
+                uint64_t backslashes = masks.backslash & ~escaped;
+                escapeCarry = 0;
+                while (backslashes)
+                {
+                    uint64_t bit = backslashes & (0 - backslashes);
+                    if (bit == uint64_t{1} << 63)
+                    {
+                        escapeCarry = 1;
+                    }
+                    escaped |= bit << 1;
+                    backslashes &= ~(bit | (bit << 1));
+                }
+
+                uint64_t quotes = masks.quote & ~escaped;
+                uint64_t inString = prefixXor(quotes) ^ inStringCarry;
+                inStringCarry = 0 - (inString >> 63);
+                uint64_t tokens = quotes | (masks.structural & ~inString);
+
+                while (tokens)
+                {
+                    unsigned index = static_cast<unsigned>(__builtin_ctzll(tokens));
+                    tokens &= tokens - 1;
+                    const char *at = text + offset + index;
+
+                    switch (*at)
+                    {
+                    case '"':
+                        if (!stringBegin)
+                        {
+                            stringBegin = at + 1;
+                            break;
+                        }
+                        if (pendingValue && valueBegin < stringBegin)
+                        {
+                            pendingValue = false;
+                            if (!visitor.member(depth, key, std::string_view(stringBegin, static_cast<size_t>(at - stringBegin))))
+                            {
+                                return JsonParseError::None;
+                            }
+                        }
+                        else
+                        {
+                            candidate = std::string_view(stringBegin, static_cast<size_t>(at - stringBegin));
+                            haveCandidate = true;
+                        }
+                        stringBegin = nullptr;
+                        break;
+                    case ':':
+                        if (!haveCandidate || pendingValue)
+                        {
+                            return JsonParseError::Malformed;
+                        }
+                        key = candidate;
+                        haveCandidate = false;
+                        pendingValue = true;
+                        valueBegin = at + 1;
+                        break;
+                    case '{':
+                    case '[':
+                        if (pendingValue)
+                        {
+                            pendingValue = false;
+                            if (*at == '{' && !visitor.object(depth, key))
+                            {
+                                return JsonParseError::None;
+                            }
+                        }
+                        haveCandidate = false;
+                        ++depth;
+                        break;
+                    default: // , } ]
+                        if (pendingValue)
+                        {
+                            std::string_view value = trim(valueBegin, at);
+                            pendingValue = false;
+                            if (value.empty())
+                            {
+                                return JsonParseError::Malformed;
+                            }
+                            if (!visitor.member(depth, key, value))
+                            {
+                                return JsonParseError::None;
+                            }
+                        }
+                        haveCandidate = false;
+                        if (*at != ',')
+                        {
+                            if (--depth < 0)
+                            {
+                                return JsonParseError::Malformed;
+                            }
+                            if (!visitor.close(depth))
+                            {
+                                return JsonParseError::None;
+                            }
+                        }
+                        break;
+                    }
+                }
+            }
 
-        return data;
-    }
+            return stringBegin || depth != 0 ? JsonParseError::Malformed : JsonParseError::None;
+        }
 
-    FastJsonParser::MarketData FastJsonParser::parseAlphaVantageSafe(const std::string &symbol, const std::string &jsonResponse)
-    {
-        MarketData data = parseAlphaVantage(symbol, jsonResponse);
+        template <typename T>
+        bool toNumber(std::string_view text, T &out) noexcept
+        {
+            auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), out);
+            return error == std::errc() && end == text.data() + text.size();
+        }
 
-        // Additional validation
-        if (data.isValid)
+        struct GlobalQuoteVisitor
         {
-            if (data.lastPrice <= 0 || data.volume < 0)
+            enum Field : unsigned
             {
-                data.isValid = false;
-                failedParses_.fetch_add(1);
+                Open = 1,
+                High = 2,
+                Low = 4,
+                Price = 8,
+                Volume = 16,
+                Required = Open | High | Low | Price | Volume
+            };
+
+            FastJsonParser::MarketData &data;
+            int quoteDepth{-1}; // depth of the quote's members once inside it
+            bool apiMessage{false};
+            bool badNumber{false};
+            unsigned found{0};
+
+            template <typename T>
+            bool number(std::string_view value, Field field, T &out)
+            {
+                found |= field;
+                badNumber |= !toNumber(value, out);
+                return !badNumber;
             }
-        }
 
-        return data;
-    }
+            bool member(int depth, std::string_view key, std::string_view value)
+            {
+                if (depth == quoteDepth)
+                {
+                    if (key == "02. open")
+                    {
+                        return number(value, Open, data.open);
+                    }
+                    if (key == "03. high")
+                    {
+                        return number(value, High, data.high);
+                    }
+                    if (key == "04. low")
+                    {
+                        return number(value, Low, data.low);
+                    }
+                    if (key == "05. price")
+                    {
+                        return number(value, Price, data.lastPrice);
+                    }
+                    if (key == "06. volume")
+                    {
+                        return number(value, Volume, data.volume);
+                    }
+                    if (key == "01. symbol")
+                    {
+                        data.symbol.assign(value.data(), value.size());
+                    }
+                    return true;
+                }
+                if (depth == 1 && (key == "Error Message" || key == "Note" || key == "Information"))
+                {
+                    apiMessage = true;
+                }
+                return true;
+            }
 
-    double FastJsonParser::extractDouble(const char *json, const char *key)
-    {
-        // Find key in JSON
-        std::string keyPattern = "\"" + std::string(key) + "\"";
-        const char *keyPos = strstr(json, keyPattern.c_str());
-        if (!keyPos)
+            bool object(int depth, std::string_view key)
+            {
+                if (depth == 1 && key == "Global Quote")
+                {
+                    quoteDepth = 2;
+                }
+                return true;
+            }
+
+            // Everything we need is inside the quote object; stop when it closes
+            bool close(int depth) { return !(quoteDepth > 0 && depth < quoteDepth); }
+        };
+
+        struct FieldVisitor
         {
-            throw std::runtime_error("Key not found: " + std::string(key));
-        }
+            std::string_view key;
+            std::string_view value;
+            bool found{false};
 
-        // Find colon after key
-        const char *colonPos = strchr(keyPos, ':');
-        if (!colonPos)
+            bool member(int, std::string_view name, std::string_view text)
+            {
+                if (name == key)
+                {
+                    value = text;
+                    found = true;
+                    return false;
+                }
+                return true;
+            }
+
+            bool object(int, std::string_view) { return true; }
+            bool close(int) { return true; }
+        };
+
+        struct MultiFieldVisitor
         {
-            throw std::runtime_error("Colon not found after key: " + std::string(key));
-        }
+            const std::string_view *keys;
+            std::string_view *values;
+            size_t count;
+            uint64_t foundMask{0}; // bit i: keys[i] found (first 64 keys)
+            size_t found{0};
+
+            bool member(int, std::string_view name, std::string_view text)
+            {
+                for (size_t i = 0; i < count && i < 64; ++i)
+                {
+                    if ((foundMask & (1ULL << i)) == 0 && name == keys[i])
+                    {
+                        values[i] = text;
+                        foundMask |= 1ULL << i;
+                        ++found;
+                        break;
+                    }
+                }
+                return found < count;
+            }
+
+            bool object(int, std::string_view) { return true; }
+            bool close(int) { return true; }
+        };
 
-        // Skip whitespace after colon
-        const char *valueStart = colonPos + 1;
-        while (*valueStart == ' ' || *valueStart == '\t' || *valueStart == '\n')
+        uint64_t nowNs()
         {
-            valueStart++;
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::high_resolution_clock::now().time_since_epoch())
+                                             .count());
         }
 
-        // Find end of value (comma, brace, or bracket)
-        const char *valueEnd = valueStart;
-        while (*valueEnd && *valueEnd != ',' && *valueEnd != '}' && *valueEnd != ']' && *valueEnd != '"')
+        void validate(FastJsonParser::MarketData &data)
         {
-            valueEnd++;
+            if (data.isValid && (data.lastPrice <= 0 || data.volume < 0))
+            {
+                data.isValid = false;
+                data.error = JsonParseError::InvalidValue;
+            }
         }
+    }
 
-        // Convert to double
-        std::string valueStr(valueStart, valueEnd - valueStart);
-
-        // Remove quotes if present
-        if (valueStr.front() == '"' && valueStr.back() == '"')
+    const char *toString(JsonParseError error) noexcept
+    {
+        switch (error)
         {
-            valueStr = valueStr.substr(1, valueStr.length() - 2);
+        case JsonParseError::None:
+            return "none";
+        case JsonParseError::Malformed:
+            return "malformed JSON";
+        case JsonParseError::MissingQuote:
+            return "no Global Quote";
+        case JsonParseError::ApiMessage:
+            return "API message instead of a quote";
+        case JsonParseError::MissingField:
+            return "missing quote field";
+        case JsonParseError::InvalidNumber:
+            return "invalid number";
+        case JsonParseError::InvalidValue:
+            return "invalid quote values";
         }
-
-        return std::stod(valueStr);
+        return "unknown";
     }
 
-    long FastJsonParser::extractLong(const char *json, const char *key)
+    JsonParseError FastJsonParser::parseGlobalQuote(std::string_view json, MarketData &data) noexcept
     {
-        // Find key in JSON
-        std::string keyPattern = "\"" + std::string(key) + "\"";
-        const char *keyPos = strstr(json, keyPattern.c_str());
-        if (!keyPos)
+        // Alpha Vantage response format:
+        // {
+        //   "Global Quote": {
+        //     "01. symbol": "AAPL",
+        //     "02. open": "150.00",
+        //     "03. high": "155.00",
+        //     "04. low": "148.00",
+        //     "05. price": "152.50",
+        //     "06. volume": "1000000"
+        //   }
+        // }
+        GlobalQuoteVisitor visitor{data};
+        JsonParseError error = scanStructure(json, visitor);
+        if (visitor.badNumber)
         {
-            throw std::runtime_error("Key not found: " + std::string(key));
+            return JsonParseError::InvalidNumber;
         }
-
-        // Find colon after key
-        const char *colonPos = strchr(keyPos, ':');
-        if (!colonPos)
+        if (error != JsonParseError::None)
         {
-            throw std::runtime_error("Colon not found after key: " + std::string(key));
+            return error;
         }
-
-        // Skip whitespace after colon
-        const char *valueStart = colonPos + 1;
-        while (*valueStart == ' ' || *valueStart == '\t' || *valueStart == '\n')
+        if (visitor.quoteDepth < 0 || visitor.found == 0)
         {
-            valueStart++;
+            return visitor.apiMessage ? JsonParseError::ApiMessage : JsonParseError::MissingQuote;
         }
-
-        // Find end of value (comma, brace, or bracket)
-        const char *valueEnd = valueStart;
-        while (*valueEnd && *valueEnd != ',' && *valueEnd != '}' && *valueEnd != ']' && *valueEnd != '"')
+        if (visitor.found != GlobalQuoteVisitor::Required)
         {
-            valueEnd++;
+            return JsonParseError::MissingField;
         }
 
-        // Convert to long
-        std::string valueStr(valueStart, valueEnd - valueStart);
+        // Calculate bid/ask from high/low (simplified)
+        data.bestBid = data.low;
+        data.bestAsk = data.high;
+        return JsonParseError::None;
+    }
 
-        // Remove quotes if present
-        if (valueStr.front() == '"' && valueStr.back() == '"')
+    bool FastJsonParser::findField(std::string_view json, std::string_view key, std::string_view &value) noexcept
+    {
+        FieldVisitor visitor{key, {}, false};
+        scanStructure(json, visitor);
+        if (visitor.found)
         {
-            valueStr = valueStr.substr(1, valueStr.length() - 2);
+            value = visitor.value;
         }
+        return visitor.found;
+    }
 
-        return std::stol(valueStr);
+    size_t FastJsonParser::findFields(std::string_view json, const std::string_view *keys, std::string_view *values, size_t count) noexcept
+    {
+        MultiFieldVisitor visitor{keys, values, std::min<size_t>(count, 64)};
+        scanStructure(json, visitor);
+        return visitor.found;
     }
 
-    std::string FastJsonParser::extractString(const char *json, const char *key)
+    FastJsonParser::MarketData FastJsonParser::parseAlphaVantage(const std::string &symbol, std::string_view jsonResponse)
     {
-        // Find key in JSON
-        std::string keyPattern = "\"" + std::string(key) + "\"";
-        const char *keyPos = strstr(json, keyPattern.c_str());
-        if (!keyPos)
+        uint64_t start = nowNs();
+
+        totalParses_.fetch_add(1);
+
+        MarketData data;
+        data.error = parseGlobalQuote(jsonResponse, data);
+        data.symbol = symbol;
+        data.isValid = data.error == JsonParseError::None;
+        if (data.isValid)
         {
-            throw std::runtime_error("Key not found: " + std::string(key));
+            data.timestamp = nowNs();
         }
+        else
+        {
+            failedParses_.fetch_add(1);
+        }
+
+        uint64_t duration = nowNs() - start;
+        totalParseTimeNs_.fetch_add(duration);
+        latencyHistogram(LatencyMetric::JsonParse).record(duration);
 
-        // Find colon after key
-        const char *colonPos = strchr(keyPos, ':');
-        if (!colonPos)
+        return data;
+    }
+
+    FastJsonParser::MarketData FastJsonParser::parseAlphaVantageSafe(const std::string &symbol, std::string_view jsonResponse)
+    {
+        MarketData data = parseAlphaVantage(symbol, jsonResponse);
+
+        // Additional validation
+        if (data.isValid)
         {
-            throw std::runtime_error("Colon not found after key: " + std::string(key));
+            validate(data);
+            if (!data.isValid)
+            {
+                failedParses_.fetch_add(1);
+            }
         }
 
-        // Skip whitespace after colon
-        const char *valueStart = colonPos + 1;
-        while (*valueStart == ' ' || *valueStart == '\t' || *valueStart == '\n')
+        return data;
+    }
+
+    size_t FastJsonParser::parseAlphaVantageBatch(const std::string_view *responses, size_t count, MarketData *out)
+    {
+        if (count == 0)
         {
-            valueStart++;
+            return 0;
         }
 
-        // Find end of string (closing quote)
-        if (*valueStart != '"')
+        uint64_t start = nowNs();
+        size_t valid = 0;
+        for (size_t i = 0; i < count; ++i)
         {
-            throw std::runtime_error("String value not found for key: " + std::string(key));
+            if (i + 1 < count)
+            {
+                __builtin_prefetch(responses[i + 1].data());
+            }
+
+            MarketData &data = out[i];
+            data = MarketData{};
+            data.error = parseGlobalQuote(responses[i], data);
+            data.isValid = data.error == JsonParseError::None;
+            validate(data);
+            valid += data.isValid ? 1 : 0;
         }
 
-        valueStart++; // Skip opening quote
-        const char *valueEnd = valueStart;
-        while (*valueEnd && *valueEnd != '"')
+        uint64_t end = nowNs();
+        for (size_t i = 0; i < count; ++i)
         {
-            valueEnd++;
+            out[i].timestamp = out[i].isValid ? end : 0;
         }
 
-        return std::string(valueStart, valueEnd - valueStart);
+        // Counters and the histogram are touched once per batch, not per response
+        uint64_t duration = end - start;
+        totalParses_.fetch_add(count);
+        failedParses_.fetch_add(count - valid);
+        totalParseTimeNs_.fetch_add(duration);
+        latencyHistogram(LatencyMetric::JsonParse).record(duration / count);
+
+        return valid;
     }
 
     FastJsonParser::PerformanceMetrics FastJsonParser::getPerformanceMetrics() const
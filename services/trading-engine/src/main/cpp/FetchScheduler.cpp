@@ -0,0 +1,219 @@
+#include "FetchScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace quantis
+{
+
+    TokenBucket::TokenBucket(double ratePerSecond, double burst)
+        : ratePerNs_(0.0), burst_(0.0), tokens_(0.0)
+    {
+        setRate(ratePerSecond, burst);
+        tokens_ = burst_;
+    }
+
+    void TokenBucket::setRate(double ratePerSecond, double burst) noexcept
+    {
+        ratePerNs_ = std::max(ratePerSecond, 0.001) / 1e9;
+        burst_ = std::max(burst, 1.0);
+        tokens_ = std::min(tokens_, burst_);
+    }
+
+    void TokenBucket::refill(uint64_t nowNs) noexcept
+    {
+        if (lastRefillNs_ == 0 || nowNs < lastRefillNs_)
+        {
+            lastRefillNs_ = nowNs;
+            return;
+        }
+
+        tokens_ = std::min(burst_, tokens_ + static_cast<double>(nowNs - lastRefillNs_) * ratePerNs_);
+        lastRefillNs_ = nowNs;
+    }
+
+    bool TokenBucket::tryTake(uint64_t nowNs) noexcept
+    {
+        refill(nowNs);
+        if (tokens_ < 1.0)
+        {
+            return false;
+        }
+        tokens_ -= 1.0;
+        return true;
+    }
+
+    void TokenBucket::take(uint64_t nowNs) noexcept
+    {
+        refill(nowNs);
+        tokens_ -= 1.0;
+    }
+
+    size_t TokenBucket::available(uint64_t nowNs) noexcept
+    {
+        refill(nowNs);
+        return tokens_ >= 1.0 ? static_cast<size_t>(tokens_) : 0;
+    }
+
+    uint64_t TokenBucket::waitNs(uint64_t nowNs) noexcept
+    {
+        refill(nowNs);
+        if (tokens_ >= 1.0)
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>(std::ceil((1.0 - tokens_) / ratePerNs_));
+    }
+
+    FetchSchedulerConfig FetchSchedulerConfig::fromEnvironment()
+    {
+        FetchSchedulerConfig config;
+
+        if (const char *rate = std::getenv("QUANTIS_MD_RATE_PER_S"))
+        {
+            config.requestsPerSecond = std::strtod(rate, nullptr);
+        }
+
+        if (const char *burst = std::getenv("QUANTIS_MD_BURST"))
+        {
+            config.burst = std::strtod(burst, nullptr);
+        }
+
+        return config;
+    }
+
+    FetchScheduler::FetchScheduler(MarketDataStore &store, const FetchSchedulerConfig &config)
+        : store_(store), config_(config), bucket_(config.requestsPerSecond, config.burst)
+    {
+    }
+
+    void FetchScheduler::setSymbols(const std::vector<std::string> &symbols)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::vector<SymbolState> next;
+        next.reserve(symbols.size());
+        for (const auto &symbol : symbols)
+        {
+            auto it = std::find_if(symbols_.begin(), symbols_.end(),
+                                   [&](const SymbolState &state)
+                                   { return state.symbol == symbol; });
+            if (it != symbols_.end())
+            {
+                next.push_back(std::move(*it));
+            }
+            else
+            {
+                SymbolState state;
+                state.symbol = symbol;
+                next.push_back(std::move(state));
+            }
+        }
+
+        symbols_ = std::move(next);
+        candidates_.clear();
+        candidates_.reserve(symbols_.size());
+    }
+
+    void FetchScheduler::setActivitySource(ActivitySource source)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        activity_ = std::move(source);
+    }
+
+    void FetchScheduler::setRate(double requestsPerSecond, double burst)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_.requestsPerSecond = requestsPerSecond;
+        config_.burst = burst;
+        bucket_.setRate(requestsPerSecond, burst);
+    }
+
+    void FetchScheduler::setMinRefreshInterval(std::chrono::milliseconds interval)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_.minRefreshInterval = interval;
+    }
+
+    size_t FetchScheduler::next(uint64_t nowNs, size_t maxCount, std::vector<std::string> &out)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        size_t budget = std::min(maxCount, bucket_.available(nowNs));
+        if (budget == 0 || symbols_.empty())
+        {
+            return 0;
+        }
+
+        uint64_t minAgeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(config_.minRefreshInterval).count());
+
+        candidates_.clear();
+        for (auto &state : symbols_)
+        {
+            // A failed fetch counts as fresh until the next interval, so it cannot starve the rest
+            uint64_t freshAt = state.lastAttemptNs;
+            MarketDataValues values;
+            if (store_.getMarketData(store_.findSymbolIndex(state.symbol), values))
+            {
+                freshAt = std::max(freshAt, values.timestamp);
+            }
+
+            uint64_t ageNs = nowNs > freshAt ? nowNs - freshAt : 0;
+            if (ageNs < minAgeNs)
+            {
+                continue;
+            }
+
+            double weight = 1.0;
+            SymbolActivity activity;
+            if (activity_ && activity_(state.symbol, activity))
+            {
+                uint64_t trades = activity.totalTrades >= state.tradesAtFetch ? activity.totalTrades - state.tradesAtFetch : 0;
+                weight += config_.orderWeight * static_cast<double>(activity.openOrders) +
+                          config_.tradeWeight * static_cast<double>(trades);
+            }
+            state.tradesSeen = activity.totalTrades;
+
+            state.priority = static_cast<double>(ageNs) * 1e-9 * weight;
+            candidates_.push_back(&state);
+        }
+
+        size_t count = std::min(budget, candidates_.size());
+        std::partial_sort(candidates_.begin(), candidates_.begin() + static_cast<std::ptrdiff_t>(count), candidates_.end(),
+                          [](const SymbolState *a, const SymbolState *b)
+                          { return a->priority > b->priority; });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            SymbolState &state = *candidates_[i];
+            bucket_.tryTake(nowNs);
+            state.lastAttemptNs = nowNs;
+            state.tradesAtFetch = state.tradesSeen;
+            out.push_back(state.symbol);
+        }
+
+        return count;
+    }
+
+    void FetchScheduler::charge(const std::string &symbol, uint64_t nowNs)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        bucket_.take(nowNs);
+        for (auto &state : symbols_)
+        {
+            if (state.symbol == symbol)
+            {
+                state.lastAttemptNs = nowNs;
+                break;
+            }
+        }
+    }
+
+    uint64_t FetchScheduler::waitNs(uint64_t nowNs)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return bucket_.waitNs(nowNs);
+    }
+
+} // namespace quantis
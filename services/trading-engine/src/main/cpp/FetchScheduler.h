@@ -0,0 +1,126 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MarketDataStore.h"
+
+namespace quantis
+{
+
+    /**
+     * Request budget refilled at a steady rate up to a burst size
+     *
+     * Tokens may go negative: a forced fetch is always allowed and repaid out
+     * of later refills. Not thread-safe; FetchScheduler serializes access.
+     */
+    class TokenBucket
+    {
+    private:
+        double ratePerNs_;
+        double burst_;
+        double tokens_;
+        uint64_t lastRefillNs_{0};
+
+    public:
+        TokenBucket(double ratePerSecond, double burst);
+
+        void setRate(double ratePerSecond, double burst) noexcept;
+        void refill(uint64_t nowNs) noexcept;
+
+        bool tryTake(uint64_t nowNs) noexcept;
+        void take(uint64_t nowNs) noexcept;
+
+        // Whole tokens available at nowNs
+        size_t available(uint64_t nowNs) noexcept;
+
+        // Nanoseconds from nowNs until a whole token is available
+        uint64_t waitNs(uint64_t nowNs) noexcept;
+    };
+
+    // What the engine knows about a symbol, sampled every scheduling round
+    struct SymbolActivity
+    {
+        size_t openOrders{0};
+        uint64_t totalTrades{0}; // cumulative; the scheduler counts the trades since each fetch
+    };
+
+    // Fills activity for a symbol; false when the engine has no book for it
+    using ActivitySource = std::function<bool(const std::string &symbol, SymbolActivity &activity)>;
+
+    struct FetchSchedulerConfig
+    {
+        double requestsPerSecond{1000.0 / 12}; // provider budget (Alpha Vantage: one request per 12ms)
+        double burst{8};                       // requests that may be spent at once after an idle spell
+        std::chrono::milliseconds minRefreshInterval{12}; // a symbol is never fetched more often
+        double orderWeight{0.1};               // priority added per resting order
+        double tradeWeight{0.5};               // priority added per trade since the last fetch
+
+        // Reads QUANTIS_MD_RATE_PER_S and QUANTIS_MD_BURST
+        static FetchSchedulerConfig fromEnvironment();
+    };
+
+    /**
+     * Chooses which symbols to poll, within a token-bucket request budget
+     *
+     * Each round every symbol's priority is its staleness (time since its
+     * quote in the store was written, or since it was last attempted) scaled
+     * by its activity: resting orders in its book and trades since its last
+     * fetch. The highest priorities get the available tokens. Staleness keeps
+     * growing for idle symbols, so they still refresh, only less often than
+     * the ones being traded.
+     */
+    class FetchScheduler
+    {
+    private:
+        struct SymbolState
+        {
+            std::string symbol;
+            uint64_t lastAttemptNs{0};
+            uint64_t tradesAtFetch{0}; // book trade count when last fetched
+            uint64_t tradesSeen{0};    // book trade count this round
+            double priority{0.0};
+        };
+
+        MarketDataStore &store_;
+        FetchSchedulerConfig config_;
+        TokenBucket bucket_;
+        ActivitySource activity_;
+        std::vector<SymbolState> symbols_;
+        std::vector<SymbolState *> candidates_;
+        mutable std::mutex mutex_;
+
+    public:
+        FetchScheduler(MarketDataStore &store, const FetchSchedulerConfig &config = FetchSchedulerConfig::fromEnvironment());
+
+        // Symbols kept across calls keep their history
+        void setSymbols(const std::vector<std::string> &symbols);
+        void setActivitySource(ActivitySource source);
+        void setRate(double requestsPerSecond, double burst);
+        void setMinRefreshInterval(std::chrono::milliseconds interval);
+
+        /**
+         * Append up to maxCount symbols to fetch now, highest priority first,
+         * spending one token each. Returns the number appended.
+         */
+        size_t next(uint64_t nowNs, size_t maxCount, std::vector<std::string> &out);
+
+        // Spend a token for a fetch made outside next(), even if none is left
+        void charge(const std::string &symbol, uint64_t nowNs);
+
+        // Nanoseconds until next() can hand out another fetch
+        uint64_t waitNs(uint64_t nowNs);
+
+        // Clock the scheduler and the market data store timestamps share
+        static uint64_t nowNs() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::high_resolution_clock::now().time_since_epoch())
+                                             .count());
+        }
+    };
+
+} // namespace quantis
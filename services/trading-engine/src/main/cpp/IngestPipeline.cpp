@@ -0,0 +1,312 @@
+#include "IngestPipeline.h"
+#include "FetchScheduler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace quantis
+{
+
+    IngestConfig IngestConfig::fromEnvironment()
+    {
+        IngestConfig config;
+
+        if (const char *threads = std::getenv("QUANTIS_MD_PARSE_THREADS"))
+        {
+            config.parseThreads = static_cast<size_t>(std::strtoul(threads, nullptr, 10));
+        }
+
+        if (const char *capacity = std::getenv("QUANTIS_MD_INGEST_QUEUE"))
+        {
+            config.queueCapacity = static_cast<size_t>(std::strtoul(capacity, nullptr, 10));
+        }
+
+        if (const char *batch = std::getenv("QUANTIS_MD_PUBLISH_BATCH"))
+        {
+            config.publishBatch = static_cast<size_t>(std::strtoul(batch, nullptr, 10));
+        }
+
+        return config;
+    }
+
+    IngestPipeline::IngestPipeline(MarketDataStore &store, const IngestConfig &config)
+        : store_(store),
+          config_(config),
+          free_(std::max<size_t>(config.queueCapacity, 1)),
+          quotes_(std::max<size_t>(config.queueCapacity, 1))
+    {
+        config_.parseThreads = std::max<size_t>(config_.parseThreads, 1);
+        config_.publishBatch = std::max<size_t>(config_.publishBatch, 1);
+
+        // free_ is sized to the buffer count, so returning a buffer never waits
+        buffers_.reserve(free_.capacity());
+        for (size_t i = 0; i < free_.capacity(); ++i)
+        {
+            buffers_.push_back(std::make_unique<Response>());
+            free_.tryPush(buffers_.back().get());
+        }
+
+        workers_.reserve(config_.parseThreads);
+        for (size_t i = 0; i < config_.parseThreads; ++i)
+        {
+            workers_.push_back(std::make_unique<ParseWorker>(free_.capacity()));
+        }
+    }
+
+    IngestPipeline::~IngestPipeline()
+    {
+        stop();
+    }
+
+    void IngestPipeline::start()
+    {
+        if (running_)
+        {
+            return;
+        }
+
+        parsersStopping_.store(false);
+        publisherStopping_.store(false);
+        publisher_ = std::thread(&IngestPipeline::publishLoop, this);
+        for (auto &worker : workers_)
+        {
+            worker->thread = std::thread(&IngestPipeline::parseLoop, this, std::ref(*worker));
+        }
+        running_ = true;
+
+        std::cout << "Market data ingest started with " << workers_.size() << " parse worker(s)" << std::endl;
+    }
+
+    void IngestPipeline::stop()
+    {
+        if (!running_)
+        {
+            return;
+        }
+
+        // Parsers first, so the publisher sees every quote before it stops
+        parsersStopping_.store(true);
+        for (auto &worker : workers_)
+        {
+            wake(worker->sleeping);
+        }
+        for (auto &worker : workers_)
+        {
+            worker->thread.join();
+        }
+
+        publisherStopping_.store(true);
+        wake(publisherSleeping_);
+        publisher_.join();
+        running_ = false;
+    }
+
+    IngestPipeline::Response *IngestPipeline::acquire() noexcept
+    {
+        Response *response = nullptr;
+        while (!free_.tryPop(response))
+        {
+            std::this_thread::yield();
+        }
+        return response;
+    }
+
+    void IngestPipeline::submit(Response *response) noexcept
+    {
+        ParseWorker &worker = *workers_[response->symbolIndex % workers_.size()];
+
+        // Never full: it can hold every buffer
+        worker.jobs.tryPush(response);
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+        wake(worker.sleeping);
+    }
+
+    void IngestPipeline::wake(std::atomic<bool> &sleeping) noexcept
+    {
+        // Pairs with the fence in park(): either the consumer sees the work or we see it parked
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed))
+        {
+            sleeping.store(false, std::memory_order_relaxed);
+            sleeping.notify_one();
+        }
+    }
+
+    template <typename Ready>
+    void IngestPipeline::park(std::atomic<bool> &sleeping, const std::atomic<bool> &stopping, Ready ready)
+    {
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ready() || stopping.load())
+        {
+            sleeping.store(false, std::memory_order_relaxed);
+            return;
+        }
+        sleeping.wait(true, std::memory_order_relaxed);
+    }
+
+    void IngestPipeline::parseLoop(ParseWorker &worker)
+    {
+        std::array<Response *, PARSE_BATCH> batch;
+        std::array<std::string_view, PARSE_BATCH> bodies;
+        int idle = 0;
+
+        for (;;)
+        {
+            size_t count = 0;
+            while (count < PARSE_BATCH && worker.jobs.tryPop(batch[count]))
+            {
+                bodies[count] = batch[count]->body;
+                ++count;
+            }
+
+            if (count == 0)
+            {
+                // The fetcher has stopped before parsersStopping_ is raised, so empty means done
+                if (parsersStopping_.load() && worker.jobs.empty())
+                {
+                    return;
+                }
+                if (++idle >= IDLE_SPINS)
+                {
+                    park(worker.sleeping, parsersStopping_, [&worker] { return !worker.jobs.empty(); });
+                    idle = 0;
+                }
+                continue;
+            }
+            idle = 0;
+
+            worker.parser.parseAlphaVantageBatch(bodies.data(), count, worker.quotes.data());
+
+            uint64_t rejected = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const FastJsonParser::MarketData &data = worker.quotes[i];
+                if (data.isValid)
+                {
+                    Quote quote;
+                    quote.update.symbolIndex = batch[i]->symbolIndex;
+                    quote.update.bestBid = data.bestBid;
+                    quote.update.bestAsk = data.bestAsk;
+                    quote.update.lastPrice = data.lastPrice;
+                    quote.update.volume = data.volume;
+                    quote.fetchedAtNs = batch[i]->fetchedAtNs;
+                    quotes_.push(quote);
+                }
+                else
+                {
+                    ++rejected;
+                }
+                free_.tryPush(batch[i]);
+            }
+
+            if (rejected > 0)
+            {
+                rejected_.fetch_add(rejected, std::memory_order_relaxed);
+            }
+            if (rejected < count)
+            {
+                wake(publisherSleeping_);
+            }
+        }
+    }
+
+    void IngestPipeline::publishLoop()
+    {
+        std::vector<MarketDataUpdate> updates(config_.publishBatch);
+        std::vector<uint64_t> fetchedAt(config_.publishBatch);
+        int idle = 0;
+
+        for (;;)
+        {
+            size_t count = 0;
+            Quote quote;
+            while (count < updates.size() && quotes_.tryPop(quote))
+            {
+                updates[count] = quote.update;
+                fetchedAt[count] = quote.fetchedAtNs;
+                ++count;
+            }
+
+            if (count == 0)
+            {
+                if (publisherStopping_.load() && quotes_.empty())
+                {
+                    return;
+                }
+                if (++idle >= IDLE_SPINS)
+                {
+                    park(publisherSleeping_, publisherStopping_, [this] { return !quotes_.empty(); });
+                    idle = 0;
+                }
+                continue;
+            }
+            idle = 0;
+
+            size_t written = store_.updateMarketDataBatch(updates.data(), count);
+
+            uint64_t now = FetchScheduler::nowNs();
+            uint64_t latency = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                latency += now > fetchedAt[i] ? now - fetchedAt[i] : 0;
+            }
+            published_.fetch_add(written, std::memory_order_relaxed);
+            rejected_.fetch_add(count - written, std::memory_order_relaxed);
+            batches_.fetch_add(1, std::memory_order_relaxed);
+            latencyNs_.fetch_add(latency, std::memory_order_relaxed);
+        }
+    }
+
+    IngestStats IngestPipeline::getStats() const noexcept
+    {
+        IngestStats stats;
+        stats.submitted = submitted_.load(std::memory_order_relaxed);
+        stats.rejected = rejected_.load(std::memory_order_relaxed);
+        stats.published = published_.load(std::memory_order_relaxed);
+        stats.batches = batches_.load(std::memory_order_relaxed);
+        stats.latencyNs = latencyNs_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    FastJsonParser::PerformanceMetrics IngestPipeline::getParserMetrics() const
+    {
+        uint64_t total = 0;
+        uint64_t failed = 0;
+        double parseTimeMs = 0.0;
+        for (const auto &worker : workers_)
+        {
+            FastJsonParser::PerformanceMetrics metrics = worker->parser.getPerformanceMetrics();
+            total += metrics.totalParses;
+            failed += metrics.failedParses;
+            parseTimeMs += metrics.avgParseTimeMs * static_cast<double>(metrics.totalParses);
+        }
+
+        FastJsonParser::PerformanceMetrics metrics;
+        metrics.totalParses = total;
+        metrics.failedParses = failed;
+        metrics.avgParseTimeMs = total > 0 ? parseTimeMs / static_cast<double>(total) : 0.0;
+        metrics.successRate = total > 0 ? (double)(total - failed) / total * 100.0 : 0.0;
+        metrics.parsesPerSecond = parseTimeMs > 0 ? static_cast<double>(total) / (parseTimeMs / 1e3) : 0.0;
+        return metrics;
+    }
+
+    void IngestPipeline::resetMetrics()
+    {
+        for (auto &worker : workers_)
+        {
+            worker->parser.resetMetrics();
+        }
+        submitted_.store(0);
+        rejected_.store(0);
+        published_.store(0);
+        batches_.store(0);
+        latencyNs_.store(0);
+    }
+
+    bool IngestPipeline::isHealthy() const
+    {
+        return std::any_of(workers_.begin(), workers_.end(), [](const auto &worker) { return worker->parser.isHealthy(); });
+    }
+
+} // namespace quantis
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "FastJsonParser.h"
+#include "MarketDataStore.h"
+#include "RingBuffer.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace quantis
+{
+
+    struct IngestConfig
+    {
+        size_t parseThreads{2};     // parse workers, each with its own parser and buffers
+        size_t queueCapacity{4096}; // responses that may be between fetch and parse at once
+        size_t publishBatch{256};   // most quotes written to the store in one batch
+
+        // Reads QUANTIS_MD_PARSE_THREADS, QUANTIS_MD_INGEST_QUEUE and QUANTIS_MD_PUBLISH_BATCH
+        static IngestConfig fromEnvironment();
+    };
+
+    struct IngestStats
+    {
+        uint64_t submitted{0}; // responses handed over by the fetcher
+        uint64_t rejected{0};  // responses that did not parse into a valid quote
+        uint64_t published{0}; // quotes written to the store
+        uint64_t batches{0};   // store write batches
+        uint64_t latencyNs{0}; // fetch start to store write, summed over published quotes
+    };
+
+    /**
+     * Parse and publish stages of polled market data ingest
+     *
+     * The fetch thread takes an empty Response, fills it and submits it. Each
+     * symbol belongs to one parse worker (symbol index % workers), which
+     * drains its SPSC queue in batches through its own FastJsonParser and
+     * returns the buffers to the fetcher's free list. Parsed quotes meet in
+     * one MPSC queue drained by the publisher, which writes them to the
+     * store in batches. A symbol's quotes therefore reach the store in the
+     * order they were fetched, while parsing scales across threads.
+     *
+     * Response bodies are recycled, so steady-state ingest does not allocate.
+     * A full pipeline pushes back on the fetcher: acquire() waits for a
+     * free buffer. Idle stages spin briefly and then park until woken.
+     */
+    class IngestPipeline
+    {
+    public:
+        // One fetched response; the body buffer cycles between fetcher and parsers
+        struct Response
+        {
+            uint32_t symbolIndex{0};
+            uint64_t fetchedAtNs{0}; // FetchScheduler::nowNs() when the fetch started
+            std::string body;
+        };
+
+    private:
+        static constexpr size_t PARSE_BATCH = 32;
+        static constexpr int IDLE_SPINS = 1024; // empty polls before a stage parks
+
+        struct Quote
+        {
+            MarketDataUpdate update;
+            uint64_t fetchedAtNs;
+        };
+
+        struct ParseWorker
+        {
+            SpscRing<Response *> jobs;
+            std::atomic<bool> sleeping{false};
+            FastJsonParser parser;
+            std::array<FastJsonParser::MarketData, PARSE_BATCH> quotes; // reused across batches
+            std::thread thread;
+
+            explicit ParseWorker(size_t capacity) : jobs(capacity) {}
+        };
+
+        MarketDataStore &store_;
+        IngestConfig config_;
+
+        std::vector<std::unique_ptr<Response>> buffers_; // owns every response
+        MpscRing<Response *> free_;                      // parsers return, fetcher takes
+        std::vector<std::unique_ptr<ParseWorker>> workers_;
+        MpscRing<Quote> quotes_;                         // parsers push, publisher drains
+        std::atomic<bool> publisherSleeping_{false};
+        std::thread publisher_;
+
+        std::atomic<bool> parsersStopping_{false};
+        std::atomic<bool> publisherStopping_{false};
+        bool running_{false};
+
+        alignas(64) std::atomic<uint64_t> submitted_{0};
+        std::atomic<uint64_t> rejected_{0};
+        alignas(64) std::atomic<uint64_t> published_{0};
+        std::atomic<uint64_t> batches_{0};
+        std::atomic<uint64_t> latencyNs_{0};
+
+        void parseLoop(ParseWorker &worker);
+        void publishLoop();
+
+        // Producer side of a stage: wake its consumer if it parked
+        static void wake(std::atomic<bool> &sleeping) noexcept;
+
+        // Consumer side: park until woken, unless stop was raised or work arrived meanwhile
+        template <typename Ready>
+        static void park(std::atomic<bool> &sleeping, const std::atomic<bool> &stopping, Ready ready);
+
+    public:
+        IngestPipeline(MarketDataStore &store, const IngestConfig &config = IngestConfig::fromEnvironment());
+        ~IngestPipeline();
+
+        IngestPipeline(const IngestPipeline &) = delete;
+        IngestPipeline &operator=(const IngestPipeline &) = delete;
+
+        void start();
+
+        // Parse and publish everything submitted so far, then stop the stages
+        void stop();
+
+        /**
+         * Fetch thread only, while running: an empty response to fill,
+         * waiting while every buffer is still in the pipeline
+         */
+        Response *acquire() noexcept;
+
+        // Fetch thread only: hand a filled response to its symbol's parse worker
+        void submit(Response *response) noexcept;
+
+        size_t getParseThreads() const noexcept { return workers_.size(); }
+        IngestStats getStats() const noexcept;
+
+        // Parse counters of every worker's parser, combined
+        FastJsonParser::PerformanceMetrics getParserMetrics() const;
+        void resetMetrics();
+        bool isHealthy() const;
+    };
+
+} // namespace quantis
@@ -0,0 +1,63 @@
+#include "JniCache.h"
+#include <initializer_list>
+
+namespace quantis
+{
+
+    namespace
+    {
+        jclass globalClass(JNIEnv *env, const char *name)
+        {
+            jclass local = env->FindClass(name);
+            if (!local)
+            {
+                return nullptr;
+            }
+            auto global = static_cast<jclass>(env->NewGlobalRef(local));
+            env->DeleteLocalRef(local);
+            return global;
+        }
+    }
+
+    JniCache &jniCache() noexcept
+    {
+        static JniCache cache;
+        return cache;
+    }
+
+    bool JniCache::load(JNIEnv *env)
+    {
+        stringClass = globalClass(env, "java/lang/String");
+        objectClass = globalClass(env, "java/lang/Object");
+        hashMapClass = globalClass(env, "java/util/HashMap");
+        if (!stringClass || !objectClass || !hashMapClass)
+        {
+            unload(env);
+            return false;
+        }
+
+        hashMapInit = env->GetMethodID(hashMapClass, "<init>", "()V");
+        hashMapPut = env->GetMethodID(hashMapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+        if (!hashMapInit || !hashMapPut)
+        {
+            unload(env);
+            return false;
+        }
+        return true;
+    }
+
+    void JniCache::unload(JNIEnv *env)
+    {
+        for (jclass *cls : {&stringClass, &objectClass, &hashMapClass})
+        {
+            if (*cls)
+            {
+                env->DeleteGlobalRef(*cls);
+                *cls = nullptr;
+            }
+        }
+        hashMapInit = nullptr;
+        hashMapPut = nullptr;
+    }
+
+} // namespace quantis
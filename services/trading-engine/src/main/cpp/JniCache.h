@@ -0,0 +1,91 @@
+#pragma once
+
+#include <jni.h>
+#include <type_traits>
+
+namespace quantis
+{
+
+    /**
+     * Java classes and method IDs used by the JNI layer, resolved once
+     *
+     * FindClass is a class loader lookup and GetMethodID a name and signature
+     * search, each far costlier than the call that needs them. JNI_OnLoad
+     * resolves everything here; the classes are held as global refs, which
+     * keeps them loaded and their method IDs valid until JNI_OnUnload, so a
+     * JNI call costs only its own work. Read-only between load and unload.
+     */
+    struct JniCache
+    {
+        jclass stringClass{nullptr};
+        jclass objectClass{nullptr};
+        jclass hashMapClass{nullptr};
+        jmethodID hashMapInit{nullptr};
+        jmethodID hashMapPut{nullptr};
+
+        // False, with the Java exception pending, if a class or method is missing
+        bool load(JNIEnv *env);
+        void unload(JNIEnv *env);
+    };
+
+    JniCache &jniCache() noexcept;
+
+    /**
+     * Scoped GetPrimitiveArrayCritical access to a Java primitive array
+     *
+     * Usually pins the array instead of copying it, so numeric batch calls
+     * read and write Java's own memory. Construction only reads the length;
+     * acquire() pins. From the first acquire() until the scope ends the
+     * thread must not call JNI or block, not even GetArrayLength, since the
+     * GC may be held off for as long: construct every array a call needs,
+     * check their sizes, then acquire them. Read-only access releases with
+     * JNI_ABORT, so a copy is never written back.
+     */
+    template <typename T>
+    class JniCriticalArray
+    {
+    private:
+        JNIEnv *env_;
+        jarray array_;
+        T *data_{nullptr};
+        jsize length_{0};
+        jint releaseMode_;
+
+    public:
+        JniCriticalArray(JNIEnv *env, jarray array, bool readOnly = false)
+            : env_(env), array_(array), releaseMode_(readOnly ? JNI_ABORT : 0)
+        {
+            if (array_)
+            {
+                length_ = env_->GetArrayLength(array_);
+            }
+        }
+
+        // Pin the array; false if it is null or could not be pinned
+        bool acquire() noexcept
+        {
+            if (!data_ && array_)
+            {
+                data_ = static_cast<T *>(env_->GetPrimitiveArrayCritical(array_, nullptr));
+            }
+            return data_ != nullptr;
+        }
+
+        ~JniCriticalArray()
+        {
+            if (data_)
+            {
+                env_->ReleasePrimitiveArrayCritical(array_, const_cast<std::remove_const_t<T> *>(data_), releaseMode_);
+            }
+        }
+
+        JniCriticalArray(const JniCriticalArray &) = delete;
+        JniCriticalArray &operator=(const JniCriticalArray &) = delete;
+
+        explicit operator bool() const noexcept { return data_ != nullptr; }
+        T *data() const noexcept { return data_; }
+        jsize size() const noexcept { return length_; }
+        T &operator[](jsize i) const noexcept { return data_[i]; }
+    };
+
+} // namespace quantis
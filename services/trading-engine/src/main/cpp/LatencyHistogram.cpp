@@ -0,0 +1,127 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace quantis
+{
+
+    namespace
+    {
+        std::atomic<uint32_t> nextHistogramId{0};
+
+        // Per thread: this thread's buckets for each histogram, indexed by id
+        thread_local std::vector<void *> threadBuckets;
+    }
+
+    LatencyHistogram::LatencyHistogram(std::string name, uint64_t sampleMask)
+        : name_(std::move(name)), id_(nextHistogramId.fetch_add(1, std::memory_order_relaxed)), sampleMask_(sampleMask)
+    {
+    }
+
+    LatencyHistogram::ThreadBuckets &LatencyHistogram::localBuckets()
+    {
+        if (id_ < threadBuckets.size() && threadBuckets[id_])
+        {
+            return *static_cast<ThreadBuckets *>(threadBuckets[id_]);
+        }
+
+        // First record from this thread: allocate its buckets. They stay owned by
+        // the histogram (and so outlive the thread) until the histogram goes away.
+        auto buckets = std::make_unique<ThreadBuckets>();
+        ThreadBuckets *raw = buckets.get();
+        {
+            std::lock_guard<std::mutex> lock(threadsMutex_);
+            threads_.push_back(std::move(buckets));
+        }
+        if (threadBuckets.size() <= id_)
+        {
+            threadBuckets.resize(id_ + 1, nullptr);
+        }
+        threadBuckets[id_] = raw;
+        return *raw;
+    }
+
+    LatencySummary LatencyHistogram::summarize() const
+    {
+        std::vector<uint64_t> merged(BUCKETS, 0);
+        LatencySummary summary;
+        uint64_t sumNs = 0;
+        {
+            std::lock_guard<std::mutex> lock(threadsMutex_);
+            for (const auto &buckets : threads_)
+            {
+                for (size_t i = 0; i < BUCKETS; ++i)
+                {
+                    merged[i] += buckets->counts[i].load(std::memory_order_relaxed);
+                }
+                sumNs += buckets->sumNs.load(std::memory_order_relaxed);
+                summary.maxNs = std::max(summary.maxNs, buckets->maxNs.load(std::memory_order_relaxed));
+            }
+        }
+
+        // Count from the merged buckets rather than the per-thread totals so the
+        // percentile walk below is consistent with itself under concurrent records
+        for (uint64_t n : merged)
+        {
+            summary.count += n;
+        }
+        if (summary.count == 0)
+        {
+            return summary;
+        }
+        summary.meanNs = static_cast<double>(sumNs) / static_cast<double>(summary.count);
+
+        auto rankOf = [&](double quantile)
+        {
+            return std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(summary.count))));
+        };
+        const uint64_t ranks[3] = {rankOf(0.50), rankOf(0.99), rankOf(0.999)};
+        uint64_t *targets[3] = {&summary.p50Ns, &summary.p99Ns, &summary.p999Ns};
+
+        size_t next = 0;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS && next < 3; ++i)
+        {
+            seen += merged[i];
+            while (next < 3 && seen >= ranks[next])
+            {
+                *targets[next++] = std::min(bucketUpperBound(i), summary.maxNs);
+            }
+        }
+        return summary;
+    }
+
+    void LatencyHistogram::reset()
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex_);
+        for (const auto &buckets : threads_)
+        {
+            for (auto &count : buckets->counts)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+            buckets->sumNs.store(0, std::memory_order_relaxed);
+            buckets->maxNs.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    LatencyHistogram &latencyHistogram(LatencyMetric metric)
+    {
+        // Store reads and writes and risk checks are tens of nanoseconds, so
+        // only 1 in 64 is timed per thread to keep clock reads out of the hot path
+        static LatencyHistogram histograms[] = {
+            LatencyHistogram("store.read", 63),
+            LatencyHistogram("store.write", 63),
+            LatencyHistogram("book.addOrder"),
+            LatencyHistogram("book.matchOrder"),
+            LatencyHistogram("book.amendOrder"),
+            LatencyHistogram("json.parse"),
+            LatencyHistogram("http.fetch"),
+            LatencyHistogram("feed.tick"),
+            LatencyHistogram("risk.check", 63),
+        };
+        static_assert(sizeof(histograms) / sizeof(histograms[0]) == static_cast<size_t>(LatencyMetric::Count));
+        return histograms[static_cast<size_t>(metric)];
+    }
+
+} // namespace quantis
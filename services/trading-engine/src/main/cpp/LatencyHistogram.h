@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace quantis
+{
+
+    // Percentiles of one histogram, in nanoseconds
+    struct LatencySummary
+    {
+        uint64_t count{0};
+        double meanNs{0.0};
+        uint64_t p50Ns{0};
+        uint64_t p99Ns{0};
+        uint64_t p999Ns{0};
+        uint64_t maxNs{0};
+    };
+
+    /**
+     * Log-linear (HDR-style) latency histogram with per-thread buckets
+     *
+     * Values below 16 ns get exact buckets; above that every power of two is
+     * split into 16 sub-buckets, so any recorded value is reported within
+     * ~6%. Each recording thread owns its bucket array and updates it with
+     * plain relaxed stores (no locked RMW, no shared cache line); summarize()
+     * merges all threads' arrays on demand. A sample mask of 2^k - 1 records
+     * only every 2^k-th call per thread, for paths too hot to time every time.
+     */
+    class LatencyHistogram
+    {
+    public:
+        static constexpr unsigned SUB_BUCKET_BITS = 4;
+        static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+        static constexpr size_t BUCKETS = SUB_BUCKETS * (64 - SUB_BUCKET_BITS + 1);
+
+        static constexpr size_t bucketFor(uint64_t ns) noexcept
+        {
+            if (ns < SUB_BUCKETS)
+            {
+                return static_cast<size_t>(ns);
+            }
+            unsigned msb = 63u - static_cast<unsigned>(std::countl_zero(ns));
+            unsigned shift = msb - SUB_BUCKET_BITS;
+            return SUB_BUCKETS * (shift + 1) + static_cast<size_t>((ns >> shift) - SUB_BUCKETS);
+        }
+
+        // Largest value that lands in bucket
+        static constexpr uint64_t bucketUpperBound(size_t bucket) noexcept
+        {
+            if (bucket < SUB_BUCKETS)
+            {
+                return bucket;
+            }
+            unsigned shift = static_cast<unsigned>(bucket / SUB_BUCKETS - 1);
+            uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+            return lower + ((uint64_t{1} << shift) - 1);
+        }
+
+    private:
+        struct alignas(64) ThreadBuckets
+        {
+            std::array<std::atomic<uint64_t>, BUCKETS> counts{};
+            std::atomic<uint64_t> sumNs{0};
+            std::atomic<uint64_t> maxNs{0};
+            uint64_t calls{0}; // owner-only sampling counter
+        };
+
+        std::string name_;
+        uint32_t id_;
+        uint64_t sampleMask_;
+
+        mutable std::mutex threadsMutex_;
+        std::vector<std::unique_ptr<ThreadBuckets>> threads_;
+
+        ThreadBuckets &localBuckets();
+
+        static void bump(std::atomic<uint64_t> &value, uint64_t by) noexcept
+        {
+            value.store(value.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+        }
+
+    public:
+        explicit LatencyHistogram(std::string name, uint64_t sampleMask = 0);
+
+        LatencyHistogram(const LatencyHistogram &) = delete;
+        LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+        const std::string &name() const noexcept { return name_; }
+
+        // True if this call should be timed under the sample mask
+        bool sample() noexcept
+        {
+            return sampleMask_ == 0 || (localBuckets().calls++ & sampleMask_) == 0;
+        }
+
+        void record(uint64_t ns) noexcept
+        {
+            ThreadBuckets &buckets = localBuckets();
+            bump(buckets.counts[bucketFor(ns)], 1);
+            bump(buckets.sumNs, ns);
+            if (ns > buckets.maxNs.load(std::memory_order_relaxed))
+            {
+                buckets.maxNs.store(ns, std::memory_order_relaxed);
+            }
+        }
+
+        // Merge every thread's buckets; concurrent recording may be partially included
+        LatencySummary summarize() const;
+
+        // Zero all buckets; records racing with the reset may survive it
+        void reset();
+    };
+
+    /**
+     * Times a scope into a histogram, honouring its sample mask
+     */
+    class LatencyScope
+    {
+    private:
+        LatencyHistogram *histogram_;
+        std::chrono::steady_clock::time_point start_;
+
+    public:
+        explicit LatencyScope(LatencyHistogram &histogram) noexcept
+            : histogram_(histogram.sample() ? &histogram : nullptr)
+        {
+            if (histogram_)
+            {
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~LatencyScope()
+        {
+            if (histogram_)
+            {
+                auto elapsed = std::chrono::steady_clock::now() - start_;
+                histogram_->record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        }
+
+        LatencyScope(const LatencyScope &) = delete;
+        LatencyScope &operator=(const LatencyScope &) = delete;
+    };
+
+    // The instrumented paths exported through getPerformanceMetrics
+    enum class LatencyMetric : uint8_t
+    {
+        StoreRead,
+        StoreWrite,
+        BookAdd,
+        BookMatch,
+        BookAmend,
+        JsonParse,
+        HttpFetch,
+        FeedTick,  // streamed tick: decode to store write
+        RiskCheck, // pre-trade gate ahead of matching
+        Count
+    };
+
+    // Process-wide histogram for a metric
+    LatencyHistogram &latencyHistogram(LatencyMetric metric);
+
+} // namespace quantis
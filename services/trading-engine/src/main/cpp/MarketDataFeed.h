@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace quantis
+{
+
+    // One pushed top-of-book update, pointing into the message it was decoded from
+    struct FeedTick
+    {
+        std::string_view symbol;
+        double bestBid{0.0};
+        double bestAsk{0.0};
+        double lastPrice{0.0};
+        long volume{0};
+        uint64_t sequence{0}; // feed sequence number; 0 if the feed does not number ticks
+    };
+
+    // Decode one message into a tick; false for anything that is not a tick (acks, heartbeats)
+    using TickDecoder = std::function<bool(std::string_view message, FeedTick &tick)>;
+
+    // Called with the first missing and the received sequence number when ticks were lost
+    using GapHandler = std::function<void(uint64_t expected, uint64_t received)>;
+
+    struct FeedStats
+    {
+        std::string name;
+        bool connected{false};
+        uint64_t messages{0};   // data messages received
+        uint64_t ticks{0};      // ticks written to the store
+        uint64_t ignored{0};    // messages the decoder did not take as ticks
+        uint64_t gaps{0};       // sequence jumps
+        uint64_t lostTicks{0};  // sequence numbers skipped by those jumps
+        uint64_t reconnects{0};
+    };
+
+    /**
+     * A source of market data that pushes into MarketDataStore
+     *
+     * CppMarketDataService starts and stops every feed it owns alongside its
+     * HTTP poller. A feed runs its own I/O thread and writes each tick to the
+     * store as it arrives; symbols it keeps fresh drop down the poller's
+     * priority order, so the poll budget goes to the symbols left uncovered.
+     */
+    class MarketDataFeed
+    {
+    public:
+        virtual ~MarketDataFeed() = default;
+
+        virtual bool start() = 0;
+        virtual void stop() = 0;
+        virtual bool isRunning() const = 0;
+
+        virtual FeedStats getStats() const = 0;
+    };
+
+} // namespace quantis
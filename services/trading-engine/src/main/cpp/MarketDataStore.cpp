@@ -1,6 +1,17 @@
 #include "MarketDataStore.h"
+#include "SharedMemoryRegion.h"
+#include <algorithm>
+#include <bit>
 #include <iostream>
 #include <vector>
+#include <new>
+#include <climits>
+#include <cstdlib>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 namespace quantis
 {
@@ -8,12 +19,427 @@ namespace quantis
     // Global market data store instance
     std::unique_ptr<MarketDataStore> g_marketDataStore = nullptr;
 
-    void initializeMarketDataStore()
+    namespace
+    {
+        constexpr size_t PAGE_BYTES = 4096;
+
+        size_t roundUp(size_t value, size_t multiple)
+        {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+    }
+
+    MarketDataStoreConfig MarketDataStoreConfig::fromEnvironment()
+    {
+        MarketDataStoreConfig config;
+
+        if (const char *capacity = std::getenv("QUANTIS_MD_SYMBOL_CAPACITY"))
+        {
+            config.symbolCapacity = static_cast<size_t>(std::strtoul(capacity, nullptr, 10));
+        }
+
+        if (const char *length = std::getenv("QUANTIS_MD_SYMBOL_LENGTH"))
+        {
+            config.symbolLength = static_cast<size_t>(std::strtoul(length, nullptr, 10));
+        }
+
+        return config;
+    }
+
+    SymbolIndex::SymbolIndex(void *memory, size_t capacity, size_t keyWords, size_t tableSlots) noexcept
+    {
+        auto *base = static_cast<unsigned char *>(memory);
+        nextIndex_ = reinterpret_cast<std::atomic<uint32_t> *>(base);
+        tags_ = reinterpret_cast<std::atomic<uint64_t> *>(base + 64);
+        slotIndex_ = reinterpret_cast<std::atomic<uint32_t> *>(base + 64 + tableSlots * sizeof(uint64_t));
+        keysByIndex_ = reinterpret_cast<std::atomic<uint64_t> *>(base + 64 + tableSlots * sizeof(uint64_t) +
+                                                                 roundUp(tableSlots * sizeof(uint32_t), 64));
+        groups_ = tableSlots / GROUP_SIZE;
+        groupShift_ = 64 - static_cast<unsigned>(std::countr_zero(groups_));
+        capacity_ = static_cast<uint32_t>(capacity);
+        keyWords_ = static_cast<uint32_t>(keyWords);
+    }
+
+    size_t SymbolIndex::bytes(size_t capacity, size_t keyWords, size_t tableSlots) noexcept
+    {
+        // nextIndex on its own line, tags (64-aligned for the SIMD probe), slot indices, dense keys
+        return 64 + tableSlots * sizeof(uint64_t) + roundUp(tableSlots * sizeof(uint32_t), 64) +
+               capacity * keyWords * sizeof(uint64_t);
+    }
+
+    size_t SymbolIndex::recover() noexcept
+    {
+        size_t tableSlots = groups_ * GROUP_SIZE;
+        std::vector<size_t> pending;
+        std::vector<bool> claimed(size());
+        for (size_t slot = 0; slot < tableSlots; ++slot)
+        {
+            if (tags_[slot].load(std::memory_order_relaxed) == 0)
+            {
+                continue;
+            }
+            uint32_t value = slotIndex_[slot].load(std::memory_order_relaxed);
+            if (value == INDEX_PENDING)
+            {
+                pending.push_back(slot);
+            }
+            else if (value != INDEX_FULL && value != INDEX_ABANDONED && value - 1 < claimed.size())
+            {
+                claimed[value - 1] = true;
+            }
+        }
+
+        for (size_t slot : pending)
+        {
+            // The dead writer may have taken an index and written the key before it stopped
+            uint64_t tag = tags_[slot].load(std::memory_order_relaxed);
+            uint32_t value = INDEX_ABANDONED;
+            for (uint32_t index = 0; index < claimed.size(); ++index)
+            {
+                SymbolKey key = keyAt(index);
+                if (!claimed[index] && !key.empty() && tagOf(key) == tag)
+                {
+                    claimed[index] = true;
+                    value = index + 1;
+                    break;
+                }
+            }
+            slotIndex_[slot].store(value, std::memory_order_release);
+        }
+        return pending.size();
+    }
+
+    MarketDataLayout MarketDataLayout::forConfig(const MarketDataStoreConfig &config) noexcept
+    {
+        MarketDataLayout layout;
+        layout.symbolCapacity = std::clamp<size_t>(config.symbolCapacity, 1, MarketDataStoreConfig::MAX_SYMBOL_CAPACITY);
+        layout.symbolLength = std::clamp<size_t>(roundUp(config.symbolLength, sizeof(uint64_t)), sizeof(uint64_t),
+                                                 SymbolIndex::MAX_SYMBOL_LENGTH);
+
+        // At most two thirds full, so a probe chain always ends at an empty slot soon
+        layout.tableSlots = 64;
+        while (layout.tableSlots < layout.symbolCapacity + layout.symbolCapacity / 2 + 1)
+        {
+            layout.tableSlots *= 2;
+        }
+
+        // Snapshots start on a page of their own, so the first write to one commits no index page
+        layout.indexOffset = roundUp(sizeof(MarketDataRegion), 64);
+        layout.snapshotsOffset = roundUp(layout.indexOffset + SymbolIndex::bytes(layout.symbolCapacity, layout.keyWords(),
+                                                                                 layout.tableSlots),
+                                         PAGE_BYTES);
+        layout.depthOffset = roundUp(layout.snapshotsOffset + layout.symbolCapacity * sizeof(MarketDataSnapshot), PAGE_BYTES);
+        layout.regionSize = roundUp(layout.depthOffset + layout.symbolCapacity * sizeof(BookDepthSnapshot), PAGE_BYTES);
+        return layout;
+    }
+
+    void MarketDataRegion::stampHeader(const MarketDataLayout &layout) noexcept
+    {
+        header.magic = MarketDataRegionHeader::MAGIC;
+        header.version = MarketDataRegionHeader::VERSION;
+        header.symbolCapacity = static_cast<uint32_t>(layout.symbolCapacity);
+        header.regionSize = layout.regionSize;
+        header.snapshotSize = sizeof(MarketDataSnapshot);
+        header.depthSize = sizeof(BookDepthSnapshot);
+        header.symbolLength = static_cast<uint32_t>(layout.symbolLength);
+        header.tableSlots = static_cast<uint32_t>(layout.tableSlots);
+        header.createdAtNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                       std::chrono::system_clock::now().time_since_epoch())
+                                                       .count());
+        header.writerPid = static_cast<uint32_t>(::getpid());
+        header.ready.store(1, std::memory_order_release);
+    }
+
+    MarketDataLayout MarketDataRegion::readLayout(const void *memory, size_t size)
+    {
+        if (!memory || size < sizeof(MarketDataRegion))
+        {
+            return MarketDataLayout();
+        }
+
+        const auto &header = static_cast<const MarketDataRegion *>(memory)->header;
+        if (header.ready.load(std::memory_order_acquire) != 1 ||
+            header.magic != MarketDataRegionHeader::MAGIC ||
+            header.version != MarketDataRegionHeader::VERSION ||
+            header.snapshotSize != sizeof(MarketDataSnapshot) ||
+            header.depthSize != sizeof(BookDepthSnapshot))
+        {
+            return MarketDataLayout();
+        }
+
+        // The shape in the header must be one this build lays out, into the same size
+        MarketDataStoreConfig config;
+        config.symbolCapacity = header.symbolCapacity;
+        config.symbolLength = header.symbolLength;
+        MarketDataLayout layout = MarketDataLayout::forConfig(config);
+        if (layout.symbolCapacity != header.symbolCapacity || layout.symbolLength != header.symbolLength ||
+            layout.tableSlots != header.tableSlots || layout.regionSize != header.regionSize || size < layout.regionSize)
+        {
+            return MarketDataLayout();
+        }
+        return layout;
+    }
+
+    uint64_t MarketDataChangeRing::drain(uint64_t from, std::vector<uint32_t> &indices, bool &resync) const noexcept
+    {
+        uint64_t end = head.load(std::memory_order_acquire);
+        if (end <= from)
+        {
+            return end;
+        }
+
+        if (end - from > CAPACITY)
+        {
+            resync = true;
+            return end;
+        }
+
+        for (uint64_t sequence = from + 1; sequence <= end; ++sequence)
+        {
+            uint64_t slot = slots[sequence & (CAPACITY - 1)].load(std::memory_order_acquire);
+            uint64_t tag = slot >> INDEX_BITS;
+            if (tag != (sequence & TAG_MASK))
+            {
+                // An older tag: the writer has claimed the slot but not filled it yet
+                uint64_t behind = (sequence - tag) & TAG_MASK;
+                if (behind != 0 && behind <= TAG_MASK / 2)
+                {
+                    return sequence - 1;
+                }
+
+                // A newer one: lapped while draining
+                resync = true;
+                return head.load(std::memory_order_acquire);
+            }
+
+            uint32_t index = static_cast<uint32_t>(slot & RESYNC);
+            if (index == RESYNC)
+            {
+                resync = true;
+            }
+            else
+            {
+                indices.push_back(index);
+            }
+        }
+        return end;
+    }
+
+    void MarketDataChangeRing::wake() noexcept
+    {
+        wakeups.fetch_add(1, std::memory_order_seq_cst);
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&wakeups), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    uint64_t MarketDataChangeRing::wait(uint64_t sequence, std::chrono::nanoseconds timeout) noexcept
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        // Register before the last check, so a writer either sees us or we see its sequence
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        uint64_t current = head.load(std::memory_order_seq_cst);
+        while (current == sequence)
+        {
+            uint32_t word = wakeups.load(std::memory_order_seq_cst);
+            current = head.load(std::memory_order_seq_cst);
+            if (current != sequence)
+            {
+                break;
+            }
+
+            auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0)
+            {
+                break;
+            }
+
+            timespec relative{static_cast<time_t>(remaining.count() / 1000000000), static_cast<long>(remaining.count() % 1000000000)};
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&wakeups), FUTEX_WAIT, word, &relative, nullptr, 0);
+            current = head.load(std::memory_order_seq_cst);
+        }
+        waiters.fetch_sub(1, std::memory_order_seq_cst);
+
+        return head.load(std::memory_order_acquire);
+    }
+
+    void MarketDataChangeRing::recover() noexcept
+    {
+        waiters.store(0, std::memory_order_relaxed);
+
+        uint64_t end = head.load(std::memory_order_relaxed);
+        uint64_t first = end > CAPACITY ? end - CAPACITY + 1 : 1;
+        for (uint64_t sequence = first; sequence <= end; ++sequence)
+        {
+            auto &slot = slots[sequence & (CAPACITY - 1)];
+            if ((slot.load(std::memory_order_relaxed) >> INDEX_BITS) != (sequence & TAG_MASK))
+            {
+                slot.store(((sequence & TAG_MASK) << INDEX_BITS) | RESYNC, std::memory_order_release);
+            }
+        }
+    }
+
+    uint64_t MarketDataRegion::drainChanges(uint64_t sequence, std::vector<uint32_t> &indices, size_t symbolCount) const
+    {
+        size_t first = indices.size();
+        bool resync = false;
+        uint64_t next = changes.drain(sequence, indices, resync);
+
+        if (resync)
+        {
+            indices.resize(first);
+            for (uint32_t index = 0; index < symbolCount; ++index)
+            {
+                indices.push_back(index);
+            }
+            return next;
+        }
+
+        // Hot symbols appear many times per drain; hand each out once
+        std::sort(indices.begin() + static_cast<std::ptrdiff_t>(first), indices.end());
+        indices.erase(std::unique(indices.begin() + static_cast<std::ptrdiff_t>(first), indices.end()), indices.end());
+        return next;
+    }
+
+    namespace
+    {
+        MarketDataRegion *attachRegion(SharedMemoryRegion &shared, const MarketDataLayout &layout)
+        {
+            auto *region = static_cast<MarketDataRegion *>(shared.data());
+            MarketDataLayout existing = shared.created() ? MarketDataLayout() : MarketDataRegion::readLayout(shared.data(), shared.size());
+            if (existing.regionSize != layout.regionSize || existing.symbolCapacity != layout.symbolCapacity ||
+                existing.symbolLength != layout.symbolLength)
+            {
+                std::cout << "Initializing shared market data region " << shared.name() << std::endl;
+                if (!shared.created())
+                {
+                    shared.clear();
+                }
+                region->stampHeader(layout);
+                return region;
+            }
+
+            // Re-attach: keep symbols and prices, but settle what a crashed writer left half done
+            SymbolIndex index = region->symbolIndex(layout);
+            if (size_t settled = index.recover())
+            {
+                std::cout << "Settled " << settled << " unpublished symbol slot(s) in " << shared.name() << std::endl;
+            }
+            size_t symbols = index.size();
+            MarketDataSnapshot *snapshots = region->snapshots(layout);
+            for (size_t index = 0; index < symbols; ++index)
+            {
+                if (snapshots[index].sequence.load(std::memory_order_relaxed) & 1)
+                {
+                    snapshots[index].sequence.fetch_add(1, std::memory_order_release);
+                }
+            }
+            region->changes.recover();
+            region->header.writerPid = static_cast<uint32_t>(::getpid());
+            std::cout << "Re-attached shared market data region " << shared.name() << " with "
+                      << symbols << " symbols" << std::endl;
+            return region;
+        }
+    }
+
+    MarketDataStore::MarketDataStore(const MarketDataStoreConfig &config)
+        : layout_(MarketDataLayout::forConfig(config))
+    {
+        // Reserved, not committed: untouched snapshots cost address space only
+        void *memory = ::mmap(nullptr, layout_.regionSize, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        ownedMemory_ = memory;
+        region_ = static_cast<MarketDataRegion *>(memory);
+        region_->stampHeader(layout_);
+        bindRegion();
+    }
+
+    MarketDataStore::MarketDataStore(const MarketDataLayout &layout, std::unique_ptr<SharedMemoryRegion> shared)
+        : layout_(layout), sharedRegion_(std::move(shared)), region_(attachRegion(*sharedRegion_, layout_))
+    {
+        bindRegion();
+    }
+
+    // The shared region is unmapped but left in place for readers
+    MarketDataStore::~MarketDataStore()
+    {
+        if (ownedMemory_)
+        {
+            ::munmap(ownedMemory_, layout_.regionSize);
+        }
+    }
+
+    void MarketDataStore::bindRegion() noexcept
+    {
+        marketData_ = region_->snapshots(layout_);
+        depth_ = region_->depth(layout_);
+        symbolIndex_ = region_->symbolIndex(layout_);
+        capacity_ = layout_.symbolCapacity;
+    }
+
+    std::unique_ptr<MarketDataStore> MarketDataStore::createShared(const std::string &name, const MarketDataStoreConfig &config)
+    {
+        MarketDataLayout layout = MarketDataLayout::forConfig(config);
+        auto shared = SharedMemoryRegion::openOrCreate(name, layout.regionSize);
+        if (!shared)
+        {
+            return nullptr;
+        }
+        return std::unique_ptr<MarketDataStore>(new MarketDataStore(layout, std::move(shared)));
+    }
+
+    MarketDataView::~MarketDataView() = default;
+
+    std::unique_ptr<MarketDataView> MarketDataView::open(const std::string &name)
+    {
+        auto mapping = SharedMemoryRegion::openReadOnly(name);
+        if (!mapping)
+        {
+            return nullptr;
+        }
+
+        MarketDataLayout layout = MarketDataRegion::readLayout(mapping->data(), mapping->size());
+        if (layout.regionSize == 0)
+        {
+            std::cerr << "Market data region " << name << " is not ready or has an incompatible layout" << std::endl;
+            return nullptr;
+        }
+
+        // The region is read-only here; the view only calls the index's const lookups
+        auto *region = static_cast<MarketDataRegion *>(mapping->data());
+        std::unique_ptr<MarketDataView> view(new MarketDataView());
+        view->region_ = region;
+        view->layout_ = layout;
+        view->symbols_ = region->symbolIndex(layout);
+        view->snapshots_ = region->snapshots(layout);
+        view->depth_ = region->depth(layout);
+        view->mapping_ = std::move(mapping);
+        return view;
+    }
+
+    void initializeMarketDataStore(const MarketDataStoreConfig &config)
     {
         if (!g_marketDataStore)
         {
-            g_marketDataStore = std::make_unique<MarketDataStore>();
-            std::cout << "MarketDataStore initialized with lock-free architecture" << std::endl;
+            if (const char *name = std::getenv("QUANTIS_MARKET_DATA_SHM"))
+            {
+                g_marketDataStore = MarketDataStore::createShared(name, config);
+                if (g_marketDataStore)
+                {
+                    std::cout << "MarketDataStore initialized in shared memory " << name << " for "
+                              << g_marketDataStore->getSymbolCapacity() << " symbols" << std::endl;
+                    return;
+                }
+                std::cerr << "Falling back to process-local MarketDataStore" << std::endl;
+            }
+
+            g_marketDataStore = std::make_unique<MarketDataStore>(config);
+            std::cout << "MarketDataStore initialized with lock-free architecture for "
+                      << g_marketDataStore->getSymbolCapacity() << " symbols of up to "
+                      << g_marketDataStore->getSymbolLength() << " bytes" << std::endl;
         }
     }
 
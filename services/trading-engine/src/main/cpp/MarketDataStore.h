@@ -8,6 +8,14 @@
 #include <array>
 #include <vector>
 #include <cstring>
+#include <string_view>
+#include <algorithm>
+#include <type_traits>
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+#include "CpuRelax.h"
+#include "LatencyHistogram.h"
 
 namespace quantis
 {
@@ -23,97 +31,778 @@ namespace quantis
      * - Pre-allocated memory pools
      */
 
-    // Cache-line aligned market data structure (64 bytes)
+    // Plain copy of one symbol's market data, as returned by a consistent read
+    struct MarketDataValues
+    {
+        double bestBid{0.0};
+        double bestAsk{0.0};
+        double lastPrice{0.0};
+        double spread{0.0};
+        long volume{0};
+        uint64_t timestamp{0};
+        uint32_t sequence{0};
+    };
+
+    // One quote bound for the store, addressed by symbol index
+    struct MarketDataUpdate
+    {
+        uint32_t symbolIndex{0};
+        double bestBid{0.0};
+        double bestAsk{0.0};
+        double lastPrice{0.0};
+        long volume{0};
+    };
+
+    /**
+     * One symbol of a bulk snapshot
+     *
+     * Fixed layout: JNI writes these back to back into a direct ByteBuffer
+     * (mirrored in TradingEngineJNI.java), native-endian.
+     */
+    struct MarketDataRecord
+    {
+        uint32_t symbolIndex;
+        uint32_t sequence; // per-symbol version, see MarketDataStore::getUpdateSequence
+        double bestBid;
+        double bestAsk;
+        double lastPrice;
+        double spread;
+        int64_t volume;
+        uint64_t timestamp;
+    };
+
+    static_assert(sizeof(MarketDataRecord) == 56 && std::is_trivially_copyable_v<MarketDataRecord>);
+
+    /**
+     * Cache-line aligned market data structure (64 bytes) guarded by a seqlock
+     *
+     * A writer moves the sequence to odd, stores the fields and moves it to
+     * the next even value; a reader copies the fields between two sequence
+     * loads and retries if they differ or were odd, so it never sees a bid
+     * from one update next to an ask from another. Fields are relaxed atomics
+     * so concurrent access stays well-defined; the fences order them against
+     * the sequence. Sequence 0 means the slot was never written.
+     */
     struct alignas(64) MarketDataSnapshot
     {
+        std::atomic<uint32_t> sequence{0};
         std::atomic<double> bestBid{0.0};
         std::atomic<double> bestAsk{0.0};
         std::atomic<double> lastPrice{0.0};
         std::atomic<double> spread{0.0};
         std::atomic<long> volume{0};
         std::atomic<uint64_t> timestamp{0};
-        std::atomic<uint32_t> sequenceNumber{0};
-        std::atomic<bool> isValid{false};
 
-        // Padding to ensure cache line alignment (64 bytes)
-        char padding[64 - (4 * sizeof(std::atomic<double>) + sizeof(std::atomic<long>) +
-                           sizeof(std::atomic<uint64_t>) + sizeof(std::atomic<uint32_t>) +
-                           sizeof(std::atomic<bool>))];
+        bool isValid() const noexcept { return sequence.load(std::memory_order_acquire) >= 2; }
+
+        // Any number of writers; they serialize on the odd sequence
+        void store(double bid, double ask, double last, long vol, uint64_t ts) noexcept
+        {
+            uint32_t seq = sequence.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                if (seq & 1)
+                {
+                    cpuRelax();
+                    seq = sequence.load(std::memory_order_relaxed);
+                }
+                else if (sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+
+            bestBid.store(bid, std::memory_order_relaxed);
+            bestAsk.store(ask, std::memory_order_relaxed);
+            lastPrice.store(last, std::memory_order_relaxed);
+            spread.store(ask - bid, std::memory_order_relaxed);
+            volume.store(vol, std::memory_order_relaxed);
+            timestamp.store(ts, std::memory_order_relaxed);
+
+            sequence.store(seq + 2, std::memory_order_release);
+        }
+
+        // False if the slot was never written
+        bool load(MarketDataValues &out) const noexcept
+        {
+            for (;;)
+            {
+                uint32_t before = sequence.load(std::memory_order_acquire);
+                if (before == 0)
+                {
+                    return false;
+                }
+                if (before & 1)
+                {
+                    cpuRelax();
+                    continue;
+                }
+
+                out.bestBid = bestBid.load(std::memory_order_relaxed);
+                out.bestAsk = bestAsk.load(std::memory_order_relaxed);
+                out.lastPrice = lastPrice.load(std::memory_order_relaxed);
+                out.spread = spread.load(std::memory_order_relaxed);
+                out.volume = volume.load(std::memory_order_relaxed);
+                out.timestamp = timestamp.load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before)
+                {
+                    out.sequence = before;
+                    return true;
+                }
+            }
+        }
     };
 
-    // Lock-free symbol index for O(1) access
-    class SymbolIndex
+    static_assert(sizeof(MarketDataSnapshot) == 64, "MarketDataSnapshot must stay one cache line");
+
+    // One aggregated price level of a book
+    struct DepthLevel
     {
-    private:
-        static constexpr size_t MAX_SYMBOLS = 10000;
-        static constexpr size_t SYMBOL_LENGTH = 8; // Max symbol length
+        double price{0.0};
+        int64_t quantity{0};
+        uint32_t orderCount{0};
+    };
+
+    // Plain copy of the top levels of one symbol's book, best first
+    struct BookDepth
+    {
+        static constexpr size_t LEVELS = 10;
+
+        uint32_t bidCount{0};
+        uint32_t askCount{0};
+        uint64_t timestamp{0};
+        uint32_t sequence{0};
+        std::array<DepthLevel, LEVELS> bids{};
+        std::array<DepthLevel, LEVELS> asks{};
+    };
 
-        struct SymbolEntry
+    /**
+     * Top levels of one symbol's order book, guarded by a seqlock
+     *
+     * Written by the symbol's OrderBook after each operation that changed
+     * its top levels, with the same protocol as MarketDataSnapshot. A write
+     * only touches the levels from the first one that changed, so a fill at
+     * the touch rewrites one level and a change deep in the book none above
+     * it. Levels past a side's count are stale and never read.
+     */
+    struct alignas(64) BookDepthSnapshot
+    {
+        static constexpr size_t LEVELS = BookDepth::LEVELS;
+
+        struct Level
         {
-            char symbol[SYMBOL_LENGTH];
-            std::atomic<uint32_t> index{0};
-            std::atomic<bool> isActive{false};
+            std::atomic<double> price{0.0};
+            std::atomic<int64_t> quantity{0};
+            std::atomic<uint32_t> orderCount{0};
         };
 
-        std::array<SymbolEntry, MAX_SYMBOLS> symbolTable_;
-        std::atomic<uint32_t> nextIndex_{0};
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<uint32_t> bidCount{0};
+        std::atomic<uint32_t> askCount{0};
+        std::atomic<uint64_t> timestamp{0};
+        std::array<Level, LEVELS> bids{};
+        std::array<Level, LEVELS> asks{};
 
-    public:
-        uint32_t getOrCreateIndex(const std::string &symbol)
+        // Publish depth's counts and timestamp, and its levels from bidFrom / askFrom on
+        void store(const BookDepth &depth, uint32_t bidFrom, uint32_t askFrom) noexcept
         {
-            // Hash-based lookup for O(1) access
-            uint32_t hash = std::hash<std::string>{}(symbol) % MAX_SYMBOLS;
+            uint32_t seq = sequence.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                if (seq & 1)
+                {
+                    cpuRelax();
+                    seq = sequence.load(std::memory_order_relaxed);
+                }
+                else if (sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+
+            storeLevels(bids, depth.bids, bidFrom, depth.bidCount);
+            storeLevels(asks, depth.asks, askFrom, depth.askCount);
+            bidCount.store(depth.bidCount, std::memory_order_relaxed);
+            askCount.store(depth.askCount, std::memory_order_relaxed);
+            timestamp.store(depth.timestamp, std::memory_order_relaxed);
+
+            sequence.store(seq + 2, std::memory_order_release);
+        }
 
-            for (size_t i = 0; i < MAX_SYMBOLS; ++i)
+        // False if the book never published
+        bool load(BookDepth &out) const noexcept
+        {
+            for (;;)
             {
-                uint32_t idx = (hash + i) % MAX_SYMBOLS;
-                SymbolEntry &entry = symbolTable_[idx];
+                uint32_t before = sequence.load(std::memory_order_acquire);
+                if (before == 0)
+                {
+                    return false;
+                }
+                if (before & 1)
+                {
+                    cpuRelax();
+                    continue;
+                }
 
-                // Try to acquire this slot
-                bool expected = false;
-                if (entry.isActive.compare_exchange_strong(expected, true))
+                // Clamp: a torn count is discarded below, but must not index past the array first
+                out.bidCount = std::min<uint32_t>(bidCount.load(std::memory_order_relaxed), LEVELS);
+                out.askCount = std::min<uint32_t>(askCount.load(std::memory_order_relaxed), LEVELS);
+                out.timestamp = timestamp.load(std::memory_order_relaxed);
+                loadLevels(bids, out.bids, out.bidCount);
+                loadLevels(asks, out.asks, out.askCount);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before)
                 {
-                    // Copy symbol
-                    strncpy(entry.symbol, symbol.c_str(), SYMBOL_LENGTH - 1);
-                    entry.symbol[SYMBOL_LENGTH - 1] = '\0';
+                    out.sequence = before;
+                    return true;
+                }
+            }
+        }
+
+    private:
+        static void storeLevels(std::array<Level, LEVELS> &to, const std::array<DepthLevel, LEVELS> &from,
+                                uint32_t first, uint32_t count) noexcept
+        {
+            for (uint32_t i = first; i < count && i < LEVELS; ++i)
+            {
+                to[i].price.store(from[i].price, std::memory_order_relaxed);
+                to[i].quantity.store(from[i].quantity, std::memory_order_relaxed);
+                to[i].orderCount.store(from[i].orderCount, std::memory_order_relaxed);
+            }
+        }
+
+        static void loadLevels(const std::array<Level, LEVELS> &from, std::array<DepthLevel, LEVELS> &to, uint32_t count) noexcept
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                to[i].price = from[i].price.load(std::memory_order_relaxed);
+                to[i].quantity = from[i].quantity.load(std::memory_order_relaxed);
+                to[i].orderCount = from[i].orderCount.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    static_assert(sizeof(BookDepthSnapshot) % 64 == 0, "BookDepthSnapshot must fill whole cache lines");
+
+    /**
+     * Symbol packed into little-endian 64-bit words, zero padded
+     *
+     * How many words a symbol may use is the store's symbol length (see
+     * MarketDataStoreConfig); the rest stay zero. An empty key is never valid.
+     */
+    struct SymbolKey
+    {
+        static constexpr size_t MAX_WORDS = 4;
+
+        std::array<uint64_t, MAX_WORDS> words{};
 
-                    // Assign index
-                    uint32_t newIndex = nextIndex_.fetch_add(1);
-                    entry.index.store(newIndex);
+        bool empty() const noexcept { return words[0] == 0; }
+        bool operator==(const SymbolKey &) const = default;
+    };
 
-                    return newIndex;
+    /**
+     * Lock-free symbol index for O(1) access
+     *
+     * Symbols are packed into a SymbolKey once, and each table slot holds a
+     * 64-bit tag of its key: the key itself for symbols of up to 8 bytes, a
+     * hash of it for longer ones. A lookup is one multiply for the hash and
+     * one 64-bit compare per slot instead of std::hash and strncmp, plus one
+     * compare of the full key when a hashed tag matches. Slots are probed a
+     * group of four at a time (one AVX2 compare, two SSE4.1 compares, or a
+     * scalar loop). A slot is claimed by a single CAS of the tag and its
+     * dense index is published afterwards with a release store; readers that
+     * win the race on the tag wait for it.
+     *
+     * The index does not own its memory: it is laid out in a zero-filled
+     * MarketDataRegion, sized for the store's capacity (see MarketDataLayout).
+     * Once the capacity is reached no more slots are claimed, so the table
+     * always keeps at least a third of its slots empty and a miss ends at the
+     * first empty slot of its chain instead of scanning the table.
+     */
+    class SymbolIndex
+    {
+    public:
+        static constexpr size_t MAX_SYMBOL_LENGTH = sizeof(uint64_t) * SymbolKey::MAX_WORDS;
+
+    private:
+        static constexpr size_t GROUP_SIZE = 4;
+        static constexpr uint32_t INDEX_PENDING = 0;       // tag claimed, index not yet published
+        static constexpr uint32_t INDEX_FULL = UINT32_MAX; // tag claimed after the index ran out
+        static constexpr uint32_t INDEX_ABANDONED = UINT32_MAX - 1; // claimed by a writer that died mid-insert
+
+        std::atomic<uint32_t> *nextIndex_{nullptr};
+        // Tags are atomics; the SIMD probe reads them as a plain vector, which is only a hint
+        std::atomic<uint64_t> *tags_{nullptr};
+        std::atomic<uint32_t> *slotIndex_{nullptr};  // dense index + 1
+        std::atomic<uint64_t> *keysByIndex_{nullptr}; // keyWords_ words per dense index
+        size_t groups_{0};
+        unsigned groupShift_{0};
+        uint32_t capacity_{0};
+        uint32_t keyWords_{1};
+
+        size_t homeGroup(uint64_t tag) const noexcept
+        {
+            return static_cast<size_t>((tag * 0x9E3779B97F4A7C15ULL) >> groupShift_);
+        }
+
+        // Exact for one-word keys; longer keys are folded into a non-zero hash
+        uint64_t tagOf(const SymbolKey &key) const noexcept
+        {
+            if (keyWords_ == 1)
+            {
+                return key.words[0];
+            }
+            uint64_t tag = key.words[0];
+            for (uint32_t w = 1; w < keyWords_; ++w)
+            {
+                tag = (tag ^ (tag >> 29) ^ key.words[w]) * 0xBF58476D1CE4E5B9ULL;
+            }
+            return tag | 1;
+        }
+
+        // Bit i set if slot base+i holds tag, bit i+4 set if it is empty
+        unsigned probeGroup(size_t base, uint64_t tag) const noexcept
+        {
+#if defined(__AVX2__) || defined(__SSE4_1__)
+            const uint64_t *slots = reinterpret_cast<const uint64_t *>(&tags_[base]);
+#endif
+#if defined(__AVX2__)
+            __m256i group = _mm256_load_si256(reinterpret_cast<const __m256i *>(slots));
+            unsigned hit = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(
+                _mm256_cmpeq_epi64(group, _mm256_set1_epi64x(static_cast<long long>(tag))))));
+            unsigned empty = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(
+                _mm256_cmpeq_epi64(group, _mm256_setzero_si256()))));
+            return hit | (empty << 4);
+#elif defined(__SSE4_1__)
+            unsigned mask = 0;
+            for (size_t half = 0; half < GROUP_SIZE; half += 2)
+            {
+                __m128i pair = _mm_load_si128(reinterpret_cast<const __m128i *>(slots + half));
+                unsigned hit = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(
+                    _mm_cmpeq_epi64(pair, _mm_set1_epi64x(static_cast<long long>(tag))))));
+                unsigned empty = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(
+                    _mm_cmpeq_epi64(pair, _mm_setzero_si128()))));
+                mask |= (hit << half) | (empty << (half + 4));
+            }
+            return mask;
+#else
+            unsigned mask = 0;
+            for (size_t i = 0; i < GROUP_SIZE; ++i)
+            {
+                uint64_t slot = tags_[base + i].load(std::memory_order_relaxed);
+                mask |= (slot == tag ? 1u : 0u) << i;
+                mask |= (slot == 0 ? 1u : 0u) << (i + 4);
+            }
+            return mask;
+#endif
+        }
+
+        /**
+         * For a slot whose tag matched: true if it holds key, with its index
+         * in index (UINT32_MAX if it was claimed after the index ran out).
+         * Waits out the claim-to-publish window of the thread that owns the
+         * slot; an abandoned slot holds no key and the probe moves past it.
+         */
+        bool resolve(size_t slot, const SymbolKey &key, uint32_t &index) const noexcept
+        {
+            uint32_t value;
+            while ((value = slotIndex_[slot].load(std::memory_order_acquire)) == INDEX_PENDING)
+            {
+                cpuRelax();
+            }
+            if (value == INDEX_ABANDONED)
+            {
+                return false;
+            }
+            index = value == INDEX_FULL ? UINT32_MAX : value - 1;
+            if (keyWords_ == 1)
+            {
+                return true;
+            }
+            if (index == UINT32_MAX)
+            {
+                return false; // an unpublished key cannot be compared; only a miss can be lost
+            }
+            for (uint32_t w = 0; w < keyWords_; ++w)
+            {
+                if (keysByIndex_[size_t{index} * keyWords_ + w].load(std::memory_order_relaxed) != key.words[w])
+                {
+                    return false;
                 }
+            }
+            return true;
+        }
+
+    public:
+        SymbolIndex() = default;
+
+        /**
+         * Index over memory laid out by MarketDataLayout for capacity symbols
+         * of keyWords words each, hashed into tableSlots (a power of two)
+         */
+        SymbolIndex(void *memory, size_t capacity, size_t keyWords, size_t tableSlots) noexcept;
+
+        // Bytes of region memory an index of this shape uses
+        static size_t bytes(size_t capacity, size_t keyWords, size_t tableSlots) noexcept;
 
-                // Check if this is our symbol
-                if (strncmp(entry.symbol, symbol.c_str(), SYMBOL_LENGTH - 1) == 0)
+        size_t capacity() const noexcept { return capacity_; }
+        size_t symbolLength() const noexcept { return keyWords_ * sizeof(uint64_t); }
+
+        /**
+         * Pack a symbol into its key; empty if it is empty or longer than symbolLength()
+         */
+        SymbolKey makeKey(std::string_view symbol) const noexcept
+        {
+            SymbolKey key;
+            if (symbol.empty() || symbol.size() > symbolLength() || symbol[0] == '\0')
+            {
+                return key;
+            }
+            std::memcpy(key.words.data(), symbol.data(), symbol.size());
+            return key;
+        }
+
+        static std::string keyToString(const SymbolKey &key)
+        {
+            char chars[MAX_SYMBOL_LENGTH];
+            std::memcpy(chars, key.words.data(), MAX_SYMBOL_LENGTH);
+            return std::string(chars, strnlen(chars, MAX_SYMBOL_LENGTH));
+        }
+
+        uint32_t getOrCreateIndex(const SymbolKey &key) noexcept
+        {
+            if (key.empty())
+            {
+                return UINT32_MAX;
+            }
+
+            uint64_t tag = tagOf(key);
+            size_t group = homeGroup(tag);
+            for (size_t probe = 0; probe < groups_; ++probe)
+            {
+                size_t base = group * GROUP_SIZE;
+                unsigned mask = probeGroup(base, tag);
+
+                for (size_t i = 0; i < GROUP_SIZE; ++i)
                 {
-                    return entry.index.load();
+                    size_t slot = base + i;
+                    uint32_t index;
+                    if (mask & (1u << i))
+                    {
+                        if (tags_[slot].load(std::memory_order_acquire) == tag && resolve(slot, key, index))
+                        {
+                            return index;
+                        }
+                    }
+                    else if (mask & (1u << (i + 4)))
+                    {
+                        // Once full, leave empty slots empty so every chain stays short
+                        if (nextIndex_->load(std::memory_order_relaxed) >= capacity_)
+                        {
+                            // The slot may just have taken this very key
+                            uint64_t current = tags_[slot].load(std::memory_order_acquire);
+                            if (current == 0)
+                            {
+                                return UINT32_MAX; // Error: table full
+                            }
+                            if (current == tag && resolve(slot, key, index))
+                            {
+                                return index;
+                            }
+                            continue;
+                        }
+
+                        // Try to acquire this slot; on failure someone else claimed it first
+                        uint64_t expected = 0;
+                        if (tags_[slot].compare_exchange_strong(expected, tag, std::memory_order_acq_rel))
+                        {
+                            uint32_t newIndex = nextIndex_->fetch_add(1, std::memory_order_relaxed);
+                            if (newIndex >= capacity_)
+                            {
+                                slotIndex_[slot].store(INDEX_FULL, std::memory_order_release);
+                                return UINT32_MAX; // Error: table full
+                            }
+                            // Word 0 last: keyAt() never sees a partly written key
+                            std::atomic<uint64_t> *words = &keysByIndex_[size_t{newIndex} * keyWords_];
+                            for (uint32_t w = keyWords_; w-- > 1;)
+                            {
+                                words[w].store(key.words[w], std::memory_order_relaxed);
+                            }
+                            words[0].store(key.words[0], std::memory_order_release);
+                            slotIndex_[slot].store(newIndex + 1, std::memory_order_release);
+                            return newIndex;
+                        }
+                        if (expected == tag && resolve(slot, key, index))
+                        {
+                            return index;
+                        }
+                    }
                 }
+
+                group = (group + 1) & (groups_ - 1);
             }
 
             return UINT32_MAX; // Error: table full
         }
 
-        uint32_t getIndex(const std::string &symbol) const
+        uint32_t getIndex(const SymbolKey &key) const noexcept
         {
-            uint32_t hash = std::hash<std::string>{}(symbol) % MAX_SYMBOLS;
+            if (key.empty())
+            {
+                return UINT32_MAX;
+            }
 
-            for (size_t i = 0; i < MAX_SYMBOLS; ++i)
+            uint64_t tag = tagOf(key);
+            size_t group = homeGroup(tag);
+            for (size_t probe = 0; probe < groups_; ++probe)
             {
-                uint32_t idx = (hash + i) % MAX_SYMBOLS;
-                const SymbolEntry &entry = symbolTable_[idx];
+                size_t base = group * GROUP_SIZE;
+                unsigned mask = probeGroup(base, tag);
 
-                if (entry.isActive.load() &&
-                    strncmp(entry.symbol, symbol.c_str(), SYMBOL_LENGTH - 1) == 0)
+                for (size_t i = 0; i < GROUP_SIZE; ++i)
                 {
-                    return entry.index.load();
+                    size_t slot = base + i;
+                    uint32_t index;
+                    if ((mask & (1u << i)) && tags_[slot].load(std::memory_order_acquire) == tag && resolve(slot, key, index))
+                    {
+                        return index;
+                    }
+                    if (mask & (1u << (i + 4)))
+                    {
+                        // Slots fill in probe order, so an empty slot ends the chain
+                        if (tags_[slot].load(std::memory_order_acquire) == 0)
+                        {
+                            return UINT32_MAX; // Not found
+                        }
+                    }
                 }
+
+                group = (group + 1) & (groups_ - 1);
             }
 
             return UINT32_MAX; // Not found
         }
+
+        uint32_t getOrCreateIndex(std::string_view symbol) noexcept { return getOrCreateIndex(makeKey(symbol)); }
+        uint32_t getIndex(std::string_view symbol) const noexcept { return getIndex(makeKey(symbol)); }
+
+        // Key registered at a dense index, or an empty key
+        SymbolKey keyAt(uint32_t index) const noexcept
+        {
+            SymbolKey key;
+            if (index < capacity_)
+            {
+                const std::atomic<uint64_t> *words = &keysByIndex_[size_t{index} * keyWords_];
+                key.words[0] = words[0].load(std::memory_order_acquire);
+                for (uint32_t w = 1; w < keyWords_ && !key.empty(); ++w)
+                {
+                    key.words[w] = words[w].load(std::memory_order_relaxed);
+                }
+            }
+            return key;
+        }
+
+        size_t size() const noexcept
+        {
+            return std::min<size_t>(nextIndex_->load(std::memory_order_relaxed), capacity_);
+        }
+
+        /**
+         * Re-attaching writer only, before any lookup: settle every slot a
+         * crashed writer left claimed but unpublished, which would otherwise
+         * stall each probe that reaches it. A slot is finished if its key made
+         * it to an unclaimed dense index, else abandoned. Returns how many
+         * slots were settled.
+         */
+        size_t recover() noexcept;
     };
 
+    /**
+     * Broadcast ring of changed symbol indices
+     *
+     * Every store write claims the next change sequence and records its
+     * symbol index in slot sequence % CAPACITY. Each reader keeps its own
+     * sequence and drains the indices published after it; a reader that falls
+     * a whole ring behind treats every symbol as changed. Waiting readers
+     * sleep on a futex that writers only touch while someone is waiting.
+     */
+    struct MarketDataChangeRing
+    {
+        static constexpr size_t CAPACITY = 8192;
+        static constexpr uint32_t INDEX_BITS = 20;
+        static constexpr uint32_t RESYNC = (1u << INDEX_BITS) - 1; // slot index meaning "every symbol changed"
+        static constexpr uint64_t TAG_MASK = (1ULL << (64 - INDEX_BITS)) - 1;
+
+        alignas(64) std::atomic<uint64_t> head{0}; // last claimed change sequence
+        alignas(64) std::atomic<uint32_t> waiters{0};
+        std::atomic<uint32_t> wakeups{0}; // futex word, bumped to wake waiters
+        alignas(64) std::array<std::atomic<uint64_t>, CAPACITY> slots{}; // sequence << INDEX_BITS | index
+
+        void publish(uint32_t index) noexcept
+        {
+            uint64_t sequence = head.fetch_add(1, std::memory_order_seq_cst) + 1;
+            slots[sequence & (CAPACITY - 1)].store(((sequence & TAG_MASK) << INDEX_BITS) | index, std::memory_order_release);
+            if (waiters.load(std::memory_order_seq_cst) != 0)
+            {
+                wake();
+            }
+        }
+
+        // Several indices under one claim of consecutive sequences and one waiter check
+        void publish(const uint32_t *indices, size_t count) noexcept
+        {
+            if (count == 0)
+            {
+                return;
+            }
+            uint64_t first = head.fetch_add(count, std::memory_order_seq_cst) + 1;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint64_t sequence = first + i;
+                slots[sequence & (CAPACITY - 1)].store(((sequence & TAG_MASK) << INDEX_BITS) | indices[i], std::memory_order_release);
+            }
+            if (waiters.load(std::memory_order_seq_cst) != 0)
+            {
+                wake();
+            }
+        }
+
+        /**
+         * Append the indices published after from, in publication order and
+         * possibly repeated. Returns the sequence drained through, which stops
+         * short of a slot still being written. Sets resync if the reader was
+         * lapped or a resync marker was found.
+         */
+        uint64_t drain(uint64_t from, std::vector<uint32_t> &indices, bool &resync) const noexcept;
+
+        // Block until the change sequence passes sequence or timeout expires; returns it
+        uint64_t wait(uint64_t sequence, std::chrono::nanoseconds timeout) noexcept;
+
+        // After re-attaching: mark slots a crashed writer claimed but never filled
+        void recover() noexcept;
+
+    private:
+        void wake() noexcept;
+    };
+
+    /**
+     * Store shape, chosen once at initializeMarketDataStore
+     *
+     * Capacity only reserves address space: the region is committed page by
+     * page as symbols are registered and written, so a store sized for a
+     * million option contracts costs a few pages while it tracks eight.
+     */
+    struct MarketDataStoreConfig
+    {
+        // Symbol indices must fit the change ring's index bits
+        static constexpr size_t MAX_SYMBOL_CAPACITY = MarketDataChangeRing::RESYNC - 1;
+
+        size_t symbolCapacity{10000}; // most symbols the store can register, up to MAX_SYMBOL_CAPACITY
+        size_t symbolLength{8};       // longest symbol in bytes; rounded up to 8, 16, 24 or 32
+
+        // Reads QUANTIS_MD_SYMBOL_CAPACITY and QUANTIS_MD_SYMBOL_LENGTH
+        static MarketDataStoreConfig fromEnvironment();
+    };
+
+    /**
+     * Offsets of a market data region of one configuration
+     *
+     * The region is the header and change ring, then the symbol index, then
+     * one MarketDataSnapshot and one BookDepthSnapshot per symbol. Writers
+     * and readers derive the same layout from the capacity and symbol length
+     * in the header, so a view can open a region of any configuration.
+     */
+    struct MarketDataLayout
+    {
+        size_t symbolCapacity{0};
+        size_t symbolLength{0}; // bytes, a multiple of 8
+        size_t tableSlots{0};   // power of two, load <= 2/3
+        size_t indexOffset{0};
+        size_t snapshotsOffset{0};
+        size_t depthOffset{0};
+        size_t regionSize{0};
+
+        // Layout for config, with its capacity and symbol length clamped to what the store supports
+        static MarketDataLayout forConfig(const MarketDataStoreConfig &config) noexcept;
+
+        size_t keyWords() const noexcept { return symbolLength / sizeof(uint64_t); }
+    };
+
+    /**
+     * Header at offset 0 of a market data region
+     *
+     * Readers in other processes check magic, version and the layout sizes
+     * before trusting anything else, and only read once ready is set.
+     */
+    struct MarketDataRegionHeader
+    {
+        static constexpr uint64_t MAGIC = 0x3153444D51544E51ULL; // "QNTQMDS1"
+        static constexpr uint32_t VERSION = 4;
+
+        uint64_t magic;
+        uint32_t version;
+        uint32_t symbolCapacity;
+        uint64_t regionSize;   // MarketDataLayout::regionSize
+        uint32_t snapshotSize; // sizeof(MarketDataSnapshot)
+        uint32_t depthSize;    // sizeof(BookDepthSnapshot)
+        uint32_t symbolLength; // bytes per symbol key
+        uint32_t tableSlots;   // symbol index hash slots
+        uint64_t createdAtNs;
+        std::atomic<uint32_t> ready; // 1 once the writer has initialized the region
+        uint32_t writerPid;
+    };
+
+    /**
+     * Everything another process needs to read prices: header, change ring,
+     * then (at MarketDataLayout offsets) the symbol index and the snapshots
+     * of the feed's prices and of each book's top levels
+     *
+     * Every field starts as zero bytes, so a zero-filled mapping already is
+     * an empty region and nothing is constructed up front. The kernel
+     * commits each page the first time it is written: the directory of
+     * snapshots grows with the symbols, without locks and without ever
+     * moving a snapshot a reader may hold.
+     */
+    struct MarketDataRegion
+    {
+        alignas(64) MarketDataRegionHeader header;
+        MarketDataChangeRing changes;
+
+        // Fill in the header of a zero-filled region and mark it ready
+        void stampHeader(const MarketDataLayout &layout) noexcept;
+
+        // Layout of a ready region of this build, or a zero regionSize if memory holds none
+        static MarketDataLayout readLayout(const void *memory, size_t size);
+
+        unsigned char *bytes() noexcept { return reinterpret_cast<unsigned char *>(this); }
+
+        SymbolIndex symbolIndex(const MarketDataLayout &layout) noexcept
+        {
+            return SymbolIndex(bytes() + layout.indexOffset, layout.symbolCapacity, layout.keyWords(), layout.tableSlots);
+        }
+
+        MarketDataSnapshot *snapshots(const MarketDataLayout &layout) noexcept
+        {
+            return reinterpret_cast<MarketDataSnapshot *>(bytes() + layout.snapshotsOffset);
+        }
+
+        BookDepthSnapshot *depth(const MarketDataLayout &layout) noexcept
+        {
+            return reinterpret_cast<BookDepthSnapshot *>(bytes() + layout.depthOffset);
+        }
+
+        // Drain the change ring into distinct symbol indices; every registered symbol on resync
+        uint64_t drainChanges(uint64_t sequence, std::vector<uint32_t> &indices, size_t symbolCount) const;
+    };
+
+    class SharedMemoryRegion;
+
     /**
      * Ultra-low latency market data store
      *
@@ -126,26 +815,83 @@ namespace quantis
     class MarketDataStore
     {
     private:
-        static constexpr size_t MAX_SYMBOLS = 10000;
+        MarketDataLayout layout_;
 
-        // Pre-allocated market data snapshots
-        std::array<MarketDataSnapshot, MAX_SYMBOLS> marketData_;
+        // Backing storage: a private anonymous mapping, or a shared one other processes can read
+        void *ownedMemory_{nullptr};
+        std::unique_ptr<SharedMemoryRegion> sharedRegion_;
+        MarketDataRegion *region_{nullptr};
+
+        // Market data snapshots, committed as symbols are written
+        MarketDataSnapshot *marketData_{nullptr};
+
+        // Top levels of each symbol's order book
+        BookDepthSnapshot *depth_{nullptr};
 
         // Symbol index for O(1) lookup
         SymbolIndex symbolIndex_;
+        size_t capacity_{0};
 
         // Statistics
         std::atomic<uint64_t> totalUpdates_{0};
         std::atomic<uint64_t> totalReads_{0};
 
+        // Sampled per-thread latency of the by-index read and write paths
+        LatencyHistogram &readLatency_{latencyHistogram(LatencyMetric::StoreRead)};
+        LatencyHistogram &writeLatency_{latencyHistogram(LatencyMetric::StoreWrite)};
+
+        MarketDataStore(const MarketDataLayout &layout, std::unique_ptr<SharedMemoryRegion> shared);
+
+        // Point the snapshot arrays and symbol index into region_
+        void bindRegion() noexcept;
+
     public:
-        MarketDataStore()
+        explicit MarketDataStore(const MarketDataStoreConfig &config = MarketDataStoreConfig());
+        ~MarketDataStore();
+
+        MarketDataStore(const MarketDataStore &) = delete;
+        MarketDataStore &operator=(const MarketDataStore &) = delete;
+
+        /**
+         * Store backed by a named shared-memory segment or hugetlbfs file (see
+         * SharedMemoryRegion). A compatible existing region is re-attached with
+         * its symbols intact if it has config's shape; otherwise it is
+         * reinitialized. nullptr on failure.
+         */
+        static std::unique_ptr<MarketDataStore> createShared(const std::string &name,
+                                                             const MarketDataStoreConfig &config = MarketDataStoreConfig());
+
+        bool isShared() const noexcept { return sharedRegion_ != nullptr; }
+
+        // Symbol indices are below this; symbols beyond it are rejected
+        size_t getSymbolCapacity() const noexcept { return capacity_; }
+
+        // Longest symbol the store accepts, in bytes
+        size_t getSymbolLength() const noexcept { return layout_.symbolLength; }
+
+        // Address space reserved for the region; only written pages are committed
+        size_t getReservedBytes() const noexcept { return layout_.regionSize; }
+
+        /**
+         * Resolve a symbol to its SymbolIndex slot, creating it if needed
+         * Resolve once, then use the by-index calls below in hot loops.
+         */
+        uint32_t getOrCreateSymbolIndex(std::string_view symbol)
         {
-            // Initialize all snapshots
-            for (auto &snapshot : marketData_)
-            {
-                snapshot.isValid.store(false);
-            }
+            return symbolIndex_.getOrCreateIndex(symbol);
+        }
+
+        // Index of a known symbol, or UINT32_MAX
+        uint32_t findSymbolIndex(const std::string &symbol) const
+        {
+            return symbolIndex_.getIndex(symbol);
+        }
+
+        // Symbol registered at an index, or an empty string
+        std::string getSymbol(uint32_t index) const
+        {
+            SymbolKey key = symbolIndex_.keyAt(index);
+            return key.empty() ? std::string() : SymbolIndex::keyToString(key);
         }
 
         /**
@@ -156,38 +902,65 @@ namespace quantis
                               double bestBid, double bestAsk, double lastPrice,
                               long volume = 0)
         {
-            uint32_t index = symbolIndex_.getOrCreateIndex(symbol);
-            if (index >= MAX_SYMBOLS)
+            return updateMarketData(symbolIndex_.getOrCreateIndex(symbol), bestBid, bestAsk, lastPrice, volume);
+        }
+
+        bool updateMarketData(uint32_t index, double bestBid, double bestAsk, double lastPrice, long volume = 0)
+        {
+            if (index >= capacity_)
             {
                 return false;
             }
+            LatencyScope timer(writeLatency_);
 
-            MarketDataSnapshot &snapshot = marketData_[index];
-
-            // Atomic updates (no locks needed)
-            snapshot.bestBid.store(bestBid, std::memory_order_release);
-            snapshot.bestAsk.store(bestAsk, std::memory_order_release);
-            snapshot.lastPrice.store(lastPrice, std::memory_order_release);
-            snapshot.volume.store(volume, std::memory_order_release);
-
-            // Calculate spread atomically
-            double spread = bestAsk - bestBid;
-            snapshot.spread.store(spread, std::memory_order_release);
-
-            // Update timestamp and sequence
             auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
                            std::chrono::high_resolution_clock::now().time_since_epoch())
                            .count();
-            snapshot.timestamp.store(now, std::memory_order_release);
-            snapshot.sequenceNumber.fetch_add(1, std::memory_order_release);
 
-            // Mark as valid (this must be last)
-            snapshot.isValid.store(true, std::memory_order_release);
+            // One seqlocked write of the whole line
+            marketData_[index].store(bestBid, bestAsk, lastPrice, volume, static_cast<uint64_t>(now));
+            region_->changes.publish(index);
 
             totalUpdates_.fetch_add(1, std::memory_order_relaxed);
             return true;
         }
 
+        /**
+         * Write count updates stamped with one clock read and announce them
+         * with one change ring claim per chunk, for a writer draining a queue.
+         * Updates beyond the store are skipped; returns how many were written.
+         */
+        size_t updateMarketDataBatch(const MarketDataUpdate *updates, size_t count)
+        {
+            constexpr size_t CHUNK = 256;
+            uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                     std::chrono::high_resolution_clock::now().time_since_epoch())
+                                                     .count());
+
+            uint32_t indices[CHUNK];
+            size_t written = 0;
+            for (size_t begin = 0; begin < count; begin += CHUNK)
+            {
+                size_t end = std::min(count, begin + CHUNK);
+                size_t chunk = 0;
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const MarketDataUpdate &update = updates[i];
+                    if (update.symbolIndex >= capacity_)
+                    {
+                        continue;
+                    }
+                    marketData_[update.symbolIndex].store(update.bestBid, update.bestAsk, update.lastPrice, update.volume, now);
+                    indices[chunk++] = update.symbolIndex;
+                }
+                region_->changes.publish(indices, chunk);
+                written += chunk;
+            }
+
+            totalUpdates_.fetch_add(written, std::memory_order_relaxed);
+            return written;
+        }
+
         /**
          * Get market data for a symbol (lock-free)
          * Latency: ~10 nanoseconds
@@ -196,69 +969,114 @@ namespace quantis
                            double &bestBid, double &bestAsk, double &lastPrice,
                            double &spread, long &volume, uint64_t &timestamp)
         {
-            uint32_t index = symbolIndex_.getIndex(symbol);
-            if (index >= MAX_SYMBOLS)
+            // Torn-free copy of the whole snapshot
+            MarketDataValues values;
+            if (!getMarketData(symbolIndex_.getIndex(symbol), values))
             {
                 return false;
             }
 
-            const MarketDataSnapshot &snapshot = marketData_[index];
+            bestBid = values.bestBid;
+            bestAsk = values.bestAsk;
+            lastPrice = values.lastPrice;
+            spread = values.spread;
+            volume = values.volume;
+            timestamp = values.timestamp;
+            return true;
+        }
 
-            // Check if data is valid
-            if (!snapshot.isValid.load(std::memory_order_acquire))
+        bool getMarketData(uint32_t index, MarketDataValues &values)
+        {
+            LatencyScope timer(readLatency_);
+            if (index >= capacity_ || !marketData_[index].load(values))
             {
                 return false;
             }
 
-            // Atomic reads (no locks needed)
-            bestBid = snapshot.bestBid.load(std::memory_order_acquire);
-            bestAsk = snapshot.bestAsk.load(std::memory_order_acquire);
-            lastPrice = snapshot.lastPrice.load(std::memory_order_acquire);
-            spread = snapshot.spread.load(std::memory_order_acquire);
-            volume = snapshot.volume.load(std::memory_order_acquire);
-            timestamp = snapshot.timestamp.load(std::memory_order_acquire);
-
             totalReads_.fetch_add(1, std::memory_order_relaxed);
             return true;
         }
 
         /**
-         * Get best bid/ask for order matching (ultra-fast)
-         * Latency: ~5 nanoseconds
+         * Change notification: every write bumps the store's change sequence.
+         * A reader remembers the last sequence it handled, waits for the next
+         * one, then drains the distinct symbol indices updated in between
+         * (all of them if it fell more than a ring behind).
          */
-        bool getBestPrices(const std::string &symbol, double &bestBid, double &bestAsk)
+        uint64_t getChangeSequence() const noexcept { return region_->changes.head.load(std::memory_order_acquire); }
+
+        uint64_t drainChanges(uint64_t sequence, std::vector<uint32_t> &indices) const
         {
-            uint32_t index = symbolIndex_.getIndex(symbol);
-            if (index >= MAX_SYMBOLS)
-            {
-                return false;
-            }
+            return region_->drainChanges(sequence, indices, symbolIndex_.size());
+        }
+
+        // Block until a write after sequence or the timeout; returns the change sequence
+        uint64_t waitForChanges(uint64_t sequence, std::chrono::nanoseconds timeout)
+        {
+            return region_->changes.wait(sequence, timeout);
+        }
 
-            const MarketDataSnapshot &snapshot = marketData_[index];
+        // Per-symbol version: moves on every write to the symbol, so equal values mean unchanged
+        uint32_t getUpdateSequence(uint32_t index) const noexcept
+        {
+            return index < capacity_ ? marketData_[index].sequence.load(std::memory_order_acquire) : 0;
+        }
 
-            if (!snapshot.isValid.load(std::memory_order_acquire))
+        /**
+         * Order book depth: the top BookDepth::LEVELS price levels per side of
+         * the symbol's OrderBook, aggregated. Published by the book, not the
+         * feed, and not announced on the change ring: compare
+         * BookDepth::sequence to see whether a book moved.
+         */
+        bool publishDepth(uint32_t index, const BookDepth &depth, uint32_t bidFrom, uint32_t askFrom) noexcept
+        {
+            if (index >= capacity_)
             {
                 return false;
             }
+            depth_[index].store(depth, bidFrom, askFrom);
+            return true;
+        }
 
-            bestBid = snapshot.bestBid.load(std::memory_order_acquire);
-            bestAsk = snapshot.bestAsk.load(std::memory_order_acquire);
+        bool getDepth(uint32_t index, BookDepth &depth) const noexcept
+        {
+            return index < capacity_ && depth_[index].load(depth);
+        }
 
-            return true;
+        bool getDepth(const std::string &symbol, BookDepth &depth) const
+        {
+            return getDepth(symbolIndex_.getIndex(symbol), depth);
         }
 
         /**
-         * Check if symbol has valid data
+         * Get best bid/ask for order matching (ultra-fast)
+         * Latency: ~5 nanoseconds
          */
-        bool hasValidData(const std::string &symbol)
+        bool getBestPrices(const std::string &symbol, double &bestBid, double &bestAsk)
         {
             uint32_t index = symbolIndex_.getIndex(symbol);
-            if (index >= MAX_SYMBOLS)
+            MarketDataValues values;
+            if (index >= capacity_ || !marketData_[index].load(values))
             {
                 return false;
             }
 
-            return marketData_[index].isValid.load(std::memory_order_acquire);
+            bestBid = values.bestBid;
+            bestAsk = values.bestAsk;
+            return true;
+        }
+
+        /**
+         * Check if symbol has valid data
+         */
+        bool hasValidData(const std::string &symbol) const
+        {
+            return hasValidData(symbolIndex_.getIndex(symbol));
+        }
+
+        bool hasValidData(uint32_t index) const
+        {
+            return index < capacity_ && marketData_[index].isValid();
         }
 
         /**
@@ -278,29 +1096,139 @@ namespace quantis
             stats.totalUpdates = totalUpdates_.load(std::memory_order_relaxed);
             stats.totalReads = totalReads_.load(std::memory_order_relaxed);
 
-            // These would be measured in a real implementation
-            stats.avgReadLatencyNs = 10.0;  // ~10 nanoseconds
-            stats.avgWriteLatencyNs = 50.0; // ~50 nanoseconds
+            stats.avgReadLatencyNs = readLatency_.summarize().meanNs;
+            stats.avgWriteLatencyNs = writeLatency_.summarize().meanNs;
 
             return stats;
         }
 
         /**
-         * Get all active symbols
+         * Every symbol registered in the store, in symbol index order
+         *
+         * Reads the symbol index's dense by-index key array, so it costs one
+         * pass over the registered symbols and never probes the hash table.
          */
         std::vector<std::string> getActiveSymbols() const
         {
+            size_t count = symbolIndex_.size();
             std::vector<std::string> symbols;
-            // Implementation would iterate through symbolIndex_
+            symbols.reserve(count);
+            for (uint32_t index = 0; index < count; ++index)
+            {
+                // Empty only while another thread is still publishing this index
+                SymbolKey key = symbolIndex_.keyAt(index);
+                if (!key.empty())
+                {
+                    symbols.push_back(SymbolIndex::keyToString(key));
+                }
+            }
             return symbols;
         }
+
+        // Registered symbols; indices below this may be passed to the by-index calls
+        size_t getActiveSymbolCount() const noexcept { return symbolIndex_.size(); }
+
+        /**
+         * Copy every symbol that has data into out[0..capacity), in index
+         * order, each under its own seqlock. Returns the number written; equal
+         * to capacity means the buffer may have been too small.
+         */
+        size_t snapshotAll(MarketDataRecord *out, size_t capacity)
+        {
+            size_t count = symbolIndex_.size();
+            size_t written = 0;
+            MarketDataValues values;
+            for (uint32_t index = 0; index < count && written < capacity; ++index)
+            {
+                if (!marketData_[index].load(values))
+                {
+                    continue;
+                }
+
+                MarketDataRecord &record = out[written++];
+                record.symbolIndex = index;
+                record.sequence = values.sequence;
+                record.bestBid = values.bestBid;
+                record.bestAsk = values.bestAsk;
+                record.lastPrice = values.lastPrice;
+                record.spread = values.spread;
+                record.volume = values.volume;
+                record.timestamp = values.timestamp;
+            }
+
+            totalReads_.fetch_add(written, std::memory_order_relaxed);
+            return written;
+        }
+
+        size_t snapshotAll(std::vector<MarketDataRecord> &out)
+        {
+            out.resize(symbolIndex_.size());
+            out.resize(snapshotAll(out.data(), out.size()));
+            return out.size();
+        }
+    };
+
+    /**
+     * Read-only view of a MarketDataStore published by another process
+     *
+     * For sidecar readers on the same node: maps the region read-only and
+     * reads snapshots through the same seqlock, with no copies or syscalls
+     * per read. Resolve symbols once, then read by index.
+     */
+    class MarketDataView
+    {
+    private:
+        std::unique_ptr<SharedMemoryRegion> mapping_;
+        const MarketDataRegion *region_{nullptr};
+        MarketDataLayout layout_;
+        SymbolIndex symbols_; // over the read-only mapping; only its const lookups are used
+        const MarketDataSnapshot *snapshots_{nullptr};
+        const BookDepthSnapshot *depth_{nullptr};
+
+        MarketDataView() = default;
+
+    public:
+        ~MarketDataView();
+
+        // nullptr if the region is missing, not ready, or from an incompatible build
+        static std::unique_ptr<MarketDataView> open(const std::string &name);
+
+        uint32_t findSymbolIndex(const std::string &symbol) const { return symbols_.getIndex(symbol); }
+
+        bool read(uint32_t index, MarketDataValues &values) const noexcept
+        {
+            return index < layout_.symbolCapacity && snapshots_[index].load(values);
+        }
+
+        bool read(const std::string &symbol, MarketDataValues &values) const
+        {
+            return read(findSymbolIndex(symbol), values);
+        }
+
+        bool readDepth(uint32_t index, BookDepth &depth) const noexcept
+        {
+            return index < layout_.symbolCapacity && depth_[index].load(depth);
+        }
+
+        // Change ring, polled: a read-only mapping cannot register as a futex waiter
+        uint64_t getChangeSequence() const noexcept { return region_->changes.head.load(std::memory_order_acquire); }
+
+        uint64_t drainChanges(uint64_t sequence, std::vector<uint32_t> &indices) const
+        {
+            return region_->drainChanges(sequence, indices, symbols_.size());
+        }
+
+        const MarketDataRegionHeader &header() const noexcept { return region_->header; }
     };
 
     // Global market data store instance
     extern std::unique_ptr<MarketDataStore> g_marketDataStore;
 
-    // Initialize the global store
-    void initializeMarketDataStore();
+    /**
+     * Initialize the global store with config's capacity and symbol length;
+     * QUANTIS_MARKET_DATA_SHM names a shared region to publish into
+     */
+    void initializeMarketDataStore(const MarketDataStoreConfig &config = MarketDataStoreConfig::fromEnvironment());
 
     // Get the global store instance
     MarketDataStore &getMarketDataStore();
@@ -0,0 +1,640 @@
+#include "MatchingEngine.h"
+#include "CpuRelax.h"
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace quantis
+{
+
+    namespace
+    {
+        bool applyCommand(const EngineCommand &command)
+        {
+            switch (command.op)
+            {
+            case EngineOp::Match:
+                return command.book->matchOrder(command.request, *command.completion->trades);
+            case EngineOp::Remove:
+                return command.book->removeOrder(command.request.handle);
+            case EngineOp::Update:
+                return command.book->updateOrder(command.request);
+            case EngineOp::Amend:
+                return command.book->amendOrder(command.request.handle, command.request.quantity, command.request.price,
+                                                command.risk, &command.completion->reject);
+            case EngineOp::Snapshot:
+                command.book->capture(*command.image);
+                return true;
+            case EngineOp::Stop:
+                break;
+            }
+            return false;
+        }
+    }
+
+    EngineConfig EngineConfig::fromEnvironment()
+    {
+        EngineConfig config;
+
+        if (const char *shards = std::getenv("QUANTIS_ENGINE_SHARDS"))
+        {
+            config.shards = static_cast<size_t>(std::strtoul(shards, nullptr, 10));
+        }
+
+        if (const char *cpus = std::getenv("QUANTIS_ENGINE_CPUS"))
+        {
+            std::stringstream list(cpus);
+            std::string cpu;
+            while (std::getline(list, cpu, ','))
+            {
+                if (!cpu.empty())
+                {
+                    config.cpus.push_back(std::atoi(cpu.c_str()));
+                }
+            }
+        }
+
+        if (const char *capacity = std::getenv("QUANTIS_TRADE_JOURNAL_CAPACITY"))
+        {
+            config.journalCapacity = static_cast<size_t>(std::strtoul(capacity, nullptr, 10));
+        }
+
+        if (const char *capacity = std::getenv("QUANTIS_TRADE_RING_CAPACITY"))
+        {
+            config.tradeRingCapacity = static_cast<size_t>(std::strtoul(capacity, nullptr, 10));
+        }
+
+        if (const char *orders = std::getenv("QUANTIS_BOOK_RESERVE_ORDERS"))
+        {
+            config.bookReserveOrders = static_cast<size_t>(std::strtoul(orders, nullptr, 10));
+        }
+
+        if (const char *levels = std::getenv("QUANTIS_BOOK_RESERVE_LEVELS"))
+        {
+            config.bookReserveLevels = static_cast<size_t>(std::strtoul(levels, nullptr, 10));
+        }
+
+        if (const char *hugePages = std::getenv("QUANTIS_BOOK_HUGE_PAGES"))
+        {
+            config.bookHugePages = std::strcmp(hugePages, "0") != 0 && std::strcmp(hugePages, "false") != 0;
+        }
+
+        config.risk = RiskConfig::fromEnvironment();
+
+        return config;
+    }
+
+    void EngineCompletion::complete(bool result) noexcept
+    {
+        ok = result;
+        done.store(1, std::memory_order_release);
+        done.notify_one();
+    }
+
+    void EngineCompletion::wait() noexcept
+    {
+        // Round trips are usually a few hundred nanoseconds; spin before parking
+        for (int i = 0; i < 1024; ++i)
+        {
+            if (done.load(std::memory_order_acquire))
+            {
+                return;
+            }
+            cpuRelax();
+        }
+
+        while (!done.load(std::memory_order_acquire))
+        {
+            done.wait(0, std::memory_order_acquire);
+        }
+    }
+
+    EngineShard::EngineShard(uint32_t id, int cpu, size_t queueCapacity)
+        : id_(id), cpu_(cpu), commands_(queueCapacity)
+    {
+    }
+
+    EngineShard::~EngineShard()
+    {
+        stop();
+    }
+
+    void EngineShard::start()
+    {
+        thread_ = std::thread(&EngineShard::run, this);
+    }
+
+    void EngineShard::stop()
+    {
+        if (!thread_.joinable())
+        {
+            return;
+        }
+
+        EngineCommand command;
+        command.op = EngineOp::Stop;
+        post(command);
+        thread_.join();
+    }
+
+    void EngineShard::post(const EngineCommand &command) noexcept
+    {
+        commands_.push(command);
+
+        // Pairs with the fence in run(): either the shard sees the command or we see it parked
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed))
+        {
+            sleeping_.store(false, std::memory_order_relaxed);
+            sleeping_.notify_one();
+        }
+    }
+
+    void EngineShard::run()
+    {
+        pinToCpu();
+
+        EngineCommand command;
+        int idle = 0;
+        for (;;)
+        {
+            if (commands_.tryPop(command))
+            {
+                idle = 0;
+                if (command.op == EngineOp::Stop)
+                {
+                    return;
+                }
+                execute(command);
+                continue;
+            }
+
+            if (++idle < IDLE_SPINS)
+            {
+                cpuRelax();
+                continue;
+            }
+
+            // Park until a producer rings; re-check after announcing so no post is missed
+            sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (commands_.tryPop(command))
+            {
+                sleeping_.store(false, std::memory_order_relaxed);
+                idle = 0;
+                if (command.op == EngineOp::Stop)
+                {
+                    return;
+                }
+                execute(command);
+                continue;
+            }
+            sleeping_.wait(true, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+
+    void EngineShard::execute(const EngineCommand &command)
+    {
+        bool result = false;
+        try
+        {
+            result = applyCommand(command);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error on engine shard " << id_ << ": " << e.what() << std::endl;
+        }
+
+        if (command.completion)
+        {
+            command.completion->complete(result);
+        }
+    }
+
+    void EngineShard::pinToCpu()
+    {
+#ifdef __linux__
+        std::string name = "quantis-shard" + std::to_string(id_);
+        pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+
+        if (cpu_ < 0)
+        {
+            return;
+        }
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu_, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+        {
+            std::cerr << "Engine shard " << id_ << " could not pin to CPU " << cpu_ << std::endl;
+        }
+#endif
+    }
+
+    MatchingEngine::MatchingEngine(const EngineConfig &config)
+        : config_(config),
+          symbolCapacity_(getMarketDataStore().getSymbolCapacity()),
+          booksByIndex_(std::make_unique<std::atomic<OrderBook *>[]>(symbolCapacity_)),
+          risk_(config.risk)
+    {
+        for (size_t i = 0; i < config_.shards; ++i)
+        {
+            int cpu = config_.cpus.empty() ? -1 : config_.cpus[i % config_.cpus.size()];
+            shards_.push_back(std::make_unique<EngineShard>(static_cast<uint32_t>(i), cpu, config_.queueCapacity));
+            journals_.push_back(std::make_unique<TradeJournal>(static_cast<uint32_t>(i), config_.journalCapacity));
+        }
+        if (journals_.empty())
+        {
+            // Inline: books on any caller thread append to one shared journal
+            journals_.push_back(std::make_unique<TradeJournal>(0, config_.journalCapacity, true));
+        }
+
+        if (config_.tradeRingCapacity > 0)
+        {
+            for (size_t i = 0; i < journals_.size(); ++i)
+            {
+                tradeRings_.push_back(std::make_unique<TradeRing>(config_.tradeRingCapacity));
+            }
+            attachTradeRings(true);
+        }
+
+        for (auto &shard : shards_)
+        {
+            shard->start();
+        }
+
+        std::cout << "MatchingEngine started with "
+                  << (shards_.empty() ? std::string("inline execution") : std::to_string(shards_.size()) + " shard(s)")
+                  << std::endl;
+    }
+
+    MatchingEngine::~MatchingEngine()
+    {
+        // Drain and join the shards before their books go away
+        shards_.clear();
+        books_.clear();
+    }
+
+    OrderBook *MatchingEngine::getOrCreateBook(const std::string &symbol)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(booksMutex_);
+            auto it = books_.find(symbol);
+            if (it != books_.end())
+            {
+                return it->second.get();
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(booksMutex_);
+        auto it = books_.find(symbol);
+        if (it != books_.end())
+        {
+            return it->second.get();
+        }
+
+        auto configIt = bookConfigs_.find(symbol);
+        BookConfig config = configIt != bookConfigs_.end() ? configIt->second : defaultBookConfig_;
+        config.synchronized = !isSharded(); // a shard-owned book is never touched concurrently
+        config.reserveOrders = config_.bookReserveOrders;
+        config.reserveLevels = config_.bookReserveLevels;
+        config.hugePages = config_.bookHugePages;
+
+        uint32_t symbolIndex = getMarketDataStore().getOrCreateSymbolIndex(symbol);
+        if (symbolIndex >= symbolCapacity_)
+        {
+            std::cerr << "Symbol table full, cannot create book for " << symbol << std::endl;
+            return nullptr;
+        }
+
+        auto book = std::make_unique<OrderBook>(symbol, config, &journalFor(symbolIndex));
+        OrderBook *result = book.get();
+        if (events_)
+        {
+            journalBook(*result);
+            result->setEventJournal(events_);
+        }
+        booksByIndex_[result->getSymbolIndex()].store(result, std::memory_order_release);
+        books_.emplace(symbol, std::move(book));
+        return result;
+    }
+
+    OrderBook *MatchingEngine::findBook(const std::string &symbol) const
+    {
+        std::shared_lock<std::shared_mutex> lock(booksMutex_);
+        auto it = books_.find(symbol);
+        return it != books_.end() ? it->second.get() : nullptr;
+    }
+
+    bool MatchingEngine::configureBook(const std::string &symbol, const BookConfig &config)
+    {
+        std::unique_lock<std::shared_mutex> lock(booksMutex_);
+
+        // A live book keeps the backend it was created with
+        if (books_.count(symbol))
+        {
+            return false;
+        }
+
+        bookConfigs_[symbol] = config;
+        return true;
+    }
+
+    void MatchingEngine::setDefaultBookConfig(const BookConfig &config)
+    {
+        std::unique_lock<std::shared_mutex> lock(booksMutex_);
+        defaultBookConfig_ = config;
+    }
+
+    size_t MatchingEngine::getExecutedTrades(OrderHandle handle, std::vector<Trade> &trades) const
+    {
+        // Every fill of an order happens on its book, so its journal follows from the handle
+        return journalFor(handleSymbolIndex(handle)).tradesFor(handle, trades);
+    }
+
+    void MatchingEngine::journalBook(const OrderBook &book)
+    {
+        const BookConfig &config = book.getConfig();
+        BookEvent event{};
+        event.symbolIndex = book.getSymbolIndex();
+        event.bookType = static_cast<uint8_t>(config.type);
+        event.symbolLength = static_cast<uint16_t>(book.getSymbol().size());
+        event.tickSize = config.tickSize;
+        event.ladderLevels = config.ladderLevels;
+        events_->append(EventType::Book, &event, sizeof(event), book.getSymbol().data(), book.getSymbol().size());
+    }
+
+    void MatchingEngine::attachEventJournal(EventJournal *events)
+    {
+        std::unique_lock<std::shared_mutex> lock(booksMutex_);
+        events_ = events;
+        for (auto &[symbol, book] : books_)
+        {
+            if (events_)
+            {
+                journalBook(*book);
+            }
+            book->setEventJournal(events_);
+        }
+    }
+
+    bool MatchingEngine::captureBook(OrderBook &book, BookImage &image)
+    {
+        if (!isSharded())
+        {
+            book.capture(image);
+            return true;
+        }
+
+        EngineCompletion completion;
+        EngineCommand command;
+        command.op = EngineOp::Snapshot;
+        command.book = &book;
+        command.completion = &completion;
+        command.image = &image;
+
+        shardFor(book).post(command);
+        completion.wait();
+        return completion.ok;
+    }
+
+    std::vector<OrderBook *> MatchingEngine::getBooks() const
+    {
+        std::shared_lock<std::shared_mutex> lock(booksMutex_);
+        std::vector<OrderBook *> books;
+        books.reserve(books_.size());
+        for (const auto &[symbol, book] : books_)
+        {
+            books.push_back(book.get());
+        }
+        return books;
+    }
+
+    void MatchingEngine::reserveOrderSequence(uint64_t next) noexcept
+    {
+        uint64_t current = nextOrderSequence_.load(std::memory_order_relaxed);
+        while (current < next && !nextOrderSequence_.compare_exchange_weak(current, next, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void MatchingEngine::advanceTradeSequences(uint64_t sequence) noexcept
+    {
+        for (auto &journal : journals_)
+        {
+            journal->advanceSequence(sequence);
+        }
+    }
+
+    size_t MatchingEngine::getBookCount() const
+    {
+        std::shared_lock<std::shared_mutex> lock(booksMutex_);
+        return books_.size();
+    }
+
+    bool MatchingEngine::submit(EngineOp op, OrderBook &book, const OrderRequest &request, std::vector<Trade> *trades, RiskReject *reject)
+    {
+        EngineCompletion completion;
+        completion.trades = trades;
+
+        EngineCommand command;
+        command.op = op;
+        command.book = &book;
+        command.request = request;
+        command.completion = &completion;
+        command.risk = op == EngineOp::Amend ? &risk_ : nullptr;
+
+        shardFor(book).post(command);
+        completion.wait();
+        if (reject)
+        {
+            *reject = completion.reject;
+        }
+        return completion.ok;
+    }
+
+    bool MatchingEngine::matchOrder(OrderBook &book, const OrderRequest &request, std::vector<Trade> &trades, RiskReject *reject)
+    {
+        RiskReject reason = risk_.check(book, request);
+        if (reject)
+        {
+            *reject = reason;
+        }
+        if (reason != RiskReject::None)
+        {
+            return false;
+        }
+
+        size_t firstFill = trades.size();
+        bool ok = isSharded() ? submit(EngineOp::Match, book, request, &trades) : book.matchOrder(request, trades);
+        risk_.onFills(book, trades.data() + firstFill, trades.size() - firstFill);
+        return ok;
+    }
+
+    OrderHandle MatchingEngine::newOrderHandle(const OrderBook &book) noexcept
+    {
+        return makeOrderHandle(book.getSymbolIndex(), nextOrderSequence_.fetch_add(1, std::memory_order_relaxed));
+    }
+
+    OrderBook *MatchingEngine::bookForHandle(OrderHandle handle) const noexcept
+    {
+        return handle == INVALID_ORDER_HANDLE ? nullptr : bookForSymbolIndex(handleSymbolIndex(handle));
+    }
+
+    void MatchingEngine::attachTradeRings(bool attached) noexcept
+    {
+        for (size_t i = 0; i < tradeRings_.size(); ++i)
+        {
+            journals_[i]->setOutput(attached ? tradeRings_[i].get() : nullptr);
+        }
+    }
+
+    OrderBook *MatchingEngine::bookForSymbolIndex(uint32_t symbolIndex) const noexcept
+    {
+        if (symbolIndex >= symbolCapacity_)
+        {
+            return nullptr;
+        }
+        return booksByIndex_[symbolIndex].load(std::memory_order_acquire);
+    }
+
+    bool MatchingEngine::removeOrder(OrderHandle handle)
+    {
+        OrderBook *book = bookForHandle(handle);
+        if (!book)
+        {
+            return false;
+        }
+
+        if (!isSharded())
+        {
+            return book->removeOrder(handle);
+        }
+
+        OrderRequest request;
+        request.handle = handle;
+        return submit(EngineOp::Remove, *book, request, nullptr);
+    }
+
+    bool MatchingEngine::updateOrder(const OrderRequest &request, RiskReject *reject)
+    {
+        OrderBook *book = bookForHandle(request.handle);
+        if (!book)
+        {
+            return false;
+        }
+
+        RiskReject reason = risk_.check(*book, request);
+        if (reject)
+        {
+            *reject = reason;
+        }
+        if (reason != RiskReject::None)
+        {
+            return false;
+        }
+
+        if (!isSharded())
+        {
+            return book->updateOrder(request);
+        }
+        return submit(EngineOp::Update, *book, request, nullptr);
+    }
+
+    bool MatchingEngine::amendOrder(OrderHandle handle, int64_t quantity, double price, RiskReject *reject)
+    {
+        if (reject)
+        {
+            *reject = RiskReject::None;
+        }
+        OrderBook *book = bookForHandle(handle);
+        if (!book)
+        {
+            return false;
+        }
+
+        if (!isSharded())
+        {
+            return book->amendOrder(handle, quantity, price, &risk_, reject);
+        }
+
+        OrderRequest request;
+        request.handle = handle;
+        request.price = price;
+        request.quantity = quantity;
+        return submit(EngineOp::Amend, *book, request, nullptr, reject);
+    }
+
+    void EngineBatch::add(EngineOp op, OrderBook *book, const OrderRequest &request)
+    {
+        size_t i = commands_.size();
+        if (trades_.size() <= i)
+        {
+            trades_.emplace_back();
+        }
+        trades_[i].clear();
+
+        EngineCommand &command = commands_.emplace_back();
+        command.op = op;
+        command.book = book;
+        command.request = request;
+    }
+
+    void MatchingEngine::execute(EngineBatch &batch)
+    {
+        size_t count = batch.commands_.size();
+        if (batch.completionCapacity_ < count)
+        {
+            batch.completionCapacity_ = std::max(count, batch.completionCapacity_ * 2);
+            batch.completions_ = std::make_unique<EngineCompletion[]>(batch.completionCapacity_);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            EngineCommand &command = batch.commands_[i];
+            EngineCompletion &completion = batch.completions_[i];
+            completion.reset();
+            completion.trades = &batch.trades_[i];
+            command.completion = &completion;
+            command.risk = command.op == EngineOp::Amend ? &risk_ : nullptr;
+
+            if (command.book && (command.op == EngineOp::Match || command.op == EngineOp::Update))
+            {
+                // Refused orders complete here and never reach a shard
+                completion.reject = risk_.check(*command.book, command.request);
+            }
+
+            if (!command.book || completion.reject != RiskReject::None)
+            {
+                completion.complete(false);
+            }
+            else if (!isSharded())
+            {
+                completion.complete(applyCommand(command));
+            }
+            else
+            {
+                shardFor(*command.book).post(command);
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            batch.completions_[i].wait();
+            const EngineCommand &command = batch.commands_[i];
+            if (command.op == EngineOp::Match && command.book)
+            {
+                risk_.onFills(*command.book, batch.trades_[i].data(), batch.trades_[i].size());
+            }
+        }
+    }
+
+} // namespace quantis
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <shared_mutex>
+#include <unordered_map>
+#include "OrderBook.h"
+#include "RiskGate.h"
+#include "RingBuffer.h"
+
+namespace quantis
+{
+
+    /**
+     * Startup configuration for the matching engine
+     *
+     * With shards == 0 the engine runs inline: callers operate on books
+     * directly and each book serializes itself with its own lock. With
+     * shards > 0 every book is owned by exactly one engine thread, which is
+     * the only thread that ever mutates it, so books run without locks.
+     */
+    struct EngineConfig
+    {
+        size_t shards{0};
+        std::vector<int> cpus;      // shard i is pinned to cpus[i % cpus.size()]; empty = unpinned
+        size_t queueCapacity{4096}; // command ring slots per shard
+        size_t journalCapacity{TradeJournal::DEFAULT_CAPACITY}; // trades retained per journal
+        size_t tradeRingCapacity{TradeRing::DEFAULT_CAPACITY};  // output ring slots per journal; 0 = no rings
+        size_t bookReserveOrders{0};                            // BookConfig pool settings applied to every book
+        size_t bookReserveLevels{0};
+        bool bookHugePages{false};
+        RiskConfig risk; // pre-trade checks on new orders and amends
+
+        // Reads QUANTIS_ENGINE_SHARDS, QUANTIS_ENGINE_CPUS (comma-separated core list),
+        // QUANTIS_TRADE_JOURNAL_CAPACITY, QUANTIS_TRADE_RING_CAPACITY, QUANTIS_BOOK_RESERVE_ORDERS,
+        // QUANTIS_BOOK_RESERVE_LEVELS, QUANTIS_BOOK_HUGE_PAGES and the QUANTIS_RISK_* variables
+        static EngineConfig fromEnvironment();
+    };
+
+    enum class EngineOp : uint8_t
+    {
+        Match,
+        Remove,
+        Update,
+        Amend,    // by handle to EngineCommand::request's price and quantity, keeping side and user
+        Snapshot, // capture the book into EngineCommand::image
+        Stop
+    };
+
+    /**
+     * Caller-owned completion slot for one command
+     *
+     * Lives on the submitting thread's stack; the shard fills the result and
+     * publishes it with a release store before waking the caller.
+     */
+    struct EngineCompletion
+    {
+        std::atomic<uint32_t> done{0};
+        bool ok{false};
+        RiskReject reject{RiskReject::None}; // set when the risk gate refused the command
+        std::vector<Trade> *trades{nullptr};
+
+        void reset() noexcept
+        {
+            done.store(0, std::memory_order_relaxed);
+            ok = false;
+            reject = RiskReject::None;
+        }
+        void complete(bool result) noexcept;
+        void wait() noexcept;
+    };
+
+    struct EngineCommand
+    {
+        EngineOp op{EngineOp::Stop};
+        OrderBook *book{nullptr};
+        OrderRequest request;
+        EngineCompletion *completion{nullptr};
+        BookImage *image{nullptr};
+        RiskGate *risk{nullptr}; // Amend: checked on the shard, which knows the order's side and user
+    };
+
+    /**
+     * A run of commands submitted with one engine call
+     *
+     * In sharded mode every command is posted before any is awaited, so books
+     * on different shards work through the batch in parallel while each book
+     * still sees its own commands in submission order. Reuse one batch per
+     * thread: clear() keeps the trade buffers' capacity.
+     */
+    class EngineBatch
+    {
+    private:
+        friend class MatchingEngine;
+
+        std::vector<EngineCommand> commands_;
+        std::unique_ptr<EngineCompletion[]> completions_;
+        size_t completionCapacity_{0};
+        std::vector<std::vector<Trade>> trades_;
+
+    public:
+        void clear() noexcept { commands_.clear(); }
+
+        // Queue a command; a null book is rejected without reaching the engine
+        void add(EngineOp op, OrderBook *book, const OrderRequest &request);
+
+        size_t size() const noexcept { return commands_.size(); }
+        const EngineCommand &command(size_t i) const noexcept { return commands_[i]; }
+        bool ok(size_t i) const noexcept { return completions_[i].ok; }
+        RiskReject reject(size_t i) const noexcept { return completions_[i].reject; }
+        const std::vector<Trade> &trades(size_t i) const noexcept { return trades_[i]; }
+    };
+
+    /**
+     * One engine thread and the command ring that feeds it
+     */
+    class EngineShard
+    {
+    private:
+        static constexpr int IDLE_SPINS = 4096; // empty polls before the thread parks
+
+        uint32_t id_;
+        int cpu_;
+        MpscRing<EngineCommand> commands_;
+        std::atomic<bool> sleeping_{false};
+        std::thread thread_;
+
+        void run();
+        void execute(const EngineCommand &command);
+        void pinToCpu();
+
+    public:
+        EngineShard(uint32_t id, int cpu, size_t queueCapacity);
+        ~EngineShard();
+
+        EngineShard(const EngineShard &) = delete;
+        EngineShard &operator=(const EngineShard &) = delete;
+
+        void start();
+        void stop();
+
+        // Any thread; blocks only while the ring is full
+        void post(const EngineCommand &command) noexcept;
+
+        uint32_t id() const noexcept { return id_; }
+    };
+
+    /**
+     * Owns every order book and routes operations to the thread that owns it
+     *
+     * Symbols are assigned to shards by their dense symbol index, so a given
+     * book always executes on the same thread. Book creation and lookup go
+     * through a reader-writer locked directory; books are never destroyed
+     * before the engine, so returned pointers stay valid.
+     */
+    class MatchingEngine
+    {
+    private:
+        EngineConfig config_;
+        std::vector<std::unique_ptr<EngineShard>> shards_;
+        std::vector<std::unique_ptr<TradeJournal>> journals_; // one per shard, or one shared inline
+        std::vector<std::unique_ptr<TradeRing>> tradeRings_;  // output ring of journal i, if enabled
+
+        mutable std::shared_mutex booksMutex_;
+        std::unordered_map<std::string, std::unique_ptr<OrderBook>> books_;
+        size_t symbolCapacity_;                                   // the store's, fixed once it is initialized
+        std::unique_ptr<std::atomic<OrderBook *>[]> booksByIndex_; // symbol index -> book, lock-free reads
+        std::atomic<uint64_t> nextOrderSequence_{1};
+        std::unordered_map<std::string, BookConfig> bookConfigs_; // per-symbol backend overrides
+        BookConfig defaultBookConfig_;
+        EventJournal *events_{nullptr}; // under booksMutex_
+        RiskGate risk_;
+
+        EngineShard &shardFor(const OrderBook &book) { return *shards_[book.getSymbolIndex() % shards_.size()]; }
+        TradeJournal &journalFor(uint32_t symbolIndex) const { return *journals_[symbolIndex % journals_.size()]; }
+        bool submit(EngineOp op, OrderBook &book, const OrderRequest &request, std::vector<Trade> *trades, RiskReject *reject = nullptr);
+        void journalBook(const OrderBook &book);
+
+    public:
+        explicit MatchingEngine(const EngineConfig &config = EngineConfig::fromEnvironment());
+        ~MatchingEngine();
+
+        MatchingEngine(const MatchingEngine &) = delete;
+        MatchingEngine &operator=(const MatchingEngine &) = delete;
+
+        // Book directory
+        OrderBook *getOrCreateBook(const std::string &symbol);
+        OrderBook *findBook(const std::string &symbol) const;
+
+        // Select the backend for a symbol before its first order; false once the book exists
+        bool configureBook(const std::string &symbol, const BookConfig &config);
+        void setDefaultBookConfig(const BookConfig &config);
+
+        // Fresh handle for an order entering the given book
+        OrderHandle newOrderHandle(const OrderBook &book) noexcept;
+
+        // Book a handle was issued for, or nullptr
+        OrderBook *bookForHandle(OrderHandle handle) const noexcept;
+
+        // Book at a dense symbol index, or nullptr if none was created there
+        OrderBook *bookForSymbolIndex(uint32_t symbolIndex) const noexcept;
+
+        /**
+         * Order operations, executed on the book's owning thread; cancel and
+         * amend route by handle. New orders and amends pass the risk gate on
+         * the calling thread first, so a refused order never reaches a shard;
+         * reject says why (None if the book refused it).
+         */
+        bool matchOrder(OrderBook &book, const OrderRequest &request, std::vector<Trade> &trades, RiskReject *reject = nullptr);
+        bool removeOrder(OrderHandle handle);
+        bool updateOrder(const OrderRequest &request, RiskReject *reject = nullptr);
+
+        /**
+         * Amend a resting order by handle to quantity at price, with exchange
+         * semantics: a cut at the same price keeps time priority, anything
+         * else requeues it, and one that would cross the spread is refused.
+         * The risk check runs with the book lock held, as only the book knows
+         * the order's side and user.
+         */
+        bool amendOrder(OrderHandle handle, int64_t quantity, double price, RiskReject *reject = nullptr);
+
+        // Run every command in the batch and wait for all of them
+        void execute(EngineBatch &batch);
+
+        // Pre-trade limits, halts and reject counts; safe to update while orders flow
+        RiskGate &risk() noexcept { return risk_; }
+        const RiskGate &risk() const noexcept { return risk_; }
+
+        // Retained fills of an order, as aggressor or resting, oldest first
+        size_t getExecutedTrades(OrderHandle handle, std::vector<Trade> &trades) const;
+
+        // Trade journals: journal i holds the fills of shard i (a single journal when inline)
+        size_t getTradeJournalCount() const noexcept { return journals_.size(); }
+        const TradeJournal &getTradeJournal(size_t index) const { return *journals_[index]; }
+
+        /**
+         * Trade output rings: ring i carries journal i's fills to a single
+         * consumer (the Java Kafka publisher). None when tradeRingCapacity is 0.
+         */
+        size_t getTradeRingCount() const noexcept { return tradeRings_.size(); }
+        TradeRing &getTradeRing(size_t index) const { return *tradeRings_[index]; }
+
+        /**
+         * Detach the trade rings from their journals, or attach them again.
+         * Recovery replays with them detached: the journal tail's fills were
+         * published before the restart and must not go out again as new trades.
+         */
+        void attachTradeRings(bool attached) noexcept;
+
+        /**
+         * Journal every book's commands and fills to events from now on, and
+         * record each existing book so a replay can recreate it. Call while no
+         * orders are in flight (startup, after recovery).
+         */
+        void attachEventJournal(EventJournal *events);
+
+        // Copy a book's resting orders on the thread that owns it
+        bool captureBook(OrderBook &book, BookImage &image);
+
+        std::vector<OrderBook *> getBooks() const;
+
+        // Restart recovery: keep new handles and trade IDs clear of those issued before
+        uint64_t getNextOrderSequence() const noexcept { return nextOrderSequence_.load(std::memory_order_relaxed); }
+        void reserveOrderSequence(uint64_t next) noexcept;
+        void advanceTradeSequences(uint64_t sequence) noexcept;
+
+        bool isSharded() const noexcept { return !shards_.empty(); }
+        size_t getShardCount() const noexcept { return shards_.size(); }
+        size_t getBookCount() const;
+    };
+
+} // namespace quantis
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace quantis
+{
+
+    // Integer price in ticks of the owning book's tick size
+    using Price = int64_t;
+
+    // Engine-assigned order identifier; string IDs are mapped at the JNI boundary
+    using OrderHandle = uint64_t;
+    inline constexpr OrderHandle INVALID_ORDER_HANDLE = 0;
+
+    // A handle carries its book's symbol index in the top bits, so any handle routes to its book
+    inline constexpr unsigned HANDLE_SEQUENCE_BITS = 40;
+
+    constexpr OrderHandle makeOrderHandle(uint32_t symbolIndex, uint64_t sequence) noexcept
+    {
+        return (static_cast<OrderHandle>(symbolIndex) << HANDLE_SEQUENCE_BITS) |
+               (sequence & ((uint64_t{1} << HANDLE_SEQUENCE_BITS) - 1));
+    }
+
+    constexpr uint32_t handleSymbolIndex(OrderHandle handle) noexcept
+    {
+        return static_cast<uint32_t>(handle >> HANDLE_SEQUENCE_BITS);
+    }
+
+    constexpr uint64_t handleSequence(OrderHandle handle) noexcept
+    {
+        return handle & ((uint64_t{1} << HANDLE_SEQUENCE_BITS) - 1);
+    }
+
+    enum class Side : uint8_t
+    {
+        Buy,
+        Sell
+    };
+
+    inline uint64_t nowNanos() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    /**
+     * Inbound order as handed to a book; the book copies it into its slab
+     */
+    struct OrderRequest
+    {
+        OrderHandle handle{INVALID_ORDER_HANDLE};
+        uint32_t userIndex{0};
+        Side side{Side::Buy};
+        double price{0.0};
+        int64_t quantity{0};
+    };
+
+    /**
+     * Resting order record, one cache line, owned by its book's slab
+     */
+    struct alignas(64) Order
+    {
+        OrderHandle handle{INVALID_ORDER_HANDLE};
+        Price price{0};        // ticks
+        int64_t quantity{0};   // remaining
+        uint64_t timestamp{0}; // entry time, ns since epoch
+
+        // Intrusive FIFO links within the price level
+        Order *prev{nullptr};
+        Order *next{nullptr};
+
+        uint32_t symbolIndex{0}; // SymbolIndex slot of the book's symbol
+        uint32_t userIndex{0};   // interned user ID
+        Side side{Side::Buy};
+        bool isActive{false};
+    };
+
+    static_assert(sizeof(Order) == 64, "Order must stay one cache line");
+
+    /**
+     * Fill record: the aggressor's side, executed against one resting order
+     */
+    struct alignas(64) Trade
+    {
+        uint64_t tradeId{0};
+        OrderHandle orderHandle{INVALID_ORDER_HANDLE};   // aggressor
+        OrderHandle restingHandle{INVALID_ORDER_HANDLE}; // passive order filled by this trade
+        Price price{0};                                  // ticks
+        int64_t quantity{0};
+        uint64_t executedAt{0}; // ns since epoch
+        uint32_t symbolIndex{0};
+        uint32_t userIndex{0};
+        uint32_t restingUserIndex{0};
+        Side side{Side::Buy};
+        bool restingFilled{false}; // the resting order left the book on this fill
+    };
+
+    static_assert(sizeof(Trade) == 64, "Trade must stay one cache line");
+
+} // namespace quantis
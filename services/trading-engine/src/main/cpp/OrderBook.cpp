@@ -1,231 +1,753 @@
 #include "OrderBook.h"
+#include "LatencyHistogram.h"
+#include "AsyncLogger.h"
+#include "CpuRelax.h"
+#include "RiskGate.h"
 #include <iostream>
 #include <algorithm>
 
 namespace quantis
 {
 
-    OrderBook::OrderBook(const std::string &symbol) : symbol_(symbol), marketDataStore_(getMarketDataStore())
+    namespace
     {
-        std::cout << "OrderBook created for symbol: " << symbol_ << " with lock-free market data" << std::endl;
+        constexpr size_t LEVEL_CHUNK = 512; // level nodes per pool chunk
+
+        std::unique_ptr<BookSide> makeBookSide(Side side, const BookConfig &config, BlockPool *levels)
+        {
+            if (config.type == BookType::TickLadder)
+            {
+                return std::make_unique<LadderBookSide>(side, config.ladderLevels, levels);
+            }
+            return std::make_unique<MapBookSide>(side, levels);
+        }
+
+        const char *sideName(Side side)
+        {
+            return side == Side::Buy ? "BUY" : "SELL";
+        }
     }
 
-    // Destructor is defaulted in header
+    OrderBook::OrderBook(const std::string &symbol, const BookConfig &config, TradeJournal *journal)
+        : symbol_(symbol), config_(config),
+          orderSlab_(config.hugePages), levelPool_(LEVEL_NODE_BYTES, alignof(std::max_align_t), LEVEL_CHUNK, config.hugePages),
+          bids_(makeBookSide(Side::Buy, config, &levelPool_)), asks_(makeBookSide(Side::Sell, config, &levelPool_)),
+          bidDepth_(*bids_), askDepth_(*asks_), journal_(journal),
+          marketDataStore_(getMarketDataStore()),
+          orders_(std::max<size_t>(1024, config.reserveOrders * 2))
+    {
+        // Pre-size the pools so a burst does not grow them mid-match
+        orderSlab_.reserve(config_.reserveOrders);
+        levelPool_.reserve(config_.reserveLevels);
+
+        symbolIndex_ = marketDataStore_.getOrCreateSymbolIndex(symbol_);
+        std::cout << "OrderBook created for symbol: " << symbol_
+                  << (config_.type == BookType::TickLadder ? " (tick ladder)" : " (price map)")
+                  << " with lock-free market data" << std::endl;
+    }
+
+    OrderBook::~OrderBook()
+    {
+        // Stop the consumer, then complete anything still queued so no future is left hanging
+        enableAsyncProcessing(false);
+        if (asyncQueue_)
+        {
+            processOrdersInBatches(config_.asyncBatchSize);
+        }
+    }
 
-    bool OrderBook::addOrder(std::shared_ptr<Order> order)
+    bool OrderBook::addOrder(const OrderRequest &request)
     {
-        std::unique_lock<std::shared_mutex> lock(orderBookMutex_);
+        LatencyScope timer(latencyHistogram(LatencyMetric::BookAdd));
+        auto lock = writeLock();
 
         try
         {
-            // Store order
-            orders_[order->orderId] = order;
-
-            // Add to appropriate side
-            if (order->side == "BUY")
+            if (!addLocked(request))
             {
-                buyOrders_[order->price].push_back(order);
-                bestBid_.store(std::max(bestBid_.load(), order->price));
+                return false;
             }
-            else if (order->side == "SELL")
+            journalOrder(EventType::New, request, ORDER_EVENT_REST_ONLY);
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error adding order: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    bool OrderBook::addLocked(const OrderRequest &request)
+    {
+        // Handle 0 cannot be indexed, so such an order could never be cancelled
+        if (request.quantity <= 0 || request.handle == INVALID_ORDER_HANDLE || orders_.contains(request.handle))
+        {
+            return false;
+        }
+        return restOrder(createOrder(request));
+    }
+
+    void OrderBook::journalOrder(EventType type, const OrderRequest &request, uint8_t flags)
+    {
+        if (!events_)
+        {
+            return;
+        }
+
+        OrderEvent event{};
+        event.handle = request.handle;
+        event.userIndex = request.userIndex;
+        event.side = static_cast<uint8_t>(request.side);
+        event.flags = flags;
+        event.price = request.price;
+        event.quantity = request.quantity;
+        events_->append(type, &event, sizeof(event));
+    }
+
+    Order *OrderBook::createOrder(const OrderRequest &request)
+    {
+        Order *order = orderSlab_.create();
+        order->handle = request.handle;
+        order->price = toTicks(request.price);
+        order->quantity = request.quantity;
+        order->timestamp = nowNanos();
+        order->symbolIndex = symbolIndex_;
+        order->userIndex = request.userIndex;
+        order->side = request.side;
+        order->isActive = true;
+        return order;
+    }
+
+    bool OrderBook::restOrder(Order *order)
+    {
+        orders_.insert(order->handle, order);
+        addOrderToLevel(order);
+        refreshBestPrices();
+
+        totalOrders_.fetch_add(1);
+        totalVolume_.fetch_add(order->quantity);
+
+        QLOG_DEBUG("Order added: {} {} {}@{}", order->handle, sideName(order->side), order->quantity, fromTicks(order->price));
+
+        return true;
+    }
+
+    void OrderBook::retireOrder(Order *order)
+    {
+        orders_.erase(order->handle);
+        orderSlab_.destroy(order);
+    }
+
+    bool OrderBook::removeOrder(OrderHandle handle)
+    {
+        auto lock = writeLock();
+
+        try
+        {
+            if (!removeLocked(handle))
             {
-                sellOrders_[order->price].push_back(order);
-                bestAsk_.store(std::min(bestAsk_.load(), order->price));
+                return false;
             }
 
-            totalOrders_.fetch_add(1);
-            totalVolume_.fetch_add(order->quantity);
+            OrderRequest request;
+            request.handle = handle;
+            journalOrder(EventType::Cancel, request);
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error removing order: " << e.what() << std::endl;
+            return false;
+        }
+    }
 
-            std::cout << "Order added: " << order->orderId << " " << order->side
-                      << " " << order->quantity << "@" << order->price << std::endl;
+    bool OrderBook::removeLocked(OrderHandle handle)
+    {
+        Order *order = orders_.find(handle);
+        if (!order)
+        {
+            return false;
+        }
 
+        removeOrderFromLevel(order);
+        refreshBestPrices();
+
+        totalOrders_.fetch_sub(1);
+        totalVolume_.fetch_sub(order->quantity);
+        retireOrder(order);
+
+        QLOG_DEBUG("Order removed: {}", handle);
+        return true;
+    }
+
+    bool OrderBook::updateOrder(const OrderRequest &request)
+    {
+        LatencyScope timer(latencyHistogram(LatencyMetric::BookAmend));
+        auto lock = writeLock();
+
+        try
+        {
+            Order *order = orders_.find(request.handle);
+            if (request.quantity <= 0 || !order || crossesSpread(request.side, toTicks(request.price)))
+            {
+                return false;
+            }
+
+            amendLocked(*order, request);
+            journalOrder(EventType::Amend, request);
             return true;
         }
         catch (const std::exception &e)
         {
-            std::cerr << "Error adding order: " << e.what() << std::endl;
+            std::cerr << "Error updating order: " << e.what() << std::endl;
             return false;
         }
     }
 
-    bool OrderBook::removeOrder(const std::string &orderId)
+    bool OrderBook::amendOrder(OrderHandle handle, int64_t quantity, double price, RiskGate *risk, RiskReject *reject)
     {
-        std::unique_lock<std::shared_mutex> lock(orderBookMutex_);
+        LatencyScope timer(latencyHistogram(LatencyMetric::BookAmend));
+        auto lock = writeLock();
 
         try
         {
-            auto it = orders_.find(orderId);
-            if (it == orders_.end())
+            Order *order = orders_.find(handle);
+            if (quantity <= 0 || !order || crossesSpread(order->side, toTicks(price)))
             {
                 return false;
             }
 
-            auto order = it->second;
-            orders_.erase(it);
+            OrderRequest request;
+            request.handle = handle;
+            request.userIndex = order->userIndex;
+            request.side = order->side;
+            request.price = price;
+            request.quantity = quantity;
 
-            // Remove from appropriate side
-            if (order->side == "BUY")
+            // Checked here, where the order's side and user are known
+            if (risk)
             {
-                auto buyIt = buyOrders_.find(order->price);
-                if (buyIt != buyOrders_.end())
+                RiskReject reason = risk->check(*this, request);
+                if (reject)
                 {
-                    auto &orders = buyIt->second;
-                    orders.erase(std::remove(orders.begin(), orders.end(), order), orders.end());
-                    if (orders.empty())
-                    {
-                        buyOrders_.erase(buyIt);
-                    }
+                    *reject = reason;
                 }
-            }
-            else if (order->side == "SELL")
-            {
-                auto sellIt = sellOrders_.find(order->price);
-                if (sellIt != sellOrders_.end())
+                if (reason != RiskReject::None)
                 {
-                    auto &orders = sellIt->second;
-                    orders.erase(std::remove(orders.begin(), orders.end(), order), orders.end());
-                    if (orders.empty())
-                    {
-                        sellOrders_.erase(sellIt);
-                    }
+                    return false;
                 }
             }
 
-            totalOrders_.fetch_sub(1);
-            totalVolume_.fetch_sub(order->quantity);
-
-            std::cout << "Order removed: " << orderId << std::endl;
+            amendLocked(*order, request);
+            journalOrder(EventType::Amend, request);
             return true;
         }
         catch (const std::exception &e)
         {
-            std::cerr << "Error removing order: " << e.what() << std::endl;
+            std::cerr << "Error amending order: " << e.what() << std::endl;
             return false;
         }
     }
 
-    bool OrderBook::updateOrder(std::shared_ptr<Order> order)
+    bool OrderBook::crossesSpread(Side side, Price price)
     {
-        std::unique_lock<std::shared_mutex> lock(orderBookMutex_);
+        // Amends rest without matching, so one that would trade must not rest at all
+        PriceLevel *contra = side == Side::Buy ? asks_->best() : bids_->best();
+        return contra && (side == Side::Buy ? price >= contra->price : price <= contra->price);
+    }
 
-        try
+    void OrderBook::amendLocked(Order &order, const OrderRequest &request)
+    {
+        Price price = toTicks(request.price);
+        int64_t previous = order.quantity;
+        BookSide &side = sideOf(order);
+
+        if (request.side == order.side && price == order.price)
         {
-            auto it = orders_.find(order->orderId);
-            if (it == orders_.end())
+            PriceLevel *level = side.find(price);
+            if (request.quantity <= order.quantity)
             {
-                return false;
+                // Quantity cut: same place in the queue
+                level->totalQuantity -= order.quantity - request.quantity;
+                order.quantity = request.quantity;
+            }
+            else
+            {
+                // Quantity up: back of the same level
+                level->unlink(&order);
+                order.quantity = request.quantity;
+                order.timestamp = nowNanos();
+                level->pushBack(&order);
+            }
+            // The best prices cannot move, but the level's depth did
+            depthOf(side).levelChanged(price, level);
+            publishDepth();
+        }
+        else
+        {
+            // New price (or side): one unlink and one relink of the same record
+            removeOrderFromLevel(&order);
+            order.price = price;
+            order.quantity = request.quantity;
+            order.side = request.side;
+            order.timestamp = nowNanos();
+            addOrderToLevel(&order);
+            refreshBestPrices();
+        }
+        order.userIndex = request.userIndex;
+
+        if (order.quantity > previous)
+        {
+            totalVolume_.fetch_add(static_cast<size_t>(order.quantity - previous));
+        }
+        else
+        {
+            totalVolume_.fetch_sub(static_cast<size_t>(previous - order.quantity));
+        }
+
+        QLOG_DEBUG("Order amended: {} {}@{}", order.handle, order.quantity, fromTicks(order.price));
+    }
+
+    bool OrderBook::containsOrder(OrderHandle handle) const
+    {
+        auto lock = config_.synchronized ? std::shared_lock<std::shared_mutex>(orderBookMutex_)
+                                         : std::shared_lock<std::shared_mutex>();
+        return orders_.contains(handle);
+    }
+
+    void OrderBook::capture(BookImage &image)
+    {
+        auto lock = config_.synchronized ? std::shared_lock<std::shared_mutex>(orderBookMutex_)
+                                         : std::shared_lock<std::shared_mutex>();
+
+        // Read under the book lock: this book's events are appended under it too
+        image.eventSequence = events_ ? events_->lastSequence() : 0;
+        image.lastTradePrice = lastTradePrice_.load();
+        image.orders.clear();
+        for (BookSide *side : {bids_.get(), asks_.get()})
+        {
+            for (PriceLevel *level = side->best(); level; level = side->next(level))
+            {
+                for (Order *order = level->head; order; order = order->next)
+                {
+                    image.orders.push_back(BookImage::RestingOrder{order->handle, order->price, order->quantity,
+                                                                   order->timestamp, order->userIndex, order->side});
+                }
             }
+        }
+    }
 
-            auto oldOrder = it->second;
+    bool OrderBook::restore(const BookImage &image)
+    {
+        auto lock = writeLock();
 
-            // Remove old order
-            removeOrder(order->orderId);
+        try
+        {
+            for (const BookImage::RestingOrder &resting : image.orders)
+            {
+                if (resting.quantity <= 0 || resting.handle == INVALID_ORDER_HANDLE || orders_.contains(resting.handle))
+                {
+                    continue;
+                }
+
+                Order *order = orderSlab_.create();
+                order->handle = resting.handle;
+                order->price = resting.price;
+                order->quantity = resting.quantity;
+                order->timestamp = resting.timestamp;
+                order->symbolIndex = symbolIndex_;
+                order->userIndex = resting.userIndex;
+                order->side = resting.side;
+                order->isActive = true;
+                restOrder(order);
+            }
 
-            // Add updated order
-            return addOrder(order);
+            if (image.lastTradePrice > 0)
+            {
+                lastTradePrice_.store(image.lastTradePrice);
+                lastPrice_.store(image.lastTradePrice);
+            }
+            return true;
         }
         catch (const std::exception &e)
         {
-            std::cerr << "Error updating order: " << e.what() << std::endl;
+            std::cerr << "Error restoring order book: " << e.what() << std::endl;
             return false;
         }
     }
 
-    std::vector<Trade> OrderBook::matchOrder(std::shared_ptr<Order> order)
+    std::vector<Trade> OrderBook::matchOrder(const OrderRequest &request)
     {
         std::vector<Trade> trades;
+        trades.reserve(TRADE_RESERVE);
+        matchOrder(request, trades);
+        return trades;
+    }
+
+    bool OrderBook::matchOrder(const OrderRequest &request, std::vector<Trade> &trades)
+    {
+        LatencyScope timer(latencyHistogram(LatencyMetric::BookMatch));
+        auto lock = writeLock();
+        return matchLocked(request, trades);
+    }
 
+    bool OrderBook::matchLocked(const OrderRequest &request, std::vector<Trade> &trades)
+    {
         try
         {
-            if (order->side == "BUY")
+            if (request.quantity <= 0 || request.handle == INVALID_ORDER_HANDLE || orders_.contains(request.handle))
             {
-                trades = matchBuyOrder(order);
+                return false;
             }
-            else if (order->side == "SELL")
+
+            journalOrder(EventType::New, request);
+
+            Order *order = createOrder(request);
+            size_t firstFill = trades.size();
+
+            matchAgainst(*order, order->side == Side::Buy ? *asks_ : *bids_, trades);
+
+            if (trades.size() > firstFill)
             {
-                trades = matchSellOrder(order);
+                totalTrades_.fetch_add(trades.size() - firstFill, std::memory_order_relaxed);
+                double lastPrice = fromTicks(trades.back().price);
+                lastTradePrice_.store(lastPrice);
+                lastPrice_.store(lastPrice);
             }
 
-            // Update last trade price
-            if (!trades.empty())
+            // Rest whatever the sweep left over; otherwise only the contra side changed
+            if (order->quantity > 0)
             {
-                lastTradePrice_.store(trades.back().price);
+                return restOrder(order);
             }
+
+            orderSlab_.destroy(order);
+            refreshBestPrices();
+            return true;
         }
         catch (const std::exception &e)
         {
             std::cerr << "Error matching order: " << e.what() << std::endl;
+            return false;
         }
+    }
 
-        return trades;
+    MpscRing<OrderBook::AsyncOrder> &OrderBook::asyncQueue()
+    {
+        std::call_once(asyncQueueOnce_, [this]
+                       { asyncQueue_ = std::make_unique<MpscRing<AsyncOrder>>(config_.asyncQueueCapacity); });
+        return *asyncQueue_;
     }
 
-    std::vector<Trade> OrderBook::matchBuyOrder(std::shared_ptr<Order> order)
+    std::future<std::vector<Trade>> OrderBook::addOrderAsync(const OrderRequest &request)
     {
-        std::vector<Trade> trades;
+        auto promise = std::make_unique<std::promise<std::vector<Trade>>>();
+        auto future = promise->get_future();
+        if (!config_.synchronized)
+        {
+            promise->set_exception(std::make_exception_ptr(std::logic_error("book is owned by an engine thread")));
+            return future;
+        }
+
+        AsyncOrder item{request, promise.get(), nullptr, nullptr};
+        MpscRing<AsyncOrder> &queue = asyncQueue();
+
+        // Backpressure: hold the producer until there is room, doing the
+        // consumer's work ourselves if no consumer thread is running
+        while (!queue.tryPush(item))
+        {
+            if (!asyncRunning_.load(std::memory_order_acquire))
+            {
+                processOrdersInBatches(config_.asyncBatchSize);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        promise.release(); // the queue entry owns it now
+        wakeAsyncConsumer();
+        return future;
+    }
 
-        // Simple matching logic - match against best ask
-        if (!sellOrders_.empty())
+    bool OrderBook::tryAddOrderAsync(const OrderRequest &request, AsyncOrderCallback callback, void *context)
+    {
+        if (!config_.synchronized || !asyncQueue().tryPush(AsyncOrder{request, nullptr, callback, context}))
         {
-            auto bestAskIt = sellOrders_.begin();
-            double bestAskPrice = bestAskIt->first;
+            return false;
+        }
+        wakeAsyncConsumer();
+        return true;
+    }
 
-            if (order->price >= bestAskPrice)
+    void OrderBook::wakeAsyncConsumer() noexcept
+    {
+        // Pairs with the fence in runAsyncConsumer(): either it sees the order or we see it parked
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (asyncSleeping_.load(std::memory_order_relaxed))
+        {
+            asyncSleeping_.store(false, std::memory_order_relaxed);
+            asyncSleeping_.notify_one();
+        }
+    }
+
+    size_t OrderBook::processOrdersInBatches(size_t batchSize)
+    {
+        if (!config_.synchronized)
+        {
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> consumer(asyncConsumerMutex_);
+        size_t processed = 0;
+        while (size_t drained = drainAsyncBatch(std::max<size_t>(batchSize, 1)))
+        {
+            processed += drained;
+        }
+        return processed;
+    }
+
+    size_t OrderBook::drainAsyncBatch(size_t batchSize)
+    {
+        MpscRing<AsyncOrder> &queue = asyncQueue();
+        asyncBatch_.clear();
+        asyncTrades_.clear();
+
+        AsyncOrder item;
+        while (asyncBatch_.size() < batchSize && queue.tryPop(item))
+        {
+            asyncBatch_.push_back(AsyncResult{item, 0, 0, false});
+        }
+        if (asyncBatch_.empty())
+        {
+            return 0;
+        }
+
+        // One lock acquisition (and one warm pass over the book) for the whole batch
+        {
+            auto lock = writeLock();
+            for (AsyncResult &result : asyncBatch_)
             {
-                // Create trade
-                Trade trade;
-                trade.tradeId = "trade_" + std::to_string(std::time(nullptr));
-                trade.orderId = order->orderId;
-                trade.userId = order->userId;
-                trade.symbol = order->symbol;
-                trade.side = order->side;
-                trade.quantity = std::min(order->quantity, bestAskIt->second[0]->quantity);
-                trade.price = bestAskPrice;
-                trade.totalValue = trade.quantity * trade.price;
-                trade.executedAt = std::chrono::system_clock::now();
-
-                trades.push_back(trade);
-
-                std::cout << "Trade executed: " << trade.tradeId << " "
-                          << trade.quantity << "@" << trade.price << std::endl;
+                result.firstTrade = asyncTrades_.size();
+                result.accepted = matchLocked(result.order.request, asyncTrades_);
+                result.tradeCount = asyncTrades_.size() - result.firstTrade;
             }
         }
 
-        return trades;
+        // Complete outside the lock so callbacks and waking futures don't stall the book
+        for (AsyncResult &result : asyncBatch_)
+        {
+            const Trade *trades = asyncTrades_.data() + result.firstTrade;
+            if (result.order.callback)
+            {
+                result.order.callback(result.order.context, result.order.request.handle, result.accepted, trades, result.tradeCount);
+                continue;
+            }
+
+            std::unique_ptr<std::promise<std::vector<Trade>>> promise(result.order.promise);
+            if (result.accepted)
+            {
+                promise->set_value(std::vector<Trade>(trades, trades + result.tradeCount));
+            }
+            else
+            {
+                promise->set_exception(std::make_exception_ptr(std::invalid_argument("order rejected")));
+            }
+        }
+        return asyncBatch_.size();
     }
 
-    std::vector<Trade> OrderBook::matchSellOrder(std::shared_ptr<Order> order)
+    void OrderBook::runAsyncConsumer()
     {
-        std::vector<Trade> trades;
+        int idle = 0;
+        while (asyncRunning_.load(std::memory_order_acquire))
+        {
+            size_t drained;
+            {
+                std::lock_guard<std::mutex> consumer(asyncConsumerMutex_);
+                drained = drainAsyncBatch(config_.asyncBatchSize);
+            }
+            if (drained)
+            {
+                idle = 0;
+                continue;
+            }
 
-        // Simple matching logic - match against best bid
-        if (!buyOrders_.empty())
+            if (++idle < ASYNC_IDLE_SPINS)
+            {
+                cpuRelax();
+                continue;
+            }
+
+            // Park until a producer rings; re-check after announcing so no order is missed
+            asyncSleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool pending;
+            {
+                std::lock_guard<std::mutex> consumer(asyncConsumerMutex_);
+                pending = !asyncQueue_->empty();
+            }
+            if (pending || !asyncRunning_.load(std::memory_order_acquire))
+            {
+                asyncSleeping_.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            asyncSleeping_.wait(true, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+
+    bool OrderBook::enableAsyncProcessing(bool enable)
+    {
+        if (!config_.synchronized)
         {
-            auto bestBidIt = buyOrders_.begin();
-            double bestBidPrice = bestBidIt->first;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> control(asyncControlMutex_);
+        if (enable == asyncRunning_.load(std::memory_order_relaxed))
+        {
+            return true;
+        }
+
+        if (enable)
+        {
+            asyncQueue();
+            asyncRunning_.store(true, std::memory_order_release);
+            processingThread_ = std::thread([this]
+                                            { runAsyncConsumer(); });
+            return true;
+        }
+
+        asyncRunning_.store(false, std::memory_order_release);
+        wakeAsyncConsumer();
+        processingThread_.join();
+
+        processOrdersInBatches(config_.asyncBatchSize);
+        return true;
+    }
+
+    void OrderBook::matchAgainst(Order &order, BookSide &contra, std::vector<Trade> &trades)
+    {
+        bool isBuy = order.side == Side::Buy;
+        uint64_t executedAt = nowNanos();
+
+        // Walk levels best-first until the limit stops crossing or the order is filled
+        while (order.quantity > 0)
+        {
+            PriceLevel *level = contra.best();
+            if (!level || (isBuy ? level->price > order.price : level->price < order.price))
+            {
+                break;
+            }
+
+            // Fill resting orders in time priority, reducing them in place
+            while (order.quantity > 0 && level->head)
+            {
+                Order *resting = level->head;
+                int64_t fill = std::min(order.quantity, resting->quantity);
+
+                order.quantity -= fill;
+                resting->quantity -= fill;
+                level->totalQuantity -= fill;
+                totalVolume_.fetch_sub(fill);
+
+                Trade &trade = trades.emplace_back();
+                trade.orderHandle = order.handle;
+                trade.restingHandle = resting->handle;
+                trade.price = level->price;
+                trade.quantity = fill;
+                trade.executedAt = executedAt;
+                trade.symbolIndex = symbolIndex_;
+                trade.userIndex = order.userIndex;
+                trade.restingUserIndex = resting->userIndex;
+                trade.side = order.side;
+                trade.restingFilled = resting->quantity == 0;
+                if (journal_)
+                {
+                    journal_->append(trade, config_.tickSize);
+                }
+                else
+                {
+                    trade.tradeId = makeTradeId(0, ++tradeSequence_);
+                }
+                if (events_)
+                {
+                    events_->append(EventType::Fill, &trade, sizeof(Trade));
+                }
+
+                QLOG_DEBUG("Trade executed: {} {}@{}", trade.tradeId, trade.quantity, fromTicks(trade.price));
 
-            if (order->price <= bestBidPrice)
+                // Retire fully filled resting orders
+                if (trade.restingFilled)
+                {
+                    level->unlink(resting);
+                    totalOrders_.fetch_sub(1);
+                    retireOrder(resting);
+                }
+            }
+
+            // One depth update per level swept, however many orders it filled
+            Price price = level->price;
+            if (level->empty())
             {
-                // Create trade
-                Trade trade;
-                trade.tradeId = "trade_" + std::to_string(std::time(nullptr));
-                trade.orderId = order->orderId;
-                trade.userId = order->userId;
-                trade.symbol = order->symbol;
-                trade.side = order->side;
-                trade.quantity = std::min(order->quantity, bestBidIt->second[0]->quantity);
-                trade.price = bestBidPrice;
-                trade.totalValue = trade.quantity * trade.price;
-                trade.executedAt = std::chrono::system_clock::now();
-
-                trades.push_back(trade);
-
-                std::cout << "Trade executed: " << trade.tradeId << " "
-                          << trade.quantity << "@" << trade.price << std::endl;
+                contra.erase(level);
+                level = nullptr;
             }
+            depthOf(contra).levelChanged(price, level);
         }
+    }
 
-        return trades;
+    void OrderBook::addOrderToLevel(Order *order)
+    {
+        BookSide &side = sideOf(*order);
+        PriceLevel *level = side.findOrCreate(order->price);
+        level->pushBack(order);
+        depthOf(side).levelChanged(order->price, level);
+    }
+
+    void OrderBook::removeOrderFromLevel(Order *order)
+    {
+        BookSide &side = sideOf(*order);
+        PriceLevel *level = side.find(order->price);
+        if (!level)
+        {
+            return;
+        }
+
+        level->unlink(order);
+        if (level->empty())
+        {
+            side.erase(level);
+            level = nullptr;
+        }
+        depthOf(side).levelChanged(order->price, level);
+    }
+
+    void OrderBook::refreshBestPrices()
+    {
+        // O(1) on both backends: the sides track their own best level
+        PriceLevel *bid = bids_->best();
+        PriceLevel *ask = asks_->best();
+        bestBid_.store(bid ? fromTicks(bid->price) : 0.0);
+        bestAsk_.store(ask ? fromTicks(ask->price) : 0.0);
+        publishDepth();
+    }
+
+    void OrderBook::publishDepth()
+    {
+        if (!bidDepth_.dirty() && !askDepth_.dirty())
+        {
+            return;
+        }
+
+        // Only levels from each side's first change on are converted and rewritten
+        uint32_t bidFrom = bidDepth_.flush(depth_.bids, config_.tickSize);
+        uint32_t askFrom = askDepth_.flush(depth_.asks, config_.tickSize);
+        depth_.bidCount = bidDepth_.count();
+        depth_.askCount = askDepth_.count();
+        depth_.timestamp = nowNanos();
+        marketDataStore_.publishDepth(symbolIndex_, depth_, bidFrom, askFrom);
     }
 
     double OrderBook::getSpread() const
@@ -246,22 +768,43 @@ namespace quantis
         return totalOrders_.load();
     }
 
+    BookMemoryStats OrderBook::getMemoryStats() const noexcept
+    {
+        const BlockPool &orders = orderSlab_.pool();
+        BookMemoryStats stats;
+        stats.ordersInUse = orders.inUse();
+        stats.orderCapacity = orders.capacity();
+        stats.levelsInUse = levelPool_.inUse();
+        stats.levelCapacity = levelPool_.capacity();
+        stats.reservedBytes = orders.reservedBytes() + levelPool_.reservedBytes();
+        stats.hugePageBytes = orders.hugePageBytes() + levelPool_.hugePageBytes();
+        return stats;
+    }
+
     // Ultra-low latency market data integration
     bool OrderBook::updateMarketData(double bestBid, double bestAsk, double lastPrice, long volume)
     {
-        return marketDataStore_.updateMarketData(symbol_, bestBid, bestAsk, lastPrice, volume);
+        return marketDataStore_.updateMarketData(symbolIndex_, bestBid, bestAsk, lastPrice, volume);
     }
 
     bool OrderBook::getMarketData(double &bestBid, double &bestAsk, double &lastPrice, double &spread)
     {
-        long volume;
-        uint64_t timestamp;
-        return marketDataStore_.getMarketData(symbol_, bestBid, bestAsk, lastPrice, spread, volume, timestamp);
+        MarketDataValues values;
+        if (!marketDataStore_.getMarketData(symbolIndex_, values))
+        {
+            return false;
+        }
+
+        bestBid = values.bestBid;
+        bestAsk = values.bestAsk;
+        lastPrice = values.lastPrice;
+        spread = values.spread;
+        return true;
     }
 
     bool OrderBook::hasValidMarketData() const
     {
-        return marketDataStore_.hasValidData(symbol_);
+        return marketDataStore_.hasValidData(symbolIndex_);
     }
 
 } // namespace quantis
@@ -12,49 +12,88 @@
 #include <concepts>
 #include <ranges>
 #include <algorithm>
-#include <execution>
 #include <thread>
 #include <future>
-#include <queue>
-#include <condition_variable>
-#include <generator>
+#include <unordered_map>
+#include <cmath>
 #include "MarketDataStore.h"
+#include "Order.h"
+#include "BookSide.h"
+#include "Slab.h"
+#include "OrderIndex.h"
+#include "DepthTracker.h"
+#include "RingBuffer.h"
+#include "TradeJournal.h"
+#include "EventJournal.h"
 
 namespace quantis
 {
 
-    struct Order
+    class RiskGate;
+    enum class RiskReject : uint8_t;
+
+    enum class BookType : uint8_t
+    {
+        Map,       // sparse std::map of tick levels
+        TickLadder // dense tick window around the touch
+    };
+
+    struct BookConfig
     {
-        std::string orderId;
-        std::string userId;
-        std::string symbol;
-        std::string side; // "BUY" or "SELL"
-        long quantity;
-        double price;
-        std::chrono::system_clock::time_point timestamp;
-        bool isActive;
-
-        Order() : quantity(0), price(0.0), isActive(false) {}
-
-        Order(const std::string &id, const std::string &user, const std::string &sym,
-              const std::string &s, long qty, double prc)
-            : orderId(id), userId(user), symbol(sym), side(s), quantity(qty), price(prc),
-              timestamp(std::chrono::system_clock::now()), isActive(true) {}
+        BookType type{BookType::Map};
+        double tickSize{0.01};
+        size_t ladderLevels{4096};       // dense window width for BookType::TickLadder
+        bool synchronized{true};         // take the book lock; off when one engine thread owns the book
+        size_t asyncQueueCapacity{1024}; // bound of the async order queue (rounded up to a power of two)
+        size_t asyncBatchSize{64};       // orders matched per lock acquisition by the async consumer
+        size_t reserveOrders{0};         // order records and index slots allocated when the book is created
+        size_t reserveLevels{0};         // level nodes allocated up front (map levels, ladder overflow)
+        bool hugePages{false};           // back the order and level pools with huge pages (2 MiB per pool at least)
     };
 
-    struct Trade
+    // Occupancy of a book's order and level pools
+    struct BookMemoryStats
     {
-        std::string tradeId;
-        std::string orderId;
-        std::string userId;
-        std::string symbol;
-        std::string side;
-        long quantity;
-        double price;
-        double totalValue;
-        std::chrono::system_clock::time_point executedAt;
-
-        Trade() : quantity(0), price(0.0), totalValue(0.0) {}
+        size_t ordersInUse{0};
+        size_t orderCapacity{0};
+        size_t levelsInUse{0};
+        size_t levelCapacity{0};
+        size_t reservedBytes{0}; // both pools
+        size_t hugePageBytes{0}; // part of reservedBytes mapped on reserved huge pages
+    };
+
+    /**
+     * Completion for OrderBook::tryAddOrderAsync
+     *
+     * Runs on the thread draining the queue, after the book lock is released.
+     * accepted is false if the order was rejected; trades are only valid for
+     * the duration of the call.
+     */
+    using AsyncOrderCallback = void (*)(void *context, OrderHandle handle, bool accepted, const Trade *trades, size_t count);
+
+    /**
+     * Copy of a book's resting orders, for snapshots
+     *
+     * Orders are listed bids then asks, best level first and in time
+     * priority within a level, so restoring them in order rebuilds the same
+     * queues. eventSequence is the event journal sequence the image is
+     * current to: every event of this book up to it is reflected, none after.
+     */
+    struct BookImage
+    {
+        struct RestingOrder
+        {
+            OrderHandle handle;
+            Price price; // ticks
+            int64_t quantity;
+            uint64_t timestamp;
+            uint32_t userIndex;
+            Side side;
+        };
+
+        uint64_t eventSequence{0};
+        double lastTradePrice{0.0};
+        std::vector<RestingOrder> orders;
     };
 
     // Type safety helpers (C++17 compatible)
@@ -67,29 +106,63 @@ namespace quantis
     {
     private:
         std::string symbol_;
+        uint32_t symbolIndex_;
+        BookConfig config_;
         mutable std::shared_mutex orderBookMutex_; // Reader-writer lock
-        std::mutex tradeMutex_;                    // For trade operations
-        std::condition_variable tradeCondition_;   // For async operations
 
-        // Thread-safe order storage with modern containers
-        std::map<double, std::vector<std::shared_ptr<Order>>, std::greater<double>> buyOrders_;
-        std::map<double, std::vector<std::shared_ptr<Order>>> sellOrders_;
+        // Resting order records and their price levels per side; level nodes come from one pool for both sides
+        Slab<Order> orderSlab_;
+        BlockPool levelPool_;
+        std::unique_ptr<BookSide> bids_;
+        std::unique_ptr<BookSide> asks_;
+
+        // Top levels of each side, published to the market data store after each operation
+        DepthTracker bidDepth_;
+        DepthTracker askDepth_;
+        BookDepth depth_; // publish scratch: positions below each side's flush point are stale
 
         // Lock-free atomic counters
         std::atomic<size_t> totalOrders_{0};
         std::atomic<size_t> totalVolume_{0};
         std::atomic<double> lastTradePrice_{0.0};
+        std::atomic<uint64_t> totalTrades_{0};
+        uint64_t tradeSequence_{0}; // trade numbering when no journal is attached
+        TradeJournal *journal_;     // numbers and records every fill, if set
+        EventJournal *events_{nullptr}; // durable record of accepted commands and fills, if set
+
+        // Async order pipeline: producers push into a bounded MPSC queue and one
+        // consumer at a time matches it in batches under a single book lock
+        struct AsyncOrder
+        {
+            OrderRequest request;
+            std::promise<std::vector<Trade>> *promise; // addOrderAsync; owned by the queue entry
+            AsyncOrderCallback callback;               // tryAddOrderAsync
+            void *context;
+        };
 
-        // Async trade processing
-        std::queue<std::shared_ptr<Order>> pendingOrders_;
-        std::atomic<bool> processingEnabled_{true};
+        struct AsyncResult
+        {
+            AsyncOrder order;
+            size_t firstTrade;
+            size_t tradeCount;
+            bool accepted;
+        };
+
+        std::once_flag asyncQueueOnce_;
+        std::unique_ptr<MpscRing<AsyncOrder>> asyncQueue_; // allocated on first async use
+        std::mutex asyncConsumerMutex_;                    // held while draining a batch
+        std::vector<AsyncResult> asyncBatch_;              // consumer scratch, under asyncConsumerMutex_
+        std::vector<Trade> asyncTrades_;
+        std::mutex asyncControlMutex_; // enable / disable
+        std::atomic<bool> asyncRunning_{false};
+        std::atomic<bool> asyncSleeping_{false};
         std::thread processingThread_;
 
         // Ultra-low latency market data integration
         MarketDataStore &marketDataStore_;
 
-        // Order lookup by ID for fast access
-        std::map<std::string, std::shared_ptr<Order>> orders_;
+        // Order lookup by handle: one open-addressing probe, then an intrusive unlink
+        OrderIndex orders_;
 
         // Market data
         std::atomic<double> lastPrice_{0.0};
@@ -97,16 +170,32 @@ namespace quantis
         std::atomic<double> bestAsk_{0.0};
 
     public:
-        explicit OrderBook(const std::string &symbol);
-        ~OrderBook() = default;
+        explicit OrderBook(const std::string &symbol, const BookConfig &config = BookConfig{}, TradeJournal *journal = nullptr);
+        ~OrderBook();
 
         // Order management
-        bool addOrder(std::shared_ptr<Order> order);
-        bool removeOrder(const std::string &orderId);
-        bool updateOrder(std::shared_ptr<Order> order);
+        bool addOrder(const OrderRequest &request);
+        bool removeOrder(OrderHandle handle);
+        bool updateOrder(const OrderRequest &request);
+
+        /**
+         * Amend a resting order to quantity at price, keeping its side and
+         * user. A quantity cut at the same price is applied in place and
+         * keeps time priority; any other change moves the order to the back
+         * of its (new) level's queue. The order rests without matching, so an
+         * amend to a price at or through the best opposite price is refused
+         * rather than leaving the book crossed (updateOrder too). With risk
+         * set the amend is checked under the book lock first, and reject says
+         * why it was refused.
+         */
+        bool amendOrder(OrderHandle handle, int64_t quantity, double price, RiskGate *risk = nullptr, RiskReject *reject = nullptr);
+
+        // Order matching: fill against the contra side in price-time priority, then rest any remainder
+        std::vector<Trade> matchOrder(const OrderRequest &request);
 
-        // Order matching
-        std::vector<Trade> matchOrder(std::shared_ptr<Order> order);
+        // Same, appending fills to a caller-owned vector so hot paths can reuse its capacity.
+        // Returns false if the order is rejected (bad quantity, handle 0 or a duplicate handle).
+        bool matchOrder(const OrderRequest &request, std::vector<Trade> &trades);
 
         // Market data
         double getBestBid() const { return bestBid_.load(); }
@@ -121,9 +210,18 @@ namespace quantis
         long getTotalVolume() const { return totalVolume_.load(); }
 
         // Order book state
-        std::vector<std::shared_ptr<Order>> getBestBidOrders() const;
-        std::vector<std::shared_ptr<Order>> getBestAskOrders() const;
+        const std::string &getSymbol() const noexcept { return symbol_; }
+        uint32_t getSymbolIndex() const noexcept { return symbolIndex_; }
+        const BookConfig &getConfig() const noexcept { return config_; }
+        Price toTicks(double price) const noexcept { return static_cast<Price>(std::llround(price / config_.tickSize)); }
+        double fromTicks(Price ticks) const noexcept { return static_cast<double>(ticks) * config_.tickSize; }
+
+        bool containsOrder(OrderHandle handle) const;
+
+        std::vector<Order> getBestBidOrders() const;
+        std::vector<Order> getBestAskOrders() const;
         size_t getOrderCount() const;
+        BookMemoryStats getMemoryStats() const noexcept;
 
         // Utility
         void updateMarketData();
@@ -133,30 +231,87 @@ namespace quantis
         template <typename T>
         bool addOrderModern(std::shared_ptr<T> order);
 
-        // Async order processing
-        std::future<std::vector<Trade>> addOrderAsync(std::shared_ptr<Order> order);
+        /**
+         * Queue an order for matching and get its fills through a future
+         *
+         * The order is matched when the queue is drained, by the thread from
+         * enableAsyncProcessing or by processOrdersInBatches. Blocks while the
+         * queue is full (draining it itself when no consumer thread runs). A
+         * rejected order completes the future with an exception. Not available
+         * on books owned by an engine thread.
+         */
+        std::future<std::vector<Trade>> addOrderAsync(const OrderRequest &request);
 
-        // Parallel order matching using C++17 parallel algorithms
-        std::vector<Trade> matchOrderParallel(std::shared_ptr<Order> order);
+        /**
+         * Queue an order without blocking; false if the queue is full (or the
+         * book is engine-owned), in which case callback is never called
+         */
+        bool tryAddOrderAsync(const OrderRequest &request, AsyncOrderCallback callback, void *context = nullptr);
 
         // Range-based operations (C++17 compatible)
-        std::vector<std::shared_ptr<Order>> getBestBids() const;
-        std::vector<std::shared_ptr<Order>> getBestAsks() const;
+        std::vector<Order> getBestBids() const;
+        std::vector<Order> getBestAsks() const;
 
         // Lock-free statistics with [[nodiscard]]
         [[nodiscard]] size_t getTotalOrders() const noexcept { return totalOrders_.load(); }
         [[nodiscard]] size_t getTotalVolumeAtomic() const noexcept { return totalVolume_.load(); }
         [[nodiscard]] double getLastTradePrice() const noexcept { return lastTradePrice_.load(); }
+        [[nodiscard]] uint64_t getTotalTrades() const noexcept { return totalTrades_.load(std::memory_order_relaxed); }
 
-        // Modern C++17 features
-        void processOrdersInBatches(size_t batchSize = 100);
-        void enableAsyncProcessing(bool enable = true);
+        /**
+         * Drain the async queue on the calling thread, matching up to batchSize
+         * orders per lock acquisition. Returns the number of orders processed.
+         */
+        size_t processOrdersInBatches(size_t batchSize = 100);
+
+        /**
+         * Start or stop a background consumer that drains the async queue in
+         * batches of BookConfig::asyncBatchSize. Stopping drains what is left.
+         * Returns false if the book is owned by an engine thread.
+         */
+        bool enableAsyncProcessing(bool enable = true);
+
+        /**
+         * Journal every accepted command and fill from now on. Set while the
+         * book takes no traffic (creation or restart recovery); nullptr stops.
+         */
+        void setEventJournal(EventJournal *events) noexcept { events_ = events; }
+
+        // Copy the resting orders; on an engine-owned book, call on its thread
+        void capture(BookImage &image);
+
+        // Rest the image's orders on an empty book, without matching or journaling
+        bool restore(const BookImage &image);
 
     private:
-        std::vector<Trade> matchBuyOrder(std::shared_ptr<Order> order);
-        std::vector<Trade> matchSellOrder(std::shared_ptr<Order> order);
-        void removeOrderFromLevel(std::shared_ptr<Order> order);
-        void addOrderToLevel(std::shared_ptr<Order> order);
+        static constexpr size_t TRADE_RESERVE = 16;
+        static constexpr int ASYNC_IDLE_SPINS = 4096;
+
+        Order *createOrder(const OrderRequest &request);
+        bool restOrder(Order *order);
+        bool addLocked(const OrderRequest &request);
+        bool removeLocked(OrderHandle handle);
+        void amendLocked(Order &order, const OrderRequest &request);
+        bool crossesSpread(Side side, Price price);
+        void journalOrder(EventType type, const OrderRequest &request, uint8_t flags = 0);
+        void retireOrder(Order *order);
+        bool matchLocked(const OrderRequest &request, std::vector<Trade> &trades);
+        void matchAgainst(Order &order, BookSide &contra, std::vector<Trade> &trades);
+        MpscRing<AsyncOrder> &asyncQueue();
+        void wakeAsyncConsumer() noexcept;
+        size_t drainAsyncBatch(size_t batchSize);
+        void runAsyncConsumer();
+        void removeOrderFromLevel(Order *order);
+        void addOrderToLevel(Order *order);
+        void refreshBestPrices();
+        void publishDepth();
+        std::unique_lock<std::shared_mutex> writeLock()
+        {
+            return config_.synchronized ? std::unique_lock<std::shared_mutex>(orderBookMutex_)
+                                        : std::unique_lock<std::shared_mutex>();
+        }
+        BookSide &sideOf(const Order &order) { return order.side == Side::Buy ? *bids_ : *asks_; }
+        DepthTracker &depthOf(const BookSide &side) { return side.side() == Side::Buy ? bidDepth_ : askDepth_; }
     };
 
 } // namespace quantis
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <bit>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "Order.h"
+
+namespace quantis
+{
+
+    /**
+     * Open-addressing map from order handle to its resting record
+     *
+     * Linear probing over a power-of-two table of 16-byte slots, kept at most
+     * half full. Erase shifts the following cluster back instead of leaving
+     * tombstones, so probe lengths stay short under heavy cancel traffic.
+     * INVALID_ORDER_HANDLE marks an empty slot. Single-writer, like the book
+     * that owns it.
+     */
+    class OrderIndex
+    {
+    private:
+        struct Slot
+        {
+            OrderHandle handle{INVALID_ORDER_HANDLE};
+            Order *order{nullptr};
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        size_t mask_{0};
+        unsigned shift_{64};
+        size_t size_{0};
+
+        // Handles are sequential; Fibonacci hashing spreads them across the table
+        size_t home(OrderHandle handle) const noexcept
+        {
+            return static_cast<size_t>((handle * 0x9E3779B97F4A7C15ULL) >> shift_);
+        }
+
+        void rehash(size_t capacity)
+        {
+            std::unique_ptr<Slot[]> old = std::move(slots_);
+            size_t oldCapacity = old ? mask_ + 1 : 0;
+
+            slots_ = std::make_unique<Slot[]>(capacity);
+            mask_ = capacity - 1;
+            shift_ = static_cast<unsigned>(64 - std::countr_zero(capacity));
+            for (size_t i = 0; i < oldCapacity; ++i)
+            {
+                if (old[i].handle != INVALID_ORDER_HANDLE)
+                {
+                    size_t pos = home(old[i].handle);
+                    while (slots_[pos].handle != INVALID_ORDER_HANDLE)
+                    {
+                        pos = (pos + 1) & mask_;
+                    }
+                    slots_[pos] = old[i];
+                }
+            }
+        }
+
+    public:
+        explicit OrderIndex(size_t initialCapacity = 1024)
+        {
+            size_t capacity = 16;
+            while (capacity < initialCapacity)
+            {
+                capacity <<= 1;
+            }
+            rehash(capacity);
+        }
+
+        OrderIndex(const OrderIndex &) = delete;
+        OrderIndex &operator=(const OrderIndex &) = delete;
+
+        // False if the handle is already present
+        bool insert(OrderHandle handle, Order *order)
+        {
+            if (handle == INVALID_ORDER_HANDLE)
+            {
+                return false;
+            }
+            if ((size_ + 1) * 2 > mask_ + 1)
+            {
+                rehash((mask_ + 1) * 2);
+            }
+
+            size_t pos = home(handle);
+            while (slots_[pos].handle != INVALID_ORDER_HANDLE)
+            {
+                if (slots_[pos].handle == handle)
+                {
+                    return false;
+                }
+                pos = (pos + 1) & mask_;
+            }
+
+            slots_[pos].handle = handle;
+            slots_[pos].order = order;
+            ++size_;
+            return true;
+        }
+
+        Order *find(OrderHandle handle) const noexcept
+        {
+            size_t pos = home(handle);
+            while (slots_[pos].handle != INVALID_ORDER_HANDLE)
+            {
+                if (slots_[pos].handle == handle)
+                {
+                    return slots_[pos].order;
+                }
+                pos = (pos + 1) & mask_;
+            }
+            return nullptr;
+        }
+
+        bool contains(OrderHandle handle) const noexcept { return find(handle) != nullptr; }
+
+        bool erase(OrderHandle handle) noexcept
+        {
+            if (handle == INVALID_ORDER_HANDLE)
+            {
+                return false;
+            }
+            size_t pos = home(handle);
+            while (slots_[pos].handle != handle)
+            {
+                if (slots_[pos].handle == INVALID_ORDER_HANDLE)
+                {
+                    return false;
+                }
+                pos = (pos + 1) & mask_;
+            }
+
+            // Backward-shift deletion: pull later cluster members into the hole
+            size_t hole = pos;
+            for (size_t next = (hole + 1) & mask_; slots_[next].handle != INVALID_ORDER_HANDLE; next = (next + 1) & mask_)
+            {
+                size_t want = home(slots_[next].handle);
+                // Move next into the hole unless its home lies cyclically in (hole, next]
+                if (((next - want) & mask_) >= ((next - hole) & mask_))
+                {
+                    slots_[hole] = slots_[next];
+                    hole = next;
+                }
+            }
+
+            slots_[hole] = Slot{};
+            --size_;
+            return true;
+        }
+
+        size_t size() const noexcept { return size_; }
+        size_t capacity() const noexcept { return mask_ + 1; }
+    };
+
+} // namespace quantis
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace quantis
+{
+
+    /**
+     * Bounded multi-producer / single-consumer ring
+     *
+     * Each cell carries its own sequence number (Vyukov's bounded queue), so
+     * producers claim a slot with one CAS on the tail and publish it with a
+     * release store; the consumer never writes shared state other than the
+     * cell sequence. Capacity is rounded up to a power of two. T should be
+     * trivially copyable and small: cells are copied in and out by value.
+     */
+    template <typename T>
+    class MpscRing
+    {
+    private:
+        struct alignas(64) Cell
+        {
+            std::atomic<size_t> sequence{0};
+            T value{};
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        size_t mask_;
+
+        alignas(64) std::atomic<size_t> tail_{0}; // next slot producers claim
+        alignas(64) size_t head_{0};              // next slot the consumer reads
+
+        static size_t roundUp(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            return size;
+        }
+
+    public:
+        explicit MpscRing(size_t capacity)
+            : cells_(std::make_unique<Cell[]>(roundUp(capacity))), mask_(roundUp(capacity) - 1)
+        {
+            for (size_t i = 0; i <= mask_; ++i)
+            {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpscRing(const MpscRing &) = delete;
+        MpscRing &operator=(const MpscRing &) = delete;
+
+        // Any thread; false if the ring is full
+        bool tryPush(const T &value) noexcept
+        {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell &cell = cells_[pos & mask_];
+                size_t seq = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+                if (diff == 0)
+                {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.value = value;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Any thread; spins (yielding) until there is room
+        void push(const T &value) noexcept
+        {
+            while (!tryPush(value))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // Consumer thread only; false if the ring is empty
+        bool tryPop(T &out) noexcept
+        {
+            Cell &cell = cells_[head_ & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (seq != head_ + 1)
+            {
+                return false;
+            }
+
+            out = cell.value;
+            cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+            ++head_;
+            return true;
+        }
+
+        // Consumer thread only; true if nothing is published at the head
+        bool empty() const noexcept
+        {
+            return cells_[head_ & mask_].sequence.load(std::memory_order_acquire) != head_ + 1;
+        }
+
+        size_t capacity() const noexcept { return mask_ + 1; }
+    };
+
+    /**
+     * Bounded single-producer / single-consumer ring
+     *
+     * The producer owns tail_ and the consumer owns head_; each keeps a
+     * cached copy of the other's index so the shared line is only touched
+     * when the cached view says the ring looks full (or empty). Capacity is
+     * rounded up to a power of two.
+     */
+    template <typename T>
+    class SpscRing
+    {
+    private:
+        std::unique_ptr<T[]> slots_;
+        size_t mask_;
+
+        alignas(64) std::atomic<size_t> tail_{0}; // written by the producer
+        size_t cachedHead_{0};                    // producer's view of head_
+
+        alignas(64) std::atomic<size_t> head_{0}; // written by the consumer
+        size_t cachedTail_{0};                    // consumer's view of tail_
+
+    public:
+        explicit SpscRing(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            slots_ = std::make_unique<T[]>(size);
+            mask_ = size - 1;
+        }
+
+        SpscRing(const SpscRing &) = delete;
+        SpscRing &operator=(const SpscRing &) = delete;
+
+        // Producer thread only; false if the ring is full
+        bool tryPush(const T &value) noexcept
+        {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cachedHead_ > mask_)
+            {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+                if (tail - cachedHead_ > mask_)
+                {
+                    return false;
+                }
+            }
+
+            slots_[tail & mask_] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer thread only; false if the ring is empty
+        bool tryPop(T &out) noexcept
+        {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (head == cachedTail_)
+            {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                if (head == cachedTail_)
+                {
+                    return false;
+                }
+            }
+
+            out = slots_[head & mask_];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Either thread; a snapshot that may be stale by the time it returns
+        bool empty() const noexcept
+        {
+            return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+        }
+
+        size_t capacity() const noexcept { return mask_ + 1; }
+    };
+
+} // namespace quantis
@@ -0,0 +1,168 @@
+#include "RiskGate.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+namespace quantis
+{
+
+    namespace
+    {
+        double readDouble(const char *name, double fallback)
+        {
+            const char *value = std::getenv(name);
+            return value && *value ? std::strtod(value, nullptr) : fallback;
+        }
+
+        uint64_t intervalFor(double ordersPerSecond) noexcept
+        {
+            return ordersPerSecond > 0 ? std::max<uint64_t>(static_cast<uint64_t>(1e9 / ordersPerSecond), 1) : 0;
+        }
+    }
+
+    const char *riskRejectName(RiskReject reason) noexcept
+    {
+        switch (reason)
+        {
+        case RiskReject::None:
+            return "none";
+        case RiskReject::Halted:
+            return "halted";
+        case RiskReject::PriceBand:
+            return "priceBand";
+        case RiskReject::OrderQuantity:
+            return "orderQuantity";
+        case RiskReject::OrderNotional:
+            return "orderNotional";
+        case RiskReject::Position:
+            return "position";
+        case RiskReject::OrderRate:
+            return "orderRate";
+        case RiskReject::UnknownUser:
+            return "unknownUser";
+        case RiskReject::Count:
+            break;
+        }
+        return "unknown";
+    }
+
+    RiskConfig RiskConfig::fromEnvironment()
+    {
+        RiskConfig config;
+
+        if (const char *enabled = std::getenv("QUANTIS_RISK_ENABLED"))
+        {
+            config.enabled = std::strcmp(enabled, "0") != 0 && std::strcmp(enabled, "false") != 0;
+        }
+        if (const char *users = std::getenv("QUANTIS_RISK_MAX_USERS"))
+        {
+            config.maxUsers = static_cast<size_t>(std::strtoul(users, nullptr, 10));
+        }
+        config.priceBand = readDouble("QUANTIS_RISK_PRICE_BAND", config.priceBand);
+        config.haltBand = readDouble("QUANTIS_RISK_HALT_BAND", config.haltBand);
+
+        RiskLimits &limits = config.defaultLimits;
+        limits.maxOrderQuantity = static_cast<int64_t>(readDouble("QUANTIS_RISK_MAX_ORDER_QTY", 0));
+        limits.maxOrderNotional = readDouble("QUANTIS_RISK_MAX_ORDER_NOTIONAL", 0);
+        limits.maxPositionNotional = readDouble("QUANTIS_RISK_MAX_POSITION_NOTIONAL", 0);
+        limits.maxOrdersPerSecond = readDouble("QUANTIS_RISK_MAX_ORDERS_PER_S", 0);
+
+        return config;
+    }
+
+    RiskGate::RiskGate(const RiskConfig &config, MarketDataStore &store)
+        : config_(config), store_(store),
+          users_(std::make_unique<UserState[]>(config.maxUsers)),
+          halted_(std::make_unique<std::atomic<uint8_t>[]>(store.getSymbolCapacity()))
+    {
+        for (uint32_t i = 0; i < config_.maxUsers; ++i)
+        {
+            setLimits(i, config_.defaultLimits);
+        }
+    }
+
+    void RiskGate::onFills(const OrderBook &book, const Trade *trades, size_t count) noexcept
+    {
+        if (!config_.enabled || count == 0)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Trade &trade = trades[i];
+            double notional = book.fromTicks(trade.price) * static_cast<double>(trade.quantity);
+            double bought = trade.side == Side::Buy ? notional : -notional;
+            if (trade.userIndex < config_.maxUsers)
+            {
+                users_[trade.userIndex].netNotional.fetch_add(bought, std::memory_order_relaxed);
+            }
+            if (trade.restingUserIndex < config_.maxUsers)
+            {
+                users_[trade.restingUserIndex].netNotional.fetch_add(-bought, std::memory_order_relaxed);
+            }
+        }
+
+        // The fills are done; a print outside the halt band stops what comes next
+        MarketDataValues values;
+        if (config_.haltBand <= 0 || isHalted(book.getSymbolIndex()) ||
+            !store_.getMarketData(book.getSymbolIndex(), values) || values.lastPrice <= 0)
+        {
+            return;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            double price = book.fromTicks(trades[i].price);
+            if (std::abs(price - values.lastPrice) > config_.haltBand * values.lastPrice)
+            {
+                setHalted(book.getSymbolIndex(), true);
+                std::cerr << "Circuit breaker: halted " << book.getSymbol() << " after a fill at " << price
+                          << " against a last price of " << values.lastPrice << std::endl;
+                return;
+            }
+        }
+    }
+
+    bool RiskGate::setLimits(uint32_t userIndex, const RiskLimits &limits) noexcept
+    {
+        if (userIndex >= config_.maxUsers)
+        {
+            return false;
+        }
+
+        UserState &user = users_[userIndex];
+        user.maxOrderQuantity.store(limits.maxOrderQuantity, std::memory_order_relaxed);
+        user.maxOrderNotional.store(limits.maxOrderNotional, std::memory_order_relaxed);
+        user.maxPositionNotional.store(limits.maxPositionNotional, std::memory_order_relaxed);
+        user.orderIntervalNs.store(intervalFor(limits.maxOrdersPerSecond), std::memory_order_relaxed);
+        return true;
+    }
+
+    RiskLimits RiskGate::getLimits(uint32_t userIndex) const noexcept
+    {
+        RiskLimits limits;
+        if (userIndex >= config_.maxUsers)
+        {
+            return limits;
+        }
+
+        const UserState &user = users_[userIndex];
+        limits.maxOrderQuantity = user.maxOrderQuantity.load(std::memory_order_relaxed);
+        limits.maxOrderNotional = user.maxOrderNotional.load(std::memory_order_relaxed);
+        limits.maxPositionNotional = user.maxPositionNotional.load(std::memory_order_relaxed);
+        uint64_t interval = user.orderIntervalNs.load(std::memory_order_relaxed);
+        limits.maxOrdersPerSecond = interval ? 1e9 / static_cast<double>(interval) : 0.0;
+        return limits;
+    }
+
+    bool RiskGate::setHalted(uint32_t symbolIndex, bool halted) noexcept
+    {
+        if (symbolIndex >= store_.getSymbolCapacity())
+        {
+            return false;
+        }
+        halted_[symbolIndex].store(halted ? 1 : 0, std::memory_order_relaxed);
+        return true;
+    }
+
+} // namespace quantis
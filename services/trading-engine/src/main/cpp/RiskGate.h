@@ -0,0 +1,240 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <memory>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include "Order.h"
+#include "OrderBook.h"
+#include "MarketDataStore.h"
+#include "LatencyHistogram.h"
+
+namespace quantis
+{
+
+    // Why the pre-trade gate refused an order; travels in ResultRecord::reason
+    enum class RiskReject : uint8_t
+    {
+        None = 0,
+        Halted,        // the symbol's circuit breaker is tripped
+        PriceBand,     // limit price too far from the reference price (fat finger)
+        OrderQuantity, // single order above the user's quantity limit
+        OrderNotional, // single order above the user's notional limit
+        Position,      // would take the user's net filled notional past its limit
+        OrderRate,     // user is sending faster than its order rate
+        UnknownUser,   // user index beyond the risk table
+        Count
+    };
+
+    const char *riskRejectName(RiskReject reason) noexcept;
+
+    // Limits of one user; 0 disables a check
+    struct RiskLimits
+    {
+        int64_t maxOrderQuantity{0};
+        double maxOrderNotional{0.0};
+        double maxPositionNotional{0.0}; // bound on |bought - sold| notional, counting the order as filled
+        double maxOrdersPerSecond{0.0};  // new orders and amends, with up to one second's worth in a burst
+    };
+
+    struct RiskConfig
+    {
+        bool enabled{true};
+        size_t maxUsers{65536};   // user indices from here on are rejected
+        double priceBand{0.10};   // fat-finger band as a fraction of the reference price; 0 disables
+        double haltBand{0.0};     // a fill this far from the feed's last price halts the symbol; 0 disables
+        RiskLimits defaultLimits; // until the risk service pushes a user's own
+
+        // Reads QUANTIS_RISK_ENABLED, QUANTIS_RISK_MAX_USERS, QUANTIS_RISK_PRICE_BAND,
+        // QUANTIS_RISK_HALT_BAND, QUANTIS_RISK_MAX_ORDER_QTY, QUANTIS_RISK_MAX_ORDER_NOTIONAL,
+        // QUANTIS_RISK_MAX_POSITION_NOTIONAL and QUANTIS_RISK_MAX_ORDERS_PER_S
+        static RiskConfig fromEnvironment();
+    };
+
+    /**
+     * Pre-trade risk checks run by the engine ahead of matching
+     *
+     * Every check is a handful of relaxed loads from the user's cache line
+     * and the symbol's halt flag, so the gate adds tens of nanoseconds rather
+     * than a network hop. Users are addressed by their interned index, so the
+     * table is a flat array. Fills feed the per-user net notional back with
+     * atomic adds from whichever thread matched them. Limits and halts may be
+     * changed from any thread at any time, typically as the risk service
+     * pushes them; a check running concurrently sees either value.
+     *
+     * Exposure counts fills only, from engine start: resting orders are
+     * bounded by the per-order and rate limits, not by the position limit,
+     * and the risk service's limits should allow for positions carried over.
+     */
+    class RiskGate
+    {
+    private:
+        static constexpr uint64_t BURST_WINDOW_NS = 1'000'000'000;
+
+        struct alignas(64) UserState
+        {
+            std::atomic<int64_t> maxOrderQuantity{0};
+            std::atomic<double> maxOrderNotional{0.0};
+            std::atomic<double> maxPositionNotional{0.0};
+            std::atomic<uint64_t> orderIntervalNs{0}; // 1 / rate; 0 = unthrottled
+
+            std::atomic<double> netNotional{0.0};   // bought minus sold, from fills
+            std::atomic<uint64_t> nextArrivalNs{0}; // rate limiter: theoretical arrival time (GCRA)
+        };
+
+        RiskConfig config_;
+        MarketDataStore &store_;
+        std::unique_ptr<UserState[]> users_;
+        std::unique_ptr<std::atomic<uint8_t>[]> halted_; // by symbol index
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(RiskReject::Count)> rejects_{};
+        LatencyHistogram &latency_{latencyHistogram(LatencyMetric::RiskCheck)};
+
+        // Feed's last price, or the book's own last trade before the feed has one
+        double referencePrice(const OrderBook &book) const noexcept
+        {
+            MarketDataValues values;
+            if (store_.getMarketData(book.getSymbolIndex(), values) && values.lastPrice > 0)
+            {
+                return values.lastPrice;
+            }
+            return book.getLastTradePrice();
+        }
+
+        // Generic cell rate algorithm: one CAS, no timer thread
+        static bool admit(UserState &user, uint64_t intervalNs) noexcept
+        {
+            uint64_t now = nowNanos();
+            uint64_t tolerance = BURST_WINDOW_NS > intervalNs ? BURST_WINDOW_NS - intervalNs : 0;
+            uint64_t next = user.nextArrivalNs.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                if (next > now + tolerance)
+                {
+                    return false;
+                }
+                if (user.nextArrivalNs.compare_exchange_weak(next, std::max(next, now) + intervalNs, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+        }
+
+        RiskReject evaluate(const OrderBook &book, const OrderRequest &request) noexcept
+        {
+            if (halted_[book.getSymbolIndex()].load(std::memory_order_relaxed))
+            {
+                return RiskReject::Halted;
+            }
+            if (request.userIndex >= config_.maxUsers)
+            {
+                return RiskReject::UnknownUser;
+            }
+
+            UserState &user = users_[request.userIndex];
+            int64_t maxQuantity = user.maxOrderQuantity.load(std::memory_order_relaxed);
+            if (maxQuantity > 0 && request.quantity > maxQuantity)
+            {
+                return RiskReject::OrderQuantity;
+            }
+
+            double notional = request.price * static_cast<double>(request.quantity);
+            double maxNotional = user.maxOrderNotional.load(std::memory_order_relaxed);
+            if (maxNotional > 0 && notional > maxNotional)
+            {
+                return RiskReject::OrderNotional;
+            }
+
+            double maxPosition = user.maxPositionNotional.load(std::memory_order_relaxed);
+            if (maxPosition > 0)
+            {
+                // Orders that reduce the exposure always pass
+                double net = user.netNotional.load(std::memory_order_relaxed);
+                double projected = net + (request.side == Side::Buy ? notional : -notional);
+                if (std::abs(projected) > maxPosition && std::abs(projected) > std::abs(net))
+                {
+                    return RiskReject::Position;
+                }
+            }
+
+            if (config_.priceBand > 0)
+            {
+                double reference = referencePrice(book);
+                if (reference > 0 && std::abs(request.price - reference) > config_.priceBand * reference)
+                {
+                    return RiskReject::PriceBand;
+                }
+            }
+
+            // Last, so an order refused above does not use up the user's rate
+            uint64_t interval = user.orderIntervalNs.load(std::memory_order_relaxed);
+            if (interval > 0 && !admit(user, interval))
+            {
+                return RiskReject::OrderRate;
+            }
+            return RiskReject::None;
+        }
+
+    public:
+        explicit RiskGate(const RiskConfig &config, MarketDataStore &store = getMarketDataStore());
+
+        RiskGate(const RiskGate &) = delete;
+        RiskGate &operator=(const RiskGate &) = delete;
+
+        bool isEnabled() const noexcept { return config_.enabled; }
+        const RiskConfig &getConfig() const noexcept { return config_; }
+
+        /**
+         * Check a new order or an amend (its new price and quantity) bound
+         * for book. Any thread, lock-free; an admitted order counts against
+         * the user's order rate.
+         */
+        RiskReject check(const OrderBook &book, const OrderRequest &request) noexcept
+        {
+            if (!config_.enabled)
+            {
+                return RiskReject::None;
+            }
+
+            LatencyScope timer(latency_);
+            RiskReject reason = evaluate(book, request);
+            if (reason != RiskReject::None)
+            {
+                rejects_[static_cast<size_t>(reason)].fetch_add(1, std::memory_order_relaxed);
+            }
+            return reason;
+        }
+
+        // Apply fills from book to both parties' exposure, tripping the halt band if set
+        void onFills(const OrderBook &book, const Trade *trades, size_t count) noexcept;
+
+        // Replace a user's limits; false if the index is beyond the table
+        bool setLimits(uint32_t userIndex, const RiskLimits &limits) noexcept;
+        RiskLimits getLimits(uint32_t userIndex) const noexcept;
+
+        // Bought minus sold notional of a user's fills so far
+        double getNetNotional(uint32_t userIndex) const noexcept
+        {
+            return userIndex < config_.maxUsers ? users_[userIndex].netNotional.load(std::memory_order_relaxed) : 0.0;
+        }
+
+        /**
+         * Circuit breaker: a halted symbol refuses new orders and amends
+         * until it is resumed; cancels still go through
+         */
+        bool setHalted(uint32_t symbolIndex, bool halted) noexcept;
+
+        bool isHalted(uint32_t symbolIndex) const noexcept
+        {
+            return symbolIndex < store_.getSymbolCapacity() && halted_[symbolIndex].load(std::memory_order_relaxed);
+        }
+
+        uint64_t getRejectCount(RiskReject reason) const noexcept
+        {
+            return rejects_[static_cast<size_t>(reason)].load(std::memory_order_relaxed);
+        }
+    };
+
+} // namespace quantis
@@ -0,0 +1,137 @@
+#include "SharedMemoryRegion.h"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace quantis
+{
+
+    namespace
+    {
+        int openObject(const std::string &name, int flags, bool filePath)
+        {
+            return filePath ? ::open(name.c_str(), flags, 0644) : ::shm_open(name.c_str(), flags, 0644);
+        }
+
+        void logError(const char *what, const std::string &name)
+        {
+            std::cerr << "SharedMemoryRegion " << what << " failed for " << name << ": " << std::strerror(errno) << std::endl;
+        }
+    }
+
+    SharedMemoryRegion::~SharedMemoryRegion()
+    {
+        if (data_)
+        {
+            ::munmap(data_, size_);
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::openOrCreate(const std::string &name, size_t size)
+    {
+        std::unique_ptr<SharedMemoryRegion> region(new SharedMemoryRegion());
+        region->name_ = name;
+        region->hugePageFile_ = isFilePath(name);
+        if (region->hugePageFile_)
+        {
+            size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        }
+
+        region->fd_ = openObject(name, O_RDWR | O_CREAT | O_EXCL, region->hugePageFile_);
+        region->created_ = region->fd_ >= 0;
+        if (!region->created_ && errno == EEXIST)
+        {
+            region->fd_ = openObject(name, O_RDWR, region->hugePageFile_);
+        }
+        if (region->fd_ < 0)
+        {
+            logError("open", name);
+            return nullptr;
+        }
+
+        struct stat info;
+        if (::fstat(region->fd_, &info) != 0)
+        {
+            logError("fstat", name);
+            return nullptr;
+        }
+
+        // Grow (never shrink) an existing object to the requested size
+        if (static_cast<size_t>(info.st_size) < size && ::ftruncate(region->fd_, static_cast<off_t>(size)) != 0)
+        {
+            logError("ftruncate", name);
+            return nullptr;
+        }
+        region->size_ = std::max(size, static_cast<size_t>(info.st_size));
+
+        void *data = ::mmap(nullptr, region->size_, PROT_READ | PROT_WRITE, MAP_SHARED, region->fd_, 0);
+        if (data == MAP_FAILED)
+        {
+            logError("mmap", name);
+            return nullptr;
+        }
+        region->data_ = data;
+
+#ifdef MADV_HUGEPAGE
+        if (!region->hugePageFile_)
+        {
+            // Best effort: transparent huge pages for shmem when the kernel allows it
+            ::madvise(data, region->size_, MADV_HUGEPAGE);
+        }
+#endif
+        return region;
+    }
+
+    void SharedMemoryRegion::clear() noexcept
+    {
+#ifdef MADV_REMOVE
+        // Punches the pages out of the object, so it reads back as zeros without being written
+        if (::madvise(data_, size_, MADV_REMOVE) == 0)
+        {
+            return;
+        }
+#endif
+        std::memset(data_, 0, size_);
+    }
+
+    std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::openReadOnly(const std::string &name)
+    {
+        std::unique_ptr<SharedMemoryRegion> region(new SharedMemoryRegion());
+        region->name_ = name;
+        region->hugePageFile_ = isFilePath(name);
+
+        region->fd_ = openObject(name, O_RDONLY, region->hugePageFile_);
+        if (region->fd_ < 0)
+        {
+            logError("open", name);
+            return nullptr;
+        }
+
+        struct stat info;
+        if (::fstat(region->fd_, &info) != 0 || info.st_size <= 0)
+        {
+            logError("fstat", name);
+            return nullptr;
+        }
+        region->size_ = static_cast<size_t>(info.st_size);
+
+        void *data = ::mmap(nullptr, region->size_, PROT_READ, MAP_SHARED, region->fd_, 0);
+        if (data == MAP_FAILED)
+        {
+            logError("mmap", name);
+            return nullptr;
+        }
+        region->data_ = data;
+        return region;
+    }
+
+} // namespace quantis
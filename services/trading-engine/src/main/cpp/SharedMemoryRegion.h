@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <cstddef>
+
+namespace quantis
+{
+
+    /**
+     * A named memory mapping shared between processes on one node
+     *
+     * A plain name ("/quantis-md") is a POSIX shared-memory object under
+     * /dev/shm. A path with further slashes ("/dev/hugepages/quantis-md") is
+     * a regular file, typically on hugetlbfs; its size is rounded up to a
+     * 2 MiB huge page. The mapping is released on destruction but the object
+     * itself persists so readers can outlive the writer.
+     */
+    class SharedMemoryRegion
+    {
+    private:
+        std::string name_;
+        void *data_{nullptr};
+        size_t size_{0};
+        int fd_{-1};
+        bool created_{false};
+        bool hugePageFile_{false};
+
+        SharedMemoryRegion() = default;
+
+    public:
+        static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+        ~SharedMemoryRegion();
+
+        SharedMemoryRegion(const SharedMemoryRegion &) = delete;
+        SharedMemoryRegion &operator=(const SharedMemoryRegion &) = delete;
+
+        /**
+         * Map name read-write, creating it with at least size bytes if needed.
+         * Returns nullptr (and logs why) on failure.
+         */
+        static std::unique_ptr<SharedMemoryRegion> openOrCreate(const std::string &name, size_t size);
+
+        /**
+         * Map an existing object read-only. Returns nullptr on failure.
+         */
+        static std::unique_ptr<SharedMemoryRegion> openReadOnly(const std::string &name);
+
+        static bool isFilePath(const std::string &name) { return name.find('/', 1) != std::string::npos; }
+
+        // Zero-fill a read-write mapping, releasing its pages to the kernel where it can
+        void clear() noexcept;
+
+        void *data() const noexcept { return data_; }
+        size_t size() const noexcept { return size_; }
+        const std::string &name() const noexcept { return name_; }
+
+        // True if this call created the object (its contents are zero-filled)
+        bool created() const noexcept { return created_; }
+        bool isHugePageFile() const noexcept { return hugePageFile_; }
+    };
+
+} // namespace quantis
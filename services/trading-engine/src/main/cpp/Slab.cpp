@@ -0,0 +1,111 @@
+#include "Slab.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sys/mman.h>
+
+namespace quantis
+{
+
+    namespace
+    {
+        constexpr size_t HUGE_PAGE_BYTES = size_t{2} << 20;
+
+        size_t roundUp(size_t value, size_t multiple)
+        {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+    }
+
+    BlockPool::BlockPool(size_t blockSize, size_t alignment, size_t chunkBlocks, bool hugePages)
+        : alignment_(std::max(alignment, alignof(FreeBlock))),
+          chunkBlocks_(std::max<size_t>(chunkBlocks, 1)),
+          hugePages_(hugePages)
+    {
+        blockSize_ = roundUp(std::max(blockSize, sizeof(FreeBlock)), alignment_);
+    }
+
+    BlockPool::~BlockPool()
+    {
+        for (const Chunk &chunk : chunks_)
+        {
+            if (chunk.mapped)
+            {
+                ::munmap(chunk.memory, chunk.bytes);
+            }
+            else
+            {
+                std::free(chunk.memory);
+            }
+        }
+    }
+
+    void BlockPool::grow()
+    {
+        Chunk chunk{nullptr, roundUp(blockSize_ * chunkBlocks_, 64), false};
+        bool onHugePages = false;
+
+        if (hugePages_)
+        {
+            // Reserved huge pages if the kernel has any, else ask for transparent ones
+            chunk.bytes = roundUp(chunk.bytes, HUGE_PAGE_BYTES);
+#ifdef MAP_HUGETLB
+            void *memory = ::mmap(nullptr, chunk.bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            onHugePages = memory != MAP_FAILED;
+#else
+            void *memory = MAP_FAILED;
+#endif
+            if (memory == MAP_FAILED)
+            {
+                memory = ::mmap(nullptr, chunk.bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+                if (memory != MAP_FAILED)
+                {
+                    ::madvise(memory, chunk.bytes, MADV_HUGEPAGE);
+                }
+#endif
+            }
+            if (memory != MAP_FAILED)
+            {
+                chunk.memory = memory;
+                chunk.mapped = true;
+            }
+        }
+
+        if (!chunk.memory)
+        {
+            chunk.bytes = roundUp(blockSize_ * chunkBlocks_, 64);
+            chunk.memory = std::aligned_alloc(64, chunk.bytes);
+            if (!chunk.memory)
+            {
+                throw std::bad_alloc();
+            }
+        }
+        chunks_.push_back(chunk);
+
+        // Thread the new blocks onto the free list in address order
+        size_t blocks = chunk.bytes / blockSize_;
+        auto *base = static_cast<unsigned char *>(chunk.memory);
+        for (size_t i = blocks; i-- > 0;)
+        {
+            auto *block = reinterpret_cast<FreeBlock *>(base + i * blockSize_);
+            block->next = freeList_;
+            freeList_ = block;
+        }
+
+        capacity_.store(capacity_.load(std::memory_order_relaxed) + blocks, std::memory_order_relaxed);
+        reservedBytes_.store(reservedBytes_.load(std::memory_order_relaxed) + chunk.bytes, std::memory_order_relaxed);
+        if (onHugePages)
+        {
+            hugePageBytes_.store(hugePageBytes_.load(std::memory_order_relaxed) + chunk.bytes, std::memory_order_relaxed);
+        }
+    }
+
+    void BlockPool::reserve(size_t blocks)
+    {
+        while (capacity() - inUse() < blocks)
+        {
+            grow();
+        }
+    }
+
+} // namespace quantis
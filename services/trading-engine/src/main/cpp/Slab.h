@@ -0,0 +1,184 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace quantis
+{
+
+    /**
+     * Untyped pool of fixed-size blocks with an intrusive free list
+     *
+     * Blocks are carved out of chunks that are never returned to the system
+     * before the pool goes, so addresses stay stable for intrusive links and
+     * steady-state allocate/deallocate is a pointer swap. reserve() grows the
+     * pool up front so a book does not grow it on the hot path. With huge
+     * pages, chunks are rounded up to 2 MiB and mapped with MAP_HUGETLB,
+     * falling back to transparent huge pages and then to normal pages.
+     *
+     * Not thread-safe: each pool belongs to a single owner (one order book).
+     * The occupancy counters may be read from any thread.
+     */
+    class BlockPool
+    {
+    private:
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        };
+
+        struct Chunk
+        {
+            void *memory;
+            size_t bytes;
+            bool mapped; // mmap rather than aligned_alloc
+        };
+
+        size_t blockSize_;
+        size_t alignment_;
+        size_t chunkBlocks_;
+        bool hugePages_;
+        std::vector<Chunk> chunks_;
+        FreeBlock *freeList_{nullptr};
+
+        std::atomic<size_t> inUse_{0};
+        std::atomic<size_t> capacity_{0};
+        std::atomic<size_t> reservedBytes_{0};
+        std::atomic<size_t> hugePageBytes_{0}; // part of reservedBytes_ known to be on huge pages
+
+        // Add one chunk of at least chunkBlocks_ blocks to the free list
+        void grow();
+
+    public:
+        /**
+         * @param blockSize bytes per block (rounded up to alignment)
+         * @param alignment block alignment, a power of two up to 64
+         * @param chunkBlocks blocks per chunk; huge-page chunks hold as many as fit in 2 MiB multiples
+         */
+        BlockPool(size_t blockSize, size_t alignment, size_t chunkBlocks = 4096, bool hugePages = false);
+        ~BlockPool();
+
+        BlockPool(const BlockPool &) = delete;
+        BlockPool &operator=(const BlockPool &) = delete;
+
+        void *allocate()
+        {
+            if (!freeList_)
+            {
+                grow();
+            }
+
+            FreeBlock *block = freeList_;
+            freeList_ = block->next;
+            inUse_.store(inUse_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return block;
+        }
+
+        void deallocate(void *memory) noexcept
+        {
+            auto *block = static_cast<FreeBlock *>(memory);
+            block->next = freeList_;
+            freeList_ = block;
+            inUse_.store(inUse_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        }
+
+        // Grow until at least blocks are available without further allocation
+        void reserve(size_t blocks);
+
+        size_t blockSize() const noexcept { return blockSize_; }
+        size_t alignment() const noexcept { return alignment_; }
+        size_t inUse() const noexcept { return inUse_.load(std::memory_order_relaxed); }
+        size_t capacity() const noexcept { return capacity_.load(std::memory_order_relaxed); }
+        size_t reservedBytes() const noexcept { return reservedBytes_.load(std::memory_order_relaxed); }
+        size_t hugePageBytes() const noexcept { return hugePageBytes_.load(std::memory_order_relaxed); }
+    };
+
+    /**
+     * Fixed-size object slab: a BlockPool of T-sized blocks
+     */
+    template <typename T, size_t ChunkSize = 4096>
+    class Slab
+    {
+    private:
+        BlockPool pool_;
+
+    public:
+        explicit Slab(bool hugePages = false) : pool_(sizeof(T), alignof(T), ChunkSize, hugePages) {}
+        Slab(const Slab &) = delete;
+        Slab &operator=(const Slab &) = delete;
+
+        template <typename... Args>
+        T *create(Args &&...args)
+        {
+            return ::new (pool_.allocate()) T(std::forward<Args>(args)...);
+        }
+
+        void destroy(T *object) noexcept
+        {
+            object->~T();
+            pool_.deallocate(object);
+        }
+
+        void reserve(size_t objects) { pool_.reserve(objects); }
+
+        const BlockPool &pool() const noexcept { return pool_; }
+        size_t inUse() const noexcept { return pool_.inUse(); }
+        size_t capacity() const noexcept { return pool_.capacity(); }
+    };
+
+    /**
+     * Standard allocator drawing single objects from a BlockPool
+     *
+     * For node-based containers: each node is one allocate(1) of the rebound
+     * node type. Requests the pool's blocks cannot hold (arrays, or a type
+     * larger than a block) and a null pool fall back to std::allocator, so the
+     * block size only needs to cover the node. Allocators compare equal when
+     * they share a pool.
+     */
+    template <typename T>
+    class PoolAllocator
+    {
+    private:
+        BlockPool *pool_;
+
+        bool fits(size_t n) const noexcept
+        {
+            return pool_ && n == 1 && sizeof(T) <= pool_->blockSize() && alignof(T) <= pool_->alignment();
+        }
+
+    public:
+        using value_type = T;
+
+        explicit PoolAllocator(BlockPool *pool = nullptr) noexcept : pool_(pool) {}
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U> &other) noexcept : pool_(other.pool()) {}
+
+        T *allocate(size_t n)
+        {
+            return fits(n) ? static_cast<T *>(pool_->allocate()) : std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T *object, size_t n) noexcept
+        {
+            if (fits(n))
+            {
+                pool_->deallocate(object);
+            }
+            else
+            {
+                std::allocator<T>{}.deallocate(object, n);
+            }
+        }
+
+        BlockPool *pool() const noexcept { return pool_; }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U> &other) const noexcept { return pool_ == other.pool(); }
+    };
+
+} // namespace quantis
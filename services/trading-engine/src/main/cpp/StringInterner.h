@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <cstdint>
+
+namespace quantis
+{
+
+    /**
+     * Maps strings (user IDs) to dense 32-bit indices and back
+     *
+     * Used at the JNI boundary so the engine only ever handles integers.
+     * Indices are never recycled; 0 is reserved for "unknown".
+     */
+    class StringInterner
+    {
+    private:
+        mutable std::shared_mutex mutex_;
+        std::unordered_map<std::string, uint32_t> indices_;
+        std::vector<std::string> names_{std::string()};
+
+    public:
+        uint32_t intern(const std::string &name)
+        {
+            bool created;
+            return intern(name, created);
+        }
+
+        // Same, reporting whether this call assigned the index
+        uint32_t intern(const std::string &name, bool &created)
+        {
+            created = false;
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex_);
+                auto it = indices_.find(name);
+                if (it != indices_.end())
+                {
+                    return it->second;
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            auto [it, inserted] = indices_.try_emplace(name, static_cast<uint32_t>(names_.size()));
+            if (inserted)
+            {
+                names_.push_back(name);
+                created = true;
+            }
+            return it->second;
+        }
+
+        // Index for name, or 0 if it was never interned
+        uint32_t find(const std::string &name) const
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = indices_.find(name);
+            return it != indices_.end() ? it->second : 0;
+        }
+
+        std::string name(uint32_t index) const
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            return index < names_.size() ? names_[index] : std::string();
+        }
+
+        // Every interned string, in index order starting at index 1
+        std::vector<std::string> names() const
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            return std::vector<std::string>(names_.begin() + 1, names_.end());
+        }
+
+        size_t size() const
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            return names_.size() - 1;
+        }
+    };
+
+} // namespace quantis
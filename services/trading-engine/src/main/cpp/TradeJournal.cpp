@@ -0,0 +1,126 @@
+#include "TradeJournal.h"
+#include <algorithm>
+#include <bit>
+
+namespace quantis
+{
+
+    TradeJournal::TradeJournal(uint32_t id, size_t capacity, bool multiWriter)
+        : id_(id), multiWriter_(multiWriter)
+    {
+        size_t size = std::bit_ceil(std::max<size_t>(capacity, 2));
+        mask_ = size - 1;
+
+        // Twice as many buckets as records keeps collision chains short
+        size_t buckets = size * 2;
+        bucketShift_ = 64u - static_cast<unsigned>(std::countr_zero(buckets));
+
+        records_ = std::make_unique<Record[]>(size);
+        meta_ = std::make_unique<SlotMeta[]>(size);
+        heads_ = std::make_unique<std::atomic<uint64_t>[]>(buckets);
+        for (size_t i = 0; i < buckets; ++i)
+        {
+            heads_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool TradeJournal::fetch(uint64_t sequence, Trade &trade, uint64_t &prevByAggressor, uint64_t &prevByResting) const noexcept
+    {
+        const SlotMeta &meta = meta_[sequence & mask_];
+        const Record &record = records_[sequence & mask_];
+        if (meta.sequence.load(std::memory_order_acquire) != sequence)
+        {
+            return false;
+        }
+
+        uint64_t words[WORDS];
+        for (size_t i = 0; i < WORDS; ++i)
+        {
+            words[i] = record.words[i].load(std::memory_order_relaxed);
+        }
+        prevByAggressor = meta.prevByAggressor.load(std::memory_order_relaxed);
+        prevByResting = meta.prevByResting.load(std::memory_order_relaxed);
+
+        // Valid only if the writer did not start reusing the slot while we copied
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (meta.sequence.load(std::memory_order_relaxed) != sequence)
+        {
+            return false;
+        }
+        std::memcpy(&trade, words, sizeof(Trade));
+        return true;
+    }
+
+    size_t TradeJournal::tradesFor(OrderHandle handle, std::vector<Trade> &out) const
+    {
+        size_t first = out.size();
+        size_t bucket = bucketFor(handle);
+        uint64_t sequence = heads_[bucket].load(std::memory_order_acquire);
+
+        Trade trade;
+        uint64_t prevByAggressor;
+        uint64_t prevByResting;
+        while (sequence != 0 && fetch(sequence, trade, prevByAggressor, prevByResting))
+        {
+            if (trade.orderHandle == handle || trade.restingHandle == handle)
+            {
+                out.push_back(trade);
+            }
+
+            // Follow the link for whichever side of this record hashed into our bucket
+            uint64_t previous = bucketFor(trade.orderHandle) == bucket ? prevByAggressor : prevByResting;
+            if (previous >= sequence)
+            {
+                break;
+            }
+            sequence = previous;
+        }
+
+        std::reverse(out.begin() + static_cast<std::ptrdiff_t>(first), out.end());
+        return out.size() - first;
+    }
+
+    void TradeJournal::advanceSequence(uint64_t sequence) noexcept
+    {
+        if (multiWriter_)
+        {
+            while (writeLock_.exchange(true, std::memory_order_acquire))
+            {
+                cpuRelax();
+            }
+        }
+
+        if (sequence > lastSequence_)
+        {
+            lastSequence_ = sequence;
+            published_.store(sequence, std::memory_order_release);
+        }
+
+        if (multiWriter_)
+        {
+            writeLock_.store(false, std::memory_order_release);
+        }
+    }
+
+    uint64_t TradeJournal::readSince(uint64_t afterSequence, std::vector<Trade> &out, size_t max) const
+    {
+        uint64_t published = published_.load(std::memory_order_acquire);
+        uint64_t oldest = published > capacity() ? published - capacity() + 1 : 1;
+        uint64_t sequence = std::max(afterSequence + 1, oldest);
+
+        Trade trade;
+        uint64_t prevByAggressor;
+        uint64_t prevByResting;
+        for (size_t read = 0; sequence <= published && read < max; ++sequence)
+        {
+            // A failed fetch means the writer lapped us; that record is gone
+            if (fetch(sequence, trade, prevByAggressor, prevByResting))
+            {
+                out.push_back(trade);
+                ++read;
+            }
+        }
+        return std::max(afterSequence, sequence - 1);
+    }
+
+} // namespace quantis
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "Order.h"
+#include "CpuRelax.h"
+#include "TradeRing.h"
+
+namespace quantis
+{
+
+    // Trade IDs: journal (shard) ID in the top bits, that journal's sequence below
+    inline constexpr unsigned TRADE_SEQUENCE_BITS = 48;
+
+    constexpr uint64_t makeTradeId(uint32_t journalId, uint64_t sequence) noexcept
+    {
+        return (static_cast<uint64_t>(journalId) << TRADE_SEQUENCE_BITS) | sequence;
+    }
+
+    constexpr uint32_t tradeJournalId(uint64_t tradeId) noexcept
+    {
+        return static_cast<uint32_t>(tradeId >> TRADE_SEQUENCE_BITS);
+    }
+
+    constexpr uint64_t tradeSequence(uint64_t tradeId) noexcept
+    {
+        return tradeId & ((uint64_t{1} << TRADE_SEQUENCE_BITS) - 1);
+    }
+
+    /**
+     * Append-only in-memory trade journal
+     *
+     * A preallocated ring of Trade records numbered 1, 2, 3, ... that keeps
+     * the most recent capacity() fills. Each slot is a small seqlock, so any
+     * thread can read while the writer appends, and a record overwritten mid
+     * read is detected rather than returned torn.
+     *
+     * Records are also chained by order handle: a bucket table keyed on the
+     * handle's hash points at the newest record touching that bucket, and
+     * every record links back to the previous one for its aggressor's bucket
+     * and for its resting order's bucket. tradesFor() walks that chain, so a
+     * lookup costs O(k) for k fills plus the occasional hash collision, and
+     * naturally stops at the oldest record still in the ring.
+     *
+     * There is one writer at a time: an engine shard's journal is written
+     * only by that shard's thread. With multiWriter set (inline engines,
+     * where books on many threads share one journal) appends take a spinlock.
+     * A journal with an output ring also publishes every append to it, from
+     * inside that single-writer section, so the ring has one producer.
+     */
+    class TradeJournal
+    {
+    private:
+        static constexpr size_t WORDS = sizeof(Trade) / sizeof(uint64_t);
+
+        struct alignas(64) Record
+        {
+            std::atomic<uint64_t> words[WORDS];
+        };
+
+        struct SlotMeta
+        {
+            std::atomic<uint64_t> sequence{0};        // 0 while being written
+            std::atomic<uint64_t> prevByAggressor{0}; // previous record in the aggressor's bucket
+            std::atomic<uint64_t> prevByResting{0};   // previous record in the resting order's bucket
+        };
+
+        uint32_t id_;
+        size_t mask_;
+        unsigned bucketShift_;
+        bool multiWriter_;
+        std::unique_ptr<Record[]> records_;
+        std::unique_ptr<SlotMeta[]> meta_;
+        std::unique_ptr<std::atomic<uint64_t>[]> heads_; // bucket -> newest sequence
+
+        alignas(64) std::atomic<bool> writeLock_{false};
+        uint64_t lastSequence_{0}; // writer only
+        TradeRing *output_{nullptr};
+        alignas(64) std::atomic<uint64_t> published_{0};
+
+        size_t bucketFor(OrderHandle handle) const noexcept
+        {
+            return static_cast<size_t>((handle * 0x9E3779B97F4A7C15ull) >> bucketShift_);
+        }
+
+        // Copy out one record if it still holds sequence; fills the chain links too
+        bool fetch(uint64_t sequence, Trade &trade, uint64_t &prevByAggressor, uint64_t &prevByResting) const noexcept;
+
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 65536;
+
+        explicit TradeJournal(uint32_t id, size_t capacity = DEFAULT_CAPACITY, bool multiWriter = false);
+
+        TradeJournal(const TradeJournal &) = delete;
+        TradeJournal &operator=(const TradeJournal &) = delete;
+
+        /**
+         * Number the trade (sets trade.tradeId) and append it, publishing it
+         * to the output ring with its price converted by tickSize. Returns
+         * its sequence.
+         */
+        uint64_t append(Trade &trade, double tickSize) noexcept
+        {
+            if (multiWriter_)
+            {
+                while (writeLock_.exchange(true, std::memory_order_acquire))
+                {
+                    cpuRelax();
+                }
+            }
+
+            uint64_t sequence = ++lastSequence_;
+            trade.tradeId = makeTradeId(id_, sequence);
+
+            SlotMeta &meta = meta_[sequence & mask_];
+            Record &record = records_[sequence & mask_];
+            meta.sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            uint64_t words[WORDS];
+            std::memcpy(words, &trade, sizeof(Trade));
+            for (size_t i = 0; i < WORDS; ++i)
+            {
+                record.words[i].store(words[i], std::memory_order_relaxed);
+            }
+
+            size_t aggressorBucket = bucketFor(trade.orderHandle);
+            size_t restingBucket = bucketFor(trade.restingHandle);
+            meta.prevByAggressor.store(heads_[aggressorBucket].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            meta.prevByResting.store(heads_[restingBucket].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            meta.sequence.store(sequence, std::memory_order_release);
+
+            heads_[aggressorBucket].store(sequence, std::memory_order_release);
+            heads_[restingBucket].store(sequence, std::memory_order_release);
+            published_.store(sequence, std::memory_order_release);
+
+            if (output_)
+            {
+                output_->push(trade, tickSize);
+            }
+
+            if (multiWriter_)
+            {
+                writeLock_.store(false, std::memory_order_release);
+            }
+            return sequence;
+        }
+
+        /**
+         * Append every retained fill of handle (as aggressor or resting order),
+         * oldest first. Returns the number appended.
+         */
+        size_t tradesFor(OrderHandle handle, std::vector<Trade> &out) const;
+
+        /**
+         * Append up to max records with sequence > afterSequence, oldest first.
+         * Returns the sequence to pass next time. Records already overwritten
+         * are skipped; a gap shows as the first record's tradeSequence() being
+         * above afterSequence + 1.
+         */
+        uint64_t readSince(uint64_t afterSequence, std::vector<Trade> &out, size_t max) const;
+
+        /**
+         * Continue numbering after sequence (restart recovery), so trade IDs
+         * issued before a restart are never reused. Writer context only.
+         */
+        void advanceSequence(uint64_t sequence) noexcept;
+
+        /**
+         * Publish every append from now on to ring (nullptr stops). Set it
+         * before the writer starts; the ring must outlive the journal's use.
+         */
+        void setOutput(TradeRing *ring) noexcept { output_ = ring; }
+        TradeRing *output() const noexcept { return output_; }
+
+        // Newest published sequence (0 before the first trade)
+        uint64_t lastSequence() const noexcept { return published_.load(std::memory_order_acquire); }
+
+        uint32_t id() const noexcept { return id_; }
+        size_t capacity() const noexcept { return mask_ + 1; }
+    };
+
+} // namespace quantis
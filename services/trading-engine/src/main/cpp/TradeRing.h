@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include "Order.h"
+#include "BatchProtocol.h"
+
+namespace quantis
+{
+
+    /**
+     * Fill as published to the trade output ring
+     *
+     * Fixed layout, native-endian, mirrored in TradingEngineJNI.java like the
+     * batch records: symbols and users travel as their interned indices and
+     * orders as handles, and the price is already converted from ticks.
+     */
+    struct TradeRecord
+    {
+        uint64_t tradeId;
+        uint64_t orderHandle;   // aggressor
+        uint64_t restingHandle; // passive order filled by this trade
+        double price;
+        int64_t quantity;
+        uint64_t executedAt; // ns since epoch
+        uint32_t symbolIndex;
+        uint32_t userIndex;
+        uint32_t restingUserIndex;
+        uint8_t side;  // aggressor side: 0 = buy, 1 = sell
+        uint8_t flags; // RESULT_FLAG_RESTING_FILLED
+        uint16_t reserved;
+    };
+
+    static_assert(sizeof(TradeRecord) == 64 && std::is_trivially_copyable_v<TradeRecord>);
+
+    /**
+     * Control block at the start of a trade ring, one cache line per writer
+     *
+     * head counts records published and is written only by the producer;
+     * tail counts records consumed and is written only by the consumer. Both
+     * only ever grow: record n lives in slot n % capacity.
+     */
+    struct TradeRingHeader
+    {
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t capacity;
+        alignas(64) std::atomic<uint64_t> head;
+        alignas(64) std::atomic<uint64_t> tail;
+        alignas(64) std::atomic<uint64_t> watermark; // most records ever waiting at once
+        std::atomic<uint64_t> dropped;               // fills not published because the ring was full
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Java reads the ring indices in place");
+    static_assert(offsetof(TradeRingHeader, head) == 64 && offsetof(TradeRingHeader, tail) == 128 &&
+                  offsetof(TradeRingHeader, watermark) == 192 && offsetof(TradeRingHeader, dropped) == 200 &&
+                  sizeof(TradeRingHeader) == 256);
+
+    /**
+     * Single-producer / single-consumer ring of TradeRecords
+     *
+     * One contiguous block, header then slots, that Java maps as a direct
+     * ByteBuffer and drains in place: it reads head with acquire semantics,
+     * copies out the records up to it, and releases tail once per batch, so
+     * publishing trades costs no JNI call and no Java object per fill.
+     *
+     * The producer is the thread appending to the owning TradeJournal (the
+     * shard thread, or whoever holds the journal's lock inline). It keeps a
+     * private copy of tail and only reloads the consumer's cache line when
+     * the ring looks at least as full as its watermark, so a consumer that
+     * keeps up is not bounced on every fill. The ring never blocks matching:
+     * a fill that finds it full is counted in dropped and not published.
+     */
+    class TradeRing
+    {
+    public:
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t DEFAULT_CAPACITY = 65536;
+
+    private:
+        struct Free
+        {
+            void operator()(void *memory) const noexcept { std::free(memory); }
+        };
+
+        std::unique_ptr<void, Free> memory_;
+        TradeRingHeader *header_;
+        TradeRecord *records_;
+        size_t mask_;
+
+        // Producer only
+        uint64_t head_{0};
+        uint64_t cachedTail_{0};
+        uint64_t watermark_{0};
+
+        static size_t roundUp(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            return size;
+        }
+
+    public:
+        explicit TradeRing(size_t capacity = DEFAULT_CAPACITY)
+            : mask_(roundUp(capacity) - 1)
+        {
+            size_t bytes = sizeof(TradeRingHeader) + (mask_ + 1) * sizeof(TradeRecord);
+            memory_.reset(std::aligned_alloc(64, bytes));
+            if (!memory_)
+            {
+                throw std::bad_alloc();
+            }
+            std::memset(memory_.get(), 0, bytes);
+
+            header_ = new (memory_.get()) TradeRingHeader{};
+            header_->version = VERSION;
+            header_->recordSize = sizeof(TradeRecord);
+            header_->capacity = mask_ + 1;
+            records_ = reinterpret_cast<TradeRecord *>(static_cast<uint8_t *>(memory_.get()) + sizeof(TradeRingHeader));
+        }
+
+        TradeRing(const TradeRing &) = delete;
+        TradeRing &operator=(const TradeRing &) = delete;
+
+        /**
+         * Publish one fill, price converted with the book's tick size.
+         * Producer only; false (and counted as dropped) if the ring is full.
+         */
+        bool push(const Trade &trade, double tickSize) noexcept
+        {
+            uint64_t waiting = head_ - cachedTail_;
+            if (waiting >= watermark_)
+            {
+                cachedTail_ = header_->tail.load(std::memory_order_acquire);
+                waiting = head_ - cachedTail_;
+                if (waiting > mask_)
+                {
+                    header_->dropped.store(header_->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return false;
+                }
+                if (waiting + 1 > watermark_)
+                {
+                    watermark_ = waiting + 1;
+                    header_->watermark.store(watermark_, std::memory_order_relaxed);
+                }
+            }
+
+            TradeRecord &record = records_[head_ & mask_];
+            record.tradeId = trade.tradeId;
+            record.orderHandle = trade.orderHandle;
+            record.restingHandle = trade.restingHandle;
+            record.price = static_cast<double>(trade.price) * tickSize;
+            record.quantity = trade.quantity;
+            record.executedAt = trade.executedAt;
+            record.symbolIndex = trade.symbolIndex;
+            record.userIndex = trade.userIndex;
+            record.restingUserIndex = trade.restingUserIndex;
+            record.side = trade.side == Side::Buy ? 0 : 1;
+            record.flags = trade.restingFilled ? RESULT_FLAG_RESTING_FILLED : 0;
+            record.reserved = 0;
+
+            header_->head.store(++head_, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Copy up to max waiting records into out and consume them. Consumer
+         * only, for native consumers; Java drains the buffer directly.
+         */
+        size_t poll(TradeRecord *out, size_t max) noexcept
+        {
+            uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+            uint64_t head = header_->head.load(std::memory_order_acquire);
+            size_t count = static_cast<size_t>(std::min<uint64_t>(head - tail, max));
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = records_[(tail + i) & mask_];
+            }
+            header_->tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        // The whole ring, header first, for NewDirectByteBuffer
+        void *data() const noexcept { return memory_.get(); }
+        size_t byteSize() const noexcept { return sizeof(TradeRingHeader) + capacity() * sizeof(TradeRecord); }
+
+        size_t capacity() const noexcept { return mask_ + 1; }
+        uint64_t published() const noexcept { return header_->head.load(std::memory_order_acquire); }
+        uint64_t consumed() const noexcept { return header_->tail.load(std::memory_order_acquire); }
+        uint64_t watermark() const noexcept { return header_->watermark.load(std::memory_order_relaxed); }
+        uint64_t dropped() const noexcept { return header_->dropped.load(std::memory_order_relaxed); }
+    };
+
+} // namespace quantis
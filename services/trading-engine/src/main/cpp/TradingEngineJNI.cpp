@@ -1,16 +1,49 @@
 #include "TradingEngineJNI.h"
+#include "JniCache.h"
 #include "MarketDataStore.h"
-#include "CppMarketDataServiceStub.h" // Use stub instead of real implementation
+#include "LatencyHistogram.h"
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 
 namespace quantis
 {
 
     TradingEngineJNI::TradingEngineJNI()
     {
-        // Initialize market data service with stub implementation
+        engine_ = std::make_unique<MatchingEngine>(EngineConfig::fromEnvironment());
+
+        // Rebuild books and ID bindings from the journal before taking any orders
+        PersistenceConfig persistenceConfig = PersistenceConfig::fromEnvironment();
+        if (persistenceConfig.enabled())
+        {
+            persistence_ = EnginePersistence::open(*engine_, this, persistenceConfig);
+            if (!persistence_)
+            {
+                std::cerr << "TradingEngineJNI running without an event journal" << std::endl;
+            }
+        }
+
+        // libcurl-backed feed, or the no-op stand-in in builds without libcurl
         marketDataService_ = std::make_unique<CppMarketDataService>(getMarketDataStore());
-        std::cout << "TradingEngineJNI initialized with C++ Market Data Service (stub)" << std::endl;
+
+        // Symbols with resting orders and recent fills are polled more often
+        marketDataService_->setActivitySource([this](const std::string &symbol, SymbolActivity &activity)
+        {
+            OrderBook *book = engine_->findBook(symbol);
+            if (!book)
+            {
+                return false;
+            }
+            activity.openOrders = book->getOrderCount();
+            activity.totalTrades = book->getTotalTrades();
+            return true;
+        });
+#ifdef QUANTIS_WITH_CURL
+        std::cout << "TradingEngineJNI initialized with C++ Market Data Service" << std::endl;
+#else
+        std::cout << "TradingEngineJNI initialized with C++ Market Data Service (stub, built without libcurl)" << std::endl;
+#endif
     }
 
     TradingEngineJNI::~TradingEngineJNI()
@@ -19,7 +52,8 @@ namespace quantis
         {
             marketDataService_->stop();
         }
-        orderBooks_.clear();
+        persistence_.reset();
+        engine_.reset();
     }
 
     jboolean TradingEngineJNI::addOrder(JNIEnv *env, [[maybe_unused]] jobject obj, jstring orderId,
@@ -33,8 +67,11 @@ namespace quantis
             std::string symbolStr = jstringToString(env, symbol);
             std::string sideStr = jstringToString(env, side);
 
-            auto order = std::make_shared<Order>(orderIdStr, userIdStr, symbolStr,
-                                                 sideStr, quantity, price);
+            OrderRequest request;
+            if (!parseSide(sideStr, request.side))
+            {
+                return JNI_FALSE;
+            }
 
             OrderBook *orderBook = getOrderBook(symbolStr);
             if (!orderBook)
@@ -42,8 +79,27 @@ namespace quantis
                 return JNI_FALSE;
             }
 
-            bool success = orderBook->addOrder(order);
-            return success ? JNI_TRUE : JNI_FALSE;
+            request.handle = assignOrderHandle(orderIdStr, *orderBook);
+            if (request.handle == INVALID_ORDER_HANDLE)
+            {
+                return JNI_FALSE;
+            }
+            request.userIndex = internUser(userIdStr);
+            request.price = price;
+            request.quantity = quantity;
+
+            // Match on the book's engine thread and rest any remainder; one fill buffer per caller thread
+            thread_local std::vector<Trade> trades;
+            trades.clear();
+            bool success = engine_->matchOrder(*orderBook, request, trades);
+            if (!success)
+            {
+                releaseOrderHandle(request.handle);
+                return JNI_FALSE;
+            }
+
+            releaseFilledHandles(request, trades);
+            return JNI_TRUE;
         }
         catch (const std::exception &e)
         {
@@ -57,16 +113,15 @@ namespace quantis
         try
         {
             std::string orderIdStr = jstringToString(env, orderId);
-
-            for (auto &pair : orderBooks_)
+            // One hash probe for the handle; the handle itself routes to the owning book
+            OrderHandle handle = findOrderHandle(orderIdStr);
+            if (handle == INVALID_ORDER_HANDLE || !engine_->removeOrder(handle))
             {
-                if (pair.second->removeOrder(orderIdStr))
-                {
-                    return JNI_TRUE;
-                }
+                return JNI_FALSE;
             }
 
-            return JNI_FALSE;
+            releaseOrderHandle(handle);
+            return JNI_TRUE;
         }
         catch (const std::exception &e)
         {
@@ -86,16 +141,19 @@ namespace quantis
             std::string symbolStr = jstringToString(env, symbol);
             std::string sideStr = jstringToString(env, side);
 
-            auto order = std::make_shared<Order>(orderIdStr, userIdStr, symbolStr,
-                                                 sideStr, quantity, price);
-
-            OrderBook *orderBook = getOrderBook(symbolStr);
-            if (!orderBook)
+            // An order stays on the book it was entered on
+            OrderRequest request;
+            request.handle = findOrderHandle(orderIdStr);
+            OrderBook *orderBook = engine_->bookForHandle(request.handle);
+            if (!orderBook || orderBook->getSymbol() != symbolStr || !parseSide(sideStr, request.side))
             {
                 return JNI_FALSE;
             }
+            request.userIndex = internUser(userIdStr);
+            request.price = price;
+            request.quantity = quantity;
 
-            bool success = orderBook->updateOrder(order);
+            bool success = engine_->updateOrder(request);
             return success ? JNI_TRUE : JNI_FALSE;
         }
         catch (const std::exception &e)
@@ -105,6 +163,22 @@ namespace quantis
         }
     }
 
+    jboolean TradingEngineJNI::amendOrder([[maybe_unused]] JNIEnv *env, [[maybe_unused]] jobject obj, jlong handle,
+                                          jlong quantity, jdouble price)
+    {
+        try
+        {
+            // By handle: no strings to convert and no ID lookup
+            bool success = engine_->amendOrder(static_cast<OrderHandle>(handle), quantity, price);
+            return success ? JNI_TRUE : JNI_FALSE;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in amendOrder: " << e.what() << std::endl;
+            return JNI_FALSE;
+        }
+    }
+
     jobjectArray TradingEngineJNI::getMarketData(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol)
     {
         try
@@ -118,7 +192,7 @@ namespace quantis
             }
 
             // Create array of market data strings
-            jobjectArray result = env->NewObjectArray(4, env->FindClass("java/lang/String"), nullptr);
+            jobjectArray result = env->NewObjectArray(4, jniCache().stringClass, nullptr);
 
             env->SetObjectArrayElement(result, 0, stringToJstring(env, std::to_string(orderBook->getBestBid())));
             env->SetObjectArrayElement(result, 1, stringToJstring(env, std::to_string(orderBook->getBestAsk())));
@@ -155,6 +229,40 @@ namespace quantis
         }
     }
 
+    jlongArray TradingEngineJNI::getBookMemoryStats(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol)
+    {
+        try
+        {
+            // Looks the book up without creating one
+            OrderBook *orderBook = engine_->findBook(jstringToString(env, symbol));
+            if (!orderBook)
+            {
+                return nullptr;
+            }
+
+            BookMemoryStats stats = orderBook->getMemoryStats();
+            const jlong values[] = {
+                static_cast<jlong>(stats.ordersInUse),
+                static_cast<jlong>(stats.orderCapacity),
+                static_cast<jlong>(stats.levelsInUse),
+                static_cast<jlong>(stats.levelCapacity),
+                static_cast<jlong>(stats.reservedBytes),
+                static_cast<jlong>(stats.hugePageBytes),
+            };
+            jlongArray result = env->NewLongArray(6);
+            if (result)
+            {
+                env->SetLongArrayRegion(result, 0, 6, values);
+            }
+            return result;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in getBookMemoryStats: " << e.what() << std::endl;
+            return nullptr;
+        }
+    }
+
     jdouble TradingEngineJNI::getSpread(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol)
     {
         try
@@ -176,11 +284,288 @@ namespace quantis
         }
     }
 
-    jboolean TradingEngineJNI::isSymbolHalted([[maybe_unused]] JNIEnv *env, [[maybe_unused]] jobject obj, [[maybe_unused]] jstring symbol)
+    jboolean TradingEngineJNI::configureOrderBook(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol,
+                                                  jint bookType, jdouble tickSize)
+    {
+        try
+        {
+            if (tickSize <= 0.0 || (bookType != static_cast<jint>(BookType::Map) &&
+                                    bookType != static_cast<jint>(BookType::TickLadder)))
+            {
+                return JNI_FALSE;
+            }
+
+            BookConfig config;
+            config.type = static_cast<BookType>(bookType);
+            config.tickSize = tickSize;
+
+            if (!symbol)
+            {
+                engine_->setDefaultBookConfig(config);
+                return JNI_TRUE;
+            }
+
+            return engine_->configureBook(jstringToString(env, symbol), config) ? JNI_TRUE : JNI_FALSE;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in configureOrderBook: " << e.what() << std::endl;
+            return JNI_FALSE;
+        }
+    }
+
+    jint TradingEngineJNI::resolveSymbol(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol)
+    {
+        try
+        {
+            OrderBook *orderBook = getOrderBook(jstringToString(env, symbol));
+            return orderBook ? static_cast<jint>(orderBook->getSymbolIndex()) : -1;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in resolveSymbol: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    jint TradingEngineJNI::resolveUser(JNIEnv *env, [[maybe_unused]] jobject obj, jstring userId)
+    {
+        try
+        {
+            return static_cast<jint>(internUser(jstringToString(env, userId)));
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in resolveUser: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    jint TradingEngineJNI::processOrderBatch(JNIEnv *env, [[maybe_unused]] jobject obj, jobject input, jint count, jobject output)
+    {
+        try
+        {
+            auto *in = static_cast<const unsigned char *>(input ? env->GetDirectBufferAddress(input) : nullptr);
+            auto *out = static_cast<unsigned char *>(output ? env->GetDirectBufferAddress(output) : nullptr);
+            jlong outCapacity = out ? env->GetDirectBufferCapacity(output) : 0;
+            if (!out || outCapacity < static_cast<jlong>(sizeof(BatchHeader)) || count < 0 ||
+                (count > 0 && (!in || env->GetDirectBufferCapacity(input) < static_cast<jlong>(count) * static_cast<jlong>(sizeof(OrderRecord)))))
+            {
+                return -1;
+            }
+
+            // Per-caller scratch: the command batch and results that did not fit last time
+            thread_local EngineBatch batch;
+            thread_local std::vector<ResultRecord> carry;
+
+            size_t maxResults = static_cast<size_t>(outCapacity - sizeof(BatchHeader)) / sizeof(ResultRecord);
+            unsigned char *cursor = out + sizeof(BatchHeader);
+            size_t written = 0;
+
+            std::vector<ResultRecord> spill;
+            auto emit = [&](const ResultRecord &result)
+            {
+                if (written < maxResults)
+                {
+                    std::memcpy(cursor + written * sizeof(ResultRecord), &result, sizeof(ResultRecord));
+                    ++written;
+                }
+                else
+                {
+                    spill.push_back(result);
+                }
+            };
+
+            for (const ResultRecord &result : carry)
+            {
+                emit(result);
+            }
+            carry.clear();
+
+            // Decode every record into one engine batch so shards run it in parallel
+            batch.clear();
+            for (jint i = 0; i < count; ++i)
+            {
+                OrderRecord record;
+                std::memcpy(&record, in + static_cast<size_t>(i) * sizeof(OrderRecord), sizeof(OrderRecord));
+
+                OrderRequest request;
+                request.handle = record.handle;
+                request.userIndex = record.userIndex;
+                request.side = record.side == 0 ? Side::Buy : Side::Sell;
+                request.price = record.price;
+                request.quantity = record.quantity;
+
+                // For New and Amend, a side byte other than 0 or 1 is a mis-encoded record, not a sell
+                switch (static_cast<BatchOp>(record.op))
+                {
+                case BatchOp::New:
+                {
+                    OrderBook *orderBook = record.side > 1 ? nullptr : engine_->bookForSymbolIndex(record.symbolIndex);
+                    request.handle = orderBook ? engine_->newOrderHandle(*orderBook) : INVALID_ORDER_HANDLE;
+                    batch.add(EngineOp::Match, orderBook, request);
+                    break;
+                }
+                case BatchOp::Cancel:
+                    batch.add(EngineOp::Remove, engine_->bookForHandle(record.handle), request);
+                    break;
+                case BatchOp::Amend:
+                    batch.add(EngineOp::Update, record.side > 1 ? nullptr : engine_->bookForHandle(record.handle), request);
+                    break;
+                default:
+                    batch.add(EngineOp::Match, nullptr, request);
+                    break;
+                }
+            }
+
+            engine_->execute(batch);
+
+            for (size_t i = 0; i < batch.size(); ++i)
+            {
+                OrderRecord record;
+                std::memcpy(&record, in + i * sizeof(OrderRecord), sizeof(OrderRecord));
+                const EngineCommand &command = batch.command(i);
+                const std::vector<Trade> &trades = batch.trades(i);
+
+                // Orders entered by string ID may have been filled or cancelled by this record
+                if (command.op == EngineOp::Match)
+                {
+                    releaseFilledHandles(command.request, trades);
+                }
+                else if (command.op == EngineOp::Remove && batch.ok(i))
+                {
+                    releaseOrderHandle(command.request.handle);
+                }
+
+                ResultRecord ack{};
+                ack.type = static_cast<uint8_t>(batch.ok(i) ? ResultType::Ack : ResultType::Reject);
+                ack.reason = static_cast<uint8_t>(batch.reject(i));
+                ack.side = record.side;
+                ack.symbolIndex = command.book ? command.book->getSymbolIndex() : record.symbolIndex;
+                ack.clientOrderId = record.clientOrderId;
+                ack.handle = command.request.handle;
+                ack.userIndex = record.userIndex;
+
+                int64_t filled = 0;
+                for (const Trade &trade : trades)
+                {
+                    filled += trade.quantity;
+                }
+                ack.quantity = command.op == EngineOp::Remove ? 0 : record.quantity - filled;
+                emit(ack);
+
+                for (const Trade &trade : trades)
+                {
+                    ResultRecord fill{};
+                    fill.type = static_cast<uint8_t>(ResultType::Fill);
+                    fill.side = record.side;
+                    fill.flags = trade.restingFilled ? RESULT_FLAG_RESTING_FILLED : 0;
+                    fill.symbolIndex = trade.symbolIndex;
+                    fill.clientOrderId = record.clientOrderId;
+                    fill.handle = trade.orderHandle;
+                    fill.tradeId = trade.tradeId;
+                    fill.restingHandle = trade.restingHandle;
+                    fill.quantity = trade.quantity;
+                    fill.price = command.book->fromTicks(trade.price);
+                    fill.userIndex = trade.userIndex;
+                    fill.restingUserIndex = trade.restingUserIndex;
+                    emit(fill);
+                }
+            }
+
+            carry.swap(spill);
+
+            BatchHeader header{};
+            header.processed = static_cast<uint32_t>(count);
+            header.results = static_cast<uint32_t>(written);
+            header.pending = static_cast<uint32_t>(carry.size());
+            std::memcpy(out, &header, sizeof(header));
+
+            return static_cast<jint>(written);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in processOrderBatch: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    jboolean TradingEngineJNI::isSymbolHalted(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol)
+    {
+        try
+        {
+            uint32_t index = getMarketDataStore().findSymbolIndex(jstringToString(env, symbol));
+            return engine_->risk().isHalted(index) ? JNI_TRUE : JNI_FALSE;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in isSymbolHalted: " << e.what() << std::endl;
+            return JNI_FALSE;
+        }
+    }
+
+    jboolean TradingEngineJNI::setSymbolHalted(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol, jboolean halted)
     {
-        // For now, always return false (no halts)
-        // In production, this would check circuit breakers
-        return JNI_FALSE;
+        try
+        {
+            // Halting a symbol nobody has traded yet registers it, so the halt holds for its first order
+            OrderBook *orderBook = getOrderBook(jstringToString(env, symbol));
+            return orderBook && engine_->risk().setHalted(orderBook->getSymbolIndex(), halted == JNI_TRUE) ? JNI_TRUE : JNI_FALSE;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in setSymbolHalted: " << e.what() << std::endl;
+            return JNI_FALSE;
+        }
+    }
+
+    jboolean TradingEngineJNI::setUserRiskLimits(JNIEnv *env, [[maybe_unused]] jobject obj, jstring userId, jlong maxOrderQuantity,
+                                                 jdouble maxOrderNotional, jdouble maxPositionNotional, jdouble maxOrdersPerSecond)
+    {
+        try
+        {
+            RiskLimits limits;
+            limits.maxOrderQuantity = maxOrderQuantity;
+            limits.maxOrderNotional = maxOrderNotional;
+            limits.maxPositionNotional = maxPositionNotional;
+            limits.maxOrdersPerSecond = maxOrdersPerSecond;
+            return engine_->risk().setLimits(internUser(jstringToString(env, userId)), limits) ? JNI_TRUE : JNI_FALSE;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in setUserRiskLimits: " << e.what() << std::endl;
+            return JNI_FALSE;
+        }
+    }
+
+    jint TradingEngineJNI::getTradeRingCount([[maybe_unused]] JNIEnv *env, [[maybe_unused]] jobject obj)
+    {
+        return static_cast<jint>(engine_->getTradeRingCount());
+    }
+
+    jobject TradingEngineJNI::getTradeRing(JNIEnv *env, [[maybe_unused]] jobject obj, jint index)
+    {
+        if (index < 0 || static_cast<size_t>(index) >= engine_->getTradeRingCount())
+        {
+            return nullptr;
+        }
+
+        // The ring lives as long as the engine, so Java may keep the view
+        TradeRing &ring = engine_->getTradeRing(static_cast<size_t>(index));
+        return env->NewDirectByteBuffer(ring.data(), static_cast<jlong>(ring.byteSize()));
+    }
+
+    jstring TradingEngineJNI::getUserId(JNIEnv *env, [[maybe_unused]] jobject obj, jint userIndex)
+    {
+        try
+        {
+            return env->NewStringUTF(userIndex > 0 ? userIds_.name(static_cast<uint32_t>(userIndex)).c_str() : "");
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in getUserId: " << e.what() << std::endl;
+            return nullptr;
+        }
     }
 
     jobjectArray TradingEngineJNI::getExecutedTrades(JNIEnv *env, [[maybe_unused]] jobject obj, jstring orderId)
@@ -189,15 +574,28 @@ namespace quantis
         {
             std::string orderIdStr = jstringToString(env, orderId);
 
-            for ([[maybe_unused]] auto &pair : orderBooks_)
+            // Fills come from the trade journal by handle, so this is O(fills) per call
+            static thread_local std::vector<Trade> trades;
+            trades.clear();
+            OrderHandle handle = findTradedOrderHandle(orderIdStr);
+            if (handle != INVALID_ORDER_HANDLE)
             {
-                // This is a simplified implementation - in reality, you'd need to track trades per order
-                // For now, return empty array as the current implementation doesn't store trades
-                jobjectArray result = env->NewObjectArray(0, env->FindClass("java/lang/Object"), nullptr);
-                return result;
+                engine_->getExecutedTrades(handle, trades);
             }
 
-            return nullptr;
+            jobjectArray result = env->NewObjectArray(static_cast<jsize>(trades.size()), jniCache().objectClass, nullptr);
+            for (size_t i = 0; i < trades.size(); ++i)
+            {
+                OrderBook *book = engine_->bookForSymbolIndex(trades[i].symbolIndex);
+                if (!book)
+                {
+                    continue;
+                }
+                jobject trade = createTradeObject(env, trades[i], *book);
+                env->SetObjectArrayElement(result, static_cast<jsize>(i), trade);
+                env->DeleteLocalRef(trade);
+            }
+            return result;
         }
         catch (const std::exception &e)
         {
@@ -208,15 +606,170 @@ namespace quantis
 
     OrderBook *TradingEngineJNI::getOrderBook(const std::string &symbol)
     {
+        return engine_->getOrCreateBook(symbol);
+    }
+
+    OrderHandle TradingEngineJNI::assignOrderHandle(const std::string &orderId, const OrderBook &book)
+    {
+        std::lock_guard<std::mutex> lock(idMutex_);
+        auto [it, inserted] = orderHandles_.try_emplace(orderId, INVALID_ORDER_HANDLE);
+        if (!inserted)
+        {
+            return INVALID_ORDER_HANDLE;
+        }
+        it->second = engine_->newOrderHandle(book);
+        orderIds_.emplace(it->second, orderId);
+        if (persistence_)
+        {
+            persistence_->bindOrder(it->second, orderId);
+        }
+        return it->second;
+    }
+
+    uint32_t TradingEngineJNI::internUser(const std::string &userId)
+    {
+        bool created;
+        uint32_t index = userIds_.intern(userId, created);
+        if (created && persistence_)
+        {
+            persistence_->bindUser(index, userId);
+        }
+        return index;
+    }
+
+    OrderHandle TradingEngineJNI::findOrderHandle(const std::string &orderId)
+    {
+        std::lock_guard<std::mutex> lock(idMutex_);
+        auto it = orderHandles_.find(orderId);
+        return it != orderHandles_.end() ? it->second : INVALID_ORDER_HANDLE;
+    }
+
+    OrderHandle TradingEngineJNI::findTradedOrderHandle(const std::string &orderId)
+    {
+        std::lock_guard<std::mutex> lock(idMutex_);
+        auto it = orderHandles_.find(orderId);
+        if (it != orderHandles_.end())
+        {
+            return it->second;
+        }
+        auto retired = retiredHandles_.find(orderId);
+        return retired != retiredHandles_.end() ? retired->second : INVALID_ORDER_HANDLE;
+    }
+
+    std::string TradingEngineJNI::orderIdFor(OrderHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(idMutex_);
+        auto it = orderIds_.find(handle);
+        if (it != orderIds_.end())
+        {
+            return it->second;
+        }
+        auto retired = retiredIds_.find(handle);
+        return retired != retiredIds_.end() ? retired->second : std::to_string(handle);
+    }
+
+    void TradingEngineJNI::releaseOrderHandle(OrderHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(idMutex_);
+        auto it = orderIds_.find(handle);
+        if (it == orderIds_.end())
+        {
+            return;
+        }
+
+        std::string orderId = std::move(it->second);
+        orderIds_.erase(it);
+        orderHandles_.erase(orderId);
+        retireOrderIdLocked(handle, std::move(orderId));
+    }
+
+    void TradingEngineJNI::retireOrderIdLocked(OrderHandle handle, std::string orderId)
+    {
+        // Keep the ID resolvable for trade queries until it ages out
+        retiredHandles_[orderId] = handle;
+        retiredIds_[handle] = std::move(orderId);
+        retiredOrder_.push_back(handle);
+
+        if (retiredOrder_.size() > RETIRED_ID_CAPACITY)
+        {
+            OrderHandle oldest = retiredOrder_.front();
+            retiredOrder_.pop_front();
+            auto old = retiredIds_.find(oldest);
+            if (old != retiredIds_.end())
+            {
+                auto name = retiredHandles_.find(old->second);
+                if (name != retiredHandles_.end() && name->second == oldest)
+                {
+                    retiredHandles_.erase(name);
+                }
+                retiredIds_.erase(old);
+            }
+        }
+    }
+
+    void TradingEngineJNI::saveBindings(std::vector<std::string> &users, std::vector<std::pair<OrderHandle, std::string>> &orders)
+    {
+        users = userIds_.names();
+        std::lock_guard<std::mutex> lock(idMutex_);
+        orders.assign(orderIds_.begin(), orderIds_.end());
+    }
+
+    void TradingEngineJNI::restoreUser(uint32_t index, const std::string &name)
+    {
+        if (userIds_.intern(name) != index)
+        {
+            std::cerr << "Recovered user " << name << " no longer has index " << index << std::endl;
+        }
+    }
+
+    void TradingEngineJNI::restoreOrderId(OrderHandle handle, const std::string &orderId)
+    {
+        // Orders still resting are live again; the rest stay queryable for their fills
+        OrderBook *book = engine_->bookForHandle(handle);
+        std::lock_guard<std::mutex> lock(idMutex_);
+        if (book && book->containsOrder(handle))
+        {
+            orderHandles_[orderId] = handle;
+            orderIds_[handle] = orderId;
+        }
+        else
+        {
+            retireOrderIdLocked(handle, orderId);
+        }
+    }
 
-        auto it = orderBooks_.find(symbol);
-        if (it == orderBooks_.end())
+    void TradingEngineJNI::releaseFilledHandles(const OrderRequest &request, const std::vector<Trade> &trades)
+    {
+        // Drop ID mappings for orders that are no longer on any book
+        int64_t filled = 0;
+        for (const Trade &trade : trades)
         {
-            orderBooks_[symbol] = std::make_unique<OrderBook>(symbol);
-            return orderBooks_[symbol].get();
+            filled += trade.quantity;
+            if (trade.restingFilled)
+            {
+                releaseOrderHandle(trade.restingHandle);
+            }
         }
 
-        return it->second.get();
+        if (filled >= request.quantity)
+        {
+            releaseOrderHandle(request.handle);
+        }
+    }
+
+    bool TradingEngineJNI::parseSide(const std::string &side, Side &out)
+    {
+        if (side == "BUY")
+        {
+            out = Side::Buy;
+            return true;
+        }
+        if (side == "SELL")
+        {
+            out = Side::Sell;
+            return true;
+        }
+        return false;
     }
 
     std::string TradingEngineJNI::jstringToString(JNIEnv *env, jstring jstr)
@@ -283,6 +836,47 @@ namespace quantis
         }
     }
 
+    jint TradingEngineJNI::readMarketData(JNIEnv *env, [[maybe_unused]] jobject obj, jintArray symbolIndices, jdoubleArray out)
+    {
+        constexpr jsize FIELDS = 6;
+
+        // Sizes first: once the first array is pinned no JNI call may follow
+        JniCriticalArray<const jint> indices(env, symbolIndices, true);
+        JniCriticalArray<jdouble> values(env, out);
+        if (!symbolIndices || !out || values.size() / FIELDS < indices.size())
+        {
+            return -1;
+        }
+
+        // Both arrays stay pinned while the store is read
+        if (!indices.acquire() || !values.acquire())
+        {
+            return -1;
+        }
+
+        MarketDataStore &store = getMarketDataStore();
+        jint found = 0;
+        for (jsize i = 0; i < indices.size(); ++i)
+        {
+            MarketDataValues data;
+            jdouble *row = values.data() + i * FIELDS;
+            if (indices[i] < 0 || !store.getMarketData(static_cast<uint32_t>(indices[i]), data))
+            {
+                std::fill(row, row + FIELDS, 0.0);
+                continue;
+            }
+
+            row[0] = data.bestBid;
+            row[1] = data.bestAsk;
+            row[2] = data.lastPrice;
+            row[3] = data.spread;
+            row[4] = static_cast<jdouble>(data.volume);
+            row[5] = static_cast<jdouble>(data.timestamp);
+            ++found;
+        }
+        return found;
+    }
+
     jboolean TradingEngineJNI::hasValidMarketData(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol)
     {
         try
@@ -301,6 +895,136 @@ namespace quantis
         }
     }
 
+    jdoubleArray TradingEngineJNI::getMarketDepth(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol)
+    {
+        try
+        {
+            // Straight from the store's seqlocked copy: the book is not locked
+            BookDepth depth;
+            if (!getMarketDataStore().getDepth(jstringToString(env, symbol), depth))
+            {
+                return nullptr;
+            }
+
+            jdouble values[3 + 3 * 2 * BookDepth::LEVELS];
+            size_t count = 0;
+            values[count++] = depth.bidCount;
+            values[count++] = depth.askCount;
+            values[count++] = static_cast<double>(depth.timestamp);
+            auto append = [&](const std::array<DepthLevel, BookDepth::LEVELS> &levels, uint32_t levelCount)
+            {
+                for (uint32_t i = 0; i < levelCount; ++i)
+                {
+                    values[count++] = levels[i].price;
+                    values[count++] = static_cast<double>(levels[i].quantity);
+                    values[count++] = levels[i].orderCount;
+                }
+            };
+            append(depth.bids, depth.bidCount);
+            append(depth.asks, depth.askCount);
+
+            jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(count));
+            if (result)
+            {
+                env->SetDoubleArrayRegion(result, 0, static_cast<jsize>(count), values);
+            }
+            return result;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error getting market depth: " << e.what() << std::endl;
+            return nullptr;
+        }
+    }
+
+    jlongArray TradingEngineJNI::waitForUpdates(JNIEnv *env, [[maybe_unused]] jobject obj, jlong lastSequence, jlong timeoutMs)
+    {
+        try
+        {
+            MarketDataStore &store = getMarketDataStore();
+            uint64_t sequence = static_cast<uint64_t>(lastSequence);
+            uint64_t current = store.getChangeSequence();
+            if (current == sequence && timeoutMs > 0)
+            {
+                current = store.waitForChanges(sequence, std::chrono::milliseconds(timeoutMs));
+            }
+
+            // Drain into a per-thread buffer: one JNI array, no allocation once warm
+            thread_local std::vector<uint32_t> indices;
+            thread_local std::vector<jlong> values;
+            indices.clear();
+            uint64_t drained = current == sequence ? sequence : store.drainChanges(sequence, indices);
+
+            values.resize(indices.size() + 1);
+            values[0] = static_cast<jlong>(drained);
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                values[i + 1] = static_cast<jlong>(indices[i]);
+            }
+
+            jlongArray result = env->NewLongArray(static_cast<jsize>(values.size()));
+            if (result)
+            {
+                env->SetLongArrayRegion(result, 0, static_cast<jsize>(values.size()), values.data());
+            }
+            return result;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error waiting for market data updates: " << e.what() << std::endl;
+            return nullptr;
+        }
+    }
+
+    jint TradingEngineJNI::snapshotMarketData(JNIEnv *env, [[maybe_unused]] jobject obj, jobject output)
+    {
+        try
+        {
+            auto *out = static_cast<MarketDataRecord *>(output ? env->GetDirectBufferAddress(output) : nullptr);
+            if (!out)
+            {
+                return -1;
+            }
+
+            // Straight into the Java buffer, one seqlock read per symbol
+            size_t capacity = static_cast<size_t>(env->GetDirectBufferCapacity(output)) / sizeof(MarketDataRecord);
+            return static_cast<jint>(getMarketDataStore().snapshotAll(out, capacity));
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error taking market data snapshot: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    jobjectArray TradingEngineJNI::getActiveSymbols(JNIEnv *env, [[maybe_unused]] jobject obj)
+    {
+        try
+        {
+            MarketDataStore &store = getMarketDataStore();
+            size_t count = store.getActiveSymbolCount();
+            jobjectArray result = env->NewObjectArray(static_cast<jsize>(count), jniCache().stringClass, nullptr);
+            if (!result)
+            {
+                return nullptr;
+            }
+
+            for (size_t i = 0; i < count; i++)
+            {
+                jstring symbolStr = env->NewStringUTF(store.getSymbol(static_cast<uint32_t>(i)).c_str());
+                env->SetObjectArrayElement(result, static_cast<jsize>(i), symbolStr);
+                env->DeleteLocalRef(symbolStr);
+            }
+
+            return result;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error getting active symbols: " << e.what() << std::endl;
+            return nullptr;
+        }
+    }
+
     jstring TradingEngineJNI::stringToJstring(JNIEnv *env, const std::string &str)
     {
         return env->NewStringUTF(str.c_str());
@@ -414,7 +1138,7 @@ namespace quantis
             }
 
             auto symbols = marketDataService_->getSymbols();
-            jobjectArray result = env->NewObjectArray(symbols.size(), env->FindClass("java/lang/String"), nullptr);
+            jobjectArray result = env->NewObjectArray(symbols.size(), jniCache().stringClass, nullptr);
 
             for (size_t i = 0; i < symbols.size(); i++)
             {
@@ -500,6 +1224,10 @@ namespace quantis
             }
 
             marketDataService_->resetMetrics();
+            for (size_t i = 0; i < static_cast<size_t>(LatencyMetric::Count); ++i)
+            {
+                latencyHistogram(static_cast<LatencyMetric>(i)).reset();
+            }
             return JNI_TRUE;
         }
         catch (const std::exception &e)
@@ -531,11 +1259,10 @@ namespace quantis
     jobject TradingEngineJNI::createPerformanceMetricsObject(JNIEnv *env, const CppMarketDataService::PerformanceMetrics &metrics)
     {
         // Create a simple Map object to return performance metrics
-        jclass mapClass = env->FindClass("java/util/HashMap");
-        jmethodID mapConstructor = env->GetMethodID(mapClass, "<init>", "()V");
-        jmethodID putMethod = env->GetMethodID(mapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+        const JniCache &cache = jniCache();
+        jmethodID putMethod = cache.hashMapPut;
 
-        jobject map = env->NewObject(mapClass, mapConstructor);
+        jobject map = env->NewObject(cache.hashMapClass, cache.hashMapInit);
 
         // Add metrics to map
         jstring key;
@@ -577,48 +1304,110 @@ namespace quantis
         env->DeleteLocalRef(key);
         env->DeleteLocalRef(value);
 
+        // Latency percentiles as "latency.<metric>.<stat>", all in nanoseconds
+        for (size_t i = 0; i < static_cast<size_t>(LatencyMetric::Count); ++i)
+        {
+            const LatencyHistogram &histogram = latencyHistogram(static_cast<LatencyMetric>(i));
+            LatencySummary summary = histogram.summarize();
+            const std::pair<const char *, std::string> stats[] = {
+                {"count", std::to_string(summary.count)},
+                {"meanNs", std::to_string(summary.meanNs)},
+                {"p50Ns", std::to_string(summary.p50Ns)},
+                {"p99Ns", std::to_string(summary.p99Ns)},
+                {"p999Ns", std::to_string(summary.p999Ns)},
+                {"maxNs", std::to_string(summary.maxNs)},
+            };
+            for (const auto &[stat, text] : stats)
+            {
+                key = env->NewStringUTF(("latency." + histogram.name() + "." + stat).c_str());
+                value = env->NewStringUTF(text.c_str());
+                env->CallObjectMethod(map, putMethod, key, value);
+                env->DeleteLocalRef(key);
+                env->DeleteLocalRef(value);
+            }
+        }
+
+        // Orders refused by the pre-trade gate as "risk.rejects.<reason>"
+        for (size_t i = 1; i < static_cast<size_t>(RiskReject::Count); ++i)
+        {
+            auto reason = static_cast<RiskReject>(i);
+            key = env->NewStringUTF((std::string("risk.rejects.") + riskRejectName(reason)).c_str());
+            value = env->NewStringUTF(std::to_string(engine_->risk().getRejectCount(reason)).c_str());
+            env->CallObjectMethod(map, putMethod, key, value);
+            env->DeleteLocalRef(key);
+            env->DeleteLocalRef(value);
+        }
+
+        // Trade output rings as "trades.ring.<i>.<stat>": backlog high-water mark and fills dropped when full
+        for (size_t i = 0; i < engine_->getTradeRingCount(); ++i)
+        {
+            const TradeRing &ring = engine_->getTradeRing(i);
+            const std::pair<const char *, uint64_t> stats[] = {
+                {"capacity", ring.capacity()},
+                {"published", ring.published()},
+                {"watermark", ring.watermark()},
+                {"dropped", ring.dropped()},
+            };
+            for (const auto &[stat, count] : stats)
+            {
+                key = env->NewStringUTF(("trades.ring." + std::to_string(i) + "." + stat).c_str());
+                value = env->NewStringUTF(std::to_string(count).c_str());
+                env->CallObjectMethod(map, putMethod, key, value);
+                env->DeleteLocalRef(key);
+                env->DeleteLocalRef(value);
+            }
+        }
+
         return map;
     }
 
-    jobject TradingEngineJNI::createTradeObject(JNIEnv *env, const Trade &trade)
+    jobject TradingEngineJNI::createTradeObject(JNIEnv *env, const Trade &trade, const OrderBook &book)
     {
         // Create a simple Map object to return trade data
-        jclass mapClass = env->FindClass("java/util/HashMap");
-        jmethodID mapConstructor = env->GetMethodID(mapClass, "<init>", "()V");
-        jmethodID putMethod = env->GetMethodID(mapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+        const JniCache &cache = jniCache();
+        jmethodID putMethod = cache.hashMapPut;
 
-        jobject map = env->NewObject(mapClass, mapConstructor);
+        jobject map = env->NewObject(cache.hashMapClass, cache.hashMapInit);
+
+        std::string orderIdStr = orderIdFor(trade.orderHandle);
+        std::string restingOrderIdStr = orderIdFor(trade.restingHandle);
 
         // Add trade data to map
         jstring key;
         jstring value;
 
         key = env->NewStringUTF("tradeId");
-        value = env->NewStringUTF(trade.tradeId.c_str());
+        value = env->NewStringUTF(std::to_string(trade.tradeId).c_str());
         env->CallObjectMethod(map, putMethod, key, value);
         env->DeleteLocalRef(key);
         env->DeleteLocalRef(value);
 
         key = env->NewStringUTF("orderId");
-        value = env->NewStringUTF(trade.orderId.c_str());
+        value = env->NewStringUTF(orderIdStr.c_str());
+        env->CallObjectMethod(map, putMethod, key, value);
+        env->DeleteLocalRef(key);
+        env->DeleteLocalRef(value);
+
+        key = env->NewStringUTF("restingOrderId");
+        value = env->NewStringUTF(restingOrderIdStr.c_str());
         env->CallObjectMethod(map, putMethod, key, value);
         env->DeleteLocalRef(key);
         env->DeleteLocalRef(value);
 
         key = env->NewStringUTF("userId");
-        value = env->NewStringUTF(trade.userId.c_str());
+        value = env->NewStringUTF(userIds_.name(trade.userIndex).c_str());
         env->CallObjectMethod(map, putMethod, key, value);
         env->DeleteLocalRef(key);
         env->DeleteLocalRef(value);
 
         key = env->NewStringUTF("symbol");
-        value = env->NewStringUTF(trade.symbol.c_str());
+        value = env->NewStringUTF(book.getSymbol().c_str());
         env->CallObjectMethod(map, putMethod, key, value);
         env->DeleteLocalRef(key);
         env->DeleteLocalRef(value);
 
         key = env->NewStringUTF("side");
-        value = env->NewStringUTF(trade.side.c_str());
+        value = env->NewStringUTF(trade.side == Side::Buy ? "BUY" : "SELL");
         env->CallObjectMethod(map, putMethod, key, value);
         env->DeleteLocalRef(key);
         env->DeleteLocalRef(value);
@@ -630,13 +1419,13 @@ namespace quantis
         env->DeleteLocalRef(value);
 
         key = env->NewStringUTF("price");
-        value = env->NewStringUTF(std::to_string(trade.price).c_str());
+        value = env->NewStringUTF(std::to_string(book.fromTicks(trade.price)).c_str());
         env->CallObjectMethod(map, putMethod, key, value);
         env->DeleteLocalRef(key);
         env->DeleteLocalRef(value);
 
         key = env->NewStringUTF("totalValue");
-        value = env->NewStringUTF(std::to_string(trade.totalValue).c_str());
+        value = env->NewStringUTF(std::to_string(trade.quantity * book.fromTicks(trade.price)).c_str());
         env->CallObjectMethod(map, putMethod, key, value);
         env->DeleteLocalRef(key);
         env->DeleteLocalRef(value);
@@ -3,21 +3,50 @@
 #include <jni.h>
 #include <string>
 #include <memory>
-#include "OrderBook.h"
-#include "CppMarketDataService.h" // Use real implementation
+#include <mutex>
+#include <unordered_map>
+#include <deque>
+#include "MatchingEngine.h"
+#include "StringInterner.h"
+#include "BatchProtocol.h"
+#include "EnginePersistence.h"
+// The market data service needs libcurl; builds without it get a no-op stand-in
+#ifdef QUANTIS_WITH_CURL
+#include "CppMarketDataService.h"
+#else
+#include "CppMarketDataServiceStub.h"
+#endif
 
 namespace quantis
 {
 
-    class TradingEngineJNI
+    class TradingEngineJNI : public BindingStore
     {
     private:
-        std::map<std::string, std::unique_ptr<OrderBook>> orderBooks_;
+        std::unique_ptr<MatchingEngine> engine_;
+        std::unique_ptr<EnginePersistence> persistence_; // set when QUANTIS_JOURNAL_DIR is
+
+        // String IDs live only at the JNI boundary; the engine sees handles and interned indices
+        std::mutex idMutex_;
+        std::unordered_map<std::string, OrderHandle> orderHandles_;
+        std::unordered_map<OrderHandle, std::string> orderIds_;
+
+        // Recently completed orders, kept so their fills stay queryable by ID
+        static constexpr size_t RETIRED_ID_CAPACITY = TradeJournal::DEFAULT_CAPACITY;
+        std::unordered_map<std::string, OrderHandle> retiredHandles_;
+        std::unordered_map<OrderHandle, std::string> retiredIds_;
+        std::deque<OrderHandle> retiredOrder_;
+        StringInterner userIds_;
         std::unique_ptr<CppMarketDataService> marketDataService_;
 
     public:
         TradingEngineJNI();
-        ~TradingEngineJNI();
+        ~TradingEngineJNI() override;
+
+        // BindingStore: user and order IDs for snapshots and restart recovery
+        void saveBindings(std::vector<std::string> &users, std::vector<std::pair<OrderHandle, std::string>> &orders) override;
+        void restoreUser(uint32_t index, const std::string &name) override;
+        void restoreOrderId(OrderHandle handle, const std::string &orderId) override;
 
         // JNI methods
         jboolean addOrder(JNIEnv *env, [[maybe_unused]] jobject obj, jstring orderId, jstring userId,
@@ -28,13 +57,37 @@ namespace quantis
         jboolean updateOrder(JNIEnv *env, [[maybe_unused]] jobject obj, jstring orderId, jstring userId,
                              jstring symbol, jstring side, jlong quantity, jdouble price);
 
+        jboolean amendOrder(JNIEnv *env, [[maybe_unused]] jobject obj, jlong handle, jlong quantity, jdouble price);
+
         jobjectArray getMarketData(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol);
 
         jlong getOrderCount(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol);
 
+        // Book pool occupancy: [ordersInUse, orderCapacity, levelsInUse, levelCapacity, reservedBytes, hugePageBytes]
+        jlongArray getBookMemoryStats(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol);
+
         jdouble getSpread(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol);
 
-        jboolean isSymbolHalted([[maybe_unused]] JNIEnv *env, [[maybe_unused]] jobject obj, [[maybe_unused]] jstring symbol);
+        // Select the book backend for a symbol before its first order (null symbol sets the default)
+        jboolean configureOrderBook(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol, jint bookType, jdouble tickSize);
+
+        // Batch order entry over direct ByteBuffers (layouts in BatchProtocol.h)
+        jint resolveSymbol(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol);
+        jint resolveUser(JNIEnv *env, [[maybe_unused]] jobject obj, jstring userId);
+        jint processOrderBatch(JNIEnv *env, [[maybe_unused]] jobject obj, jobject input, jint count, jobject output);
+
+        // Pre-trade risk gate: per-symbol circuit breaker and per-user limits (0 disables a limit)
+        jboolean isSymbolHalted(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol);
+        jboolean setSymbolHalted(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol, jboolean halted);
+        jboolean setUserRiskLimits(JNIEnv *env, [[maybe_unused]] jobject obj, jstring userId, jlong maxOrderQuantity,
+                                   jdouble maxOrderNotional, jdouble maxPositionNotional, jdouble maxOrdersPerSecond);
+
+        // Trade output rings (layout in TradeRing.h), each mapped as one direct ByteBuffer
+        jint getTradeRingCount(JNIEnv *env, [[maybe_unused]] jobject obj);
+        jobject getTradeRing(JNIEnv *env, [[maybe_unused]] jobject obj, jint index);
+
+        // User ID behind a user index from a batch or trade record; "" if unknown
+        jstring getUserId(JNIEnv *env, [[maybe_unused]] jobject obj, jint userIndex);
 
         // Get executed trades for an order
         jobjectArray getExecutedTrades(JNIEnv *env, [[maybe_unused]] jobject obj, jstring orderId);
@@ -42,8 +95,23 @@ namespace quantis
         // Ultra-low latency market data methods
         jboolean updateMarketData(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol, jdouble bestBid, jdouble bestAsk, jdouble lastPrice, jlong volume);
         jdoubleArray getMarketDataLockFree(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol);
+
+        // Per symbol index, [bestBid, bestAsk, lastPrice, spread, volume, timestamp] into out; returns symbols with data, or -1
+        jint readMarketData(JNIEnv *env, [[maybe_unused]] jobject obj, jintArray symbolIndices, jdoubleArray out);
         jboolean hasValidMarketData(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol);
 
+        // Top of the symbol's order book: [bidCount, askCount, timestamp, (price, quantity, orders) per bid then ask]
+        jdoubleArray getMarketDepth(JNIEnv *env, [[maybe_unused]] jobject obj, jstring symbol);
+
+        // Block until the store changes after lastSequence; returns [sequence, changed symbol indices...]
+        jlongArray waitForUpdates(JNIEnv *env, [[maybe_unused]] jobject obj, jlong lastSequence, jlong timeoutMs);
+
+        // Every symbol with data as MarketDataRecords in a direct ByteBuffer; returns the record count or -1
+        jint snapshotMarketData(JNIEnv *env, [[maybe_unused]] jobject obj, jobject output);
+
+        // Store symbols by index (MarketDataRecord.symbolIndex); "" for an index still being registered
+        jobjectArray getActiveSymbols(JNIEnv *env, [[maybe_unused]] jobject obj);
+
         // C++ Market Data Service control methods
         jboolean startMarketDataService([[maybe_unused]] JNIEnv *env, [[maybe_unused]] jobject obj);
         jboolean stopMarketDataService([[maybe_unused]] JNIEnv *env, [[maybe_unused]] jobject obj);
@@ -59,9 +127,18 @@ namespace quantis
 
     private:
         OrderBook *getOrderBook(const std::string &symbol);
+        OrderHandle assignOrderHandle(const std::string &orderId, const OrderBook &book);
+        OrderHandle findOrderHandle(const std::string &orderId);
+        OrderHandle findTradedOrderHandle(const std::string &orderId); // live or recently completed
+        std::string orderIdFor(OrderHandle handle);
+        void releaseOrderHandle(OrderHandle handle);
+        void retireOrderIdLocked(OrderHandle handle, std::string orderId);
+        uint32_t internUser(const std::string &userId);
+        void releaseFilledHandles(const OrderRequest &request, const std::vector<Trade> &trades);
+        static bool parseSide(const std::string &side, Side &out);
         std::string jstringToString(JNIEnv *env, jstring jstr);
         jstring stringToJstring(JNIEnv *env, const std::string &str);
-        jobject createTradeObject(JNIEnv *env, const Trade &trade);
+        jobject createTradeObject(JNIEnv *env, const Trade &trade, const OrderBook &book);
         jobject createPerformanceMetricsObject(JNIEnv *env, const CppMarketDataService::PerformanceMetrics &metrics);
     };
 
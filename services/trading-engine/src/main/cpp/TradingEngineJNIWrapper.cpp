@@ -1,4 +1,6 @@
 #include "TradingEngineJNI.h"
+#include "JniCache.h"
+#include "AsyncLogger.h"
 #include <iostream>
 
 // Global instance
@@ -7,18 +9,34 @@ static quantis::TradingEngineJNI *g_tradingEngine = nullptr;
 extern "C"
 {
 
-    JNIEXPORT jint JNICALL JNI_OnLoad([[maybe_unused]] JavaVM *vm, [[maybe_unused]] void *reserved)
+    JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, [[maybe_unused]] void *reserved)
     {
         std::cout << "TradingEngineJNI JNI_OnLoad called" << std::endl;
+
+        // Resolve classes and method IDs once, before any native method can run
+        JNIEnv *env = nullptr;
+        if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_8) != JNI_OK || !quantis::jniCache().load(env))
+        {
+            std::cerr << "TradingEngineJNI could not resolve its Java classes" << std::endl;
+            return JNI_ERR;
+        }
+
         g_tradingEngine = new quantis::TradingEngineJNI();
         return JNI_VERSION_1_8;
     }
 
-    JNIEXPORT void JNICALL JNI_OnUnload([[maybe_unused]] JavaVM *vm, [[maybe_unused]] void *reserved)
+    JNIEXPORT void JNICALL JNI_OnUnload(JavaVM *vm, [[maybe_unused]] void *reserved)
     {
         std::cout << "TradingEngineJNI JNI_OnUnload called" << std::endl;
         delete g_tradingEngine;
         g_tradingEngine = nullptr;
+        quantis::asyncLogger().flush();
+
+        JNIEnv *env = nullptr;
+        if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_8) == JNI_OK)
+        {
+            quantis::jniCache().unload(env);
+        }
     }
 
     JNIEXPORT jboolean JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_addOrder(JNIEnv *env, jobject obj, jstring orderId, jstring userId, jstring symbol,
@@ -50,6 +68,15 @@ extern "C"
         return g_tradingEngine->updateOrder(env, obj, orderId, userId, symbol, side, quantity, price);
     }
 
+    JNIEXPORT jboolean JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_amendOrder(JNIEnv *env, jobject obj, jlong handle, jlong quantity, jdouble price)
+    {
+        if (!g_tradingEngine)
+        {
+            return JNI_FALSE;
+        }
+        return g_tradingEngine->amendOrder(env, obj, handle, quantity, price);
+    }
+
     JNIEXPORT jobjectArray JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_getMarketData(JNIEnv *env, jobject obj, jstring symbol)
     {
         if (!g_tradingEngine)
@@ -68,6 +95,15 @@ extern "C"
         return g_tradingEngine->getOrderCount(env, obj, symbol);
     }
 
+    JNIEXPORT jlongArray JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_getBookMemoryStats(JNIEnv *env, jobject obj, jstring symbol)
+    {
+        if (!g_tradingEngine)
+        {
+            return nullptr;
+        }
+        return g_tradingEngine->getBookMemoryStats(env, obj, symbol);
+    }
+
     JNIEXPORT jdouble JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_getSpread(JNIEnv *env, jobject obj, jstring symbol)
     {
         if (!g_tradingEngine)
@@ -77,6 +113,42 @@ extern "C"
         return g_tradingEngine->getSpread(env, obj, symbol);
     }
 
+    JNIEXPORT jboolean JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_configureOrderBook(JNIEnv *env, jobject obj, jstring symbol, jint bookType, jdouble tickSize)
+    {
+        if (!g_tradingEngine)
+        {
+            return JNI_FALSE;
+        }
+        return g_tradingEngine->configureOrderBook(env, obj, symbol, bookType, tickSize);
+    }
+
+    JNIEXPORT jint JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_resolveSymbol(JNIEnv *env, jobject obj, jstring symbol)
+    {
+        if (!g_tradingEngine)
+        {
+            return -1;
+        }
+        return g_tradingEngine->resolveSymbol(env, obj, symbol);
+    }
+
+    JNIEXPORT jint JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_resolveUser(JNIEnv *env, jobject obj, jstring userId)
+    {
+        if (!g_tradingEngine)
+        {
+            return -1;
+        }
+        return g_tradingEngine->resolveUser(env, obj, userId);
+    }
+
+    JNIEXPORT jint JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_processOrderBatch(JNIEnv *env, jobject obj, jobject input, jint count, jobject output)
+    {
+        if (!g_tradingEngine)
+        {
+            return -1;
+        }
+        return g_tradingEngine->processOrderBatch(env, obj, input, count, output);
+    }
+
     JNIEXPORT jboolean JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_isSymbolHalted(JNIEnv *env, jobject obj, jstring symbol)
     {
         if (!g_tradingEngine)
@@ -86,6 +158,52 @@ extern "C"
         return g_tradingEngine->isSymbolHalted(env, obj, symbol);
     }
 
+    JNIEXPORT jboolean JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_setSymbolHalted(JNIEnv *env, jobject obj, jstring symbol, jboolean halted)
+    {
+        if (!g_tradingEngine)
+        {
+            return JNI_FALSE;
+        }
+        return g_tradingEngine->setSymbolHalted(env, obj, symbol, halted);
+    }
+
+    JNIEXPORT jboolean JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_setUserRiskLimits(JNIEnv *env, jobject obj, jstring userId, jlong maxOrderQuantity,
+                                                                                                      jdouble maxOrderNotional, jdouble maxPositionNotional, jdouble maxOrdersPerSecond)
+    {
+        if (!g_tradingEngine)
+        {
+            return JNI_FALSE;
+        }
+        return g_tradingEngine->setUserRiskLimits(env, obj, userId, maxOrderQuantity, maxOrderNotional, maxPositionNotional, maxOrdersPerSecond);
+    }
+
+    JNIEXPORT jint JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_getTradeRingCount(JNIEnv *env, jobject obj)
+    {
+        if (!g_tradingEngine)
+        {
+            return 0;
+        }
+        return g_tradingEngine->getTradeRingCount(env, obj);
+    }
+
+    JNIEXPORT jobject JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_getTradeRing(JNIEnv *env, jobject obj, jint index)
+    {
+        if (!g_tradingEngine)
+        {
+            return nullptr;
+        }
+        return g_tradingEngine->getTradeRing(env, obj, index);
+    }
+
+    JNIEXPORT jstring JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_getUserId(JNIEnv *env, jobject obj, jint userIndex)
+    {
+        if (!g_tradingEngine)
+        {
+            return nullptr;
+        }
+        return g_tradingEngine->getUserId(env, obj, userIndex);
+    }
+
     JNIEXPORT jobjectArray JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_getExecutedTrades(JNIEnv *env, jobject obj, jstring orderId)
     {
         if (!g_tradingEngine)
@@ -114,6 +232,15 @@ extern "C"
         return g_tradingEngine->getMarketDataLockFree(env, obj, symbol);
     }
 
+    JNIEXPORT jint JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_readMarketData(JNIEnv *env, jobject obj, jintArray symbolIndices, jdoubleArray out)
+    {
+        if (!g_tradingEngine)
+        {
+            return -1;
+        }
+        return g_tradingEngine->readMarketData(env, obj, symbolIndices, out);
+    }
+
     JNIEXPORT jboolean JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_hasValidMarketData(JNIEnv *env, jobject obj, jstring symbol)
     {
         if (!g_tradingEngine)
@@ -123,6 +250,42 @@ extern "C"
         return g_tradingEngine->hasValidMarketData(env, obj, symbol);
     }
 
+    JNIEXPORT jdoubleArray JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_getMarketDepth(JNIEnv *env, jobject obj, jstring symbol)
+    {
+        if (!g_tradingEngine)
+        {
+            return nullptr;
+        }
+        return g_tradingEngine->getMarketDepth(env, obj, symbol);
+    }
+
+    JNIEXPORT jlongArray JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_waitForUpdates(JNIEnv *env, jobject obj, jlong lastSequence, jlong timeoutMs)
+    {
+        if (!g_tradingEngine)
+        {
+            return nullptr;
+        }
+        return g_tradingEngine->waitForUpdates(env, obj, lastSequence, timeoutMs);
+    }
+
+    JNIEXPORT jint JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_snapshotMarketData(JNIEnv *env, jobject obj, jobject output)
+    {
+        if (!g_tradingEngine)
+        {
+            return -1;
+        }
+        return g_tradingEngine->snapshotMarketData(env, obj, output);
+    }
+
+    JNIEXPORT jobjectArray JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_getActiveSymbols(JNIEnv *env, jobject obj)
+    {
+        if (!g_tradingEngine)
+        {
+            return nullptr;
+        }
+        return g_tradingEngine->getActiveSymbols(env, obj);
+    }
+
     // C++ Market Data Service control methods
     JNIEXPORT jboolean JNICALL Java_com_quantis_trading_engine_jni_TradingEngineJNI_startMarketDataService(JNIEnv *env, jobject obj)
     {
@@ -0,0 +1,782 @@
+#include "WebSocketFeed.h"
+#include "FastJsonParser.h"
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace quantis
+{
+
+    namespace
+    {
+        constexpr uint8_t OP_CONTINUATION = 0x0;
+        constexpr uint8_t OP_TEXT = 0x1;
+        constexpr uint8_t OP_BINARY = 0x2;
+        constexpr uint8_t OP_CLOSE = 0x8;
+        constexpr uint8_t OP_PING = 0x9;
+        constexpr uint8_t OP_PONG = 0xA;
+
+        constexpr size_t INITIAL_BUFFER = 64 * 1024;
+        constexpr int POLL_MS = 100; // how quickly the I/O thread notices stop()
+
+        uint64_t nowMs()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+        // SHA-1, only for checking Sec-WebSocket-Accept in the handshake
+        void sha1(const std::string &input, uint8_t digest[20])
+        {
+            uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+            std::string message = input;
+            uint64_t bits = static_cast<uint64_t>(input.size()) * 8;
+            message.push_back(static_cast<char>(0x80));
+            while (message.size() % 64 != 56)
+            {
+                message.push_back(0);
+            }
+            for (int i = 7; i >= 0; --i)
+            {
+                message.push_back(static_cast<char>(bits >> (i * 8)));
+            }
+
+            auto rotl = [](uint32_t value, int shift)
+            { return (value << shift) | (value >> (32 - shift)); };
+
+            for (size_t block = 0; block < message.size(); block += 64)
+            {
+                uint32_t w[80];
+                for (int i = 0; i < 16; ++i)
+                {
+                    const auto *p = reinterpret_cast<const uint8_t *>(message.data() + block + i * 4);
+                    w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+                }
+                for (int i = 16; i < 80; ++i)
+                {
+                    w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+                }
+
+                uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+                for (int i = 0; i < 80; ++i)
+                {
+                    uint32_t f, k;
+                    if (i < 20)
+                    {
+                        f = (b & c) | (~b & d);
+                        k = 0x5A827999;
+                    }
+                    else if (i < 40)
+                    {
+                        f = b ^ c ^ d;
+                        k = 0x6ED9EBA1;
+                    }
+                    else if (i < 60)
+                    {
+                        f = (b & c) | (b & d) | (c & d);
+                        k = 0x8F1BBCDC;
+                    }
+                    else
+                    {
+                        f = b ^ c ^ d;
+                        k = 0xCA62C1D6;
+                    }
+                    uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+                    e = d;
+                    d = c;
+                    c = rotl(b, 30);
+                    b = a;
+                    a = temp;
+                }
+                h[0] += a;
+                h[1] += b;
+                h[2] += c;
+                h[3] += d;
+                h[4] += e;
+            }
+
+            for (int i = 0; i < 5; ++i)
+            {
+                digest[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+                digest[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+                digest[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+                digest[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+            }
+        }
+
+        std::string base64(const uint8_t *data, size_t size)
+        {
+            static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            std::string out;
+            for (size_t i = 0; i < size; i += 3)
+            {
+                uint32_t chunk = uint32_t(data[i]) << 16;
+                if (i + 1 < size)
+                {
+                    chunk |= uint32_t(data[i + 1]) << 8;
+                }
+                if (i + 2 < size)
+                {
+                    chunk |= uint32_t(data[i + 2]);
+                }
+                out.push_back(alphabet[(chunk >> 18) & 63]);
+                out.push_back(alphabet[(chunk >> 12) & 63]);
+                out.push_back(i + 1 < size ? alphabet[(chunk >> 6) & 63] : '=');
+                out.push_back(i + 2 < size ? alphabet[chunk & 63] : '=');
+            }
+            return out;
+        }
+
+        template <typename T>
+        bool toNumber(std::string_view text, T &out) noexcept
+        {
+            auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), out);
+            return error == std::errc() && end == text.data() + text.size();
+        }
+    }
+
+    WebSocketFeedConfig WebSocketFeedConfig::fromEnvironment()
+    {
+        WebSocketFeedConfig config;
+
+        if (const char *url = std::getenv("QUANTIS_MD_WS_URL"))
+        {
+            config.url = url;
+        }
+
+        if (const char *subscribe = std::getenv("QUANTIS_MD_WS_SUBSCRIBE"))
+        {
+            config.subscribe = subscribe;
+        }
+
+        return config;
+    }
+
+    WebSocketFeed::WebSocketFeed(MarketDataStore &store, const WebSocketFeedConfig &config, TickDecoder decoder)
+        : store_(store), config_(config), decoder_(std::move(decoder)), buffer_(INITIAL_BUFFER)
+    {
+        std::random_device random;
+        maskState_ = (static_cast<uint64_t>(random()) << 32) | random() | 1;
+    }
+
+    WebSocketFeed::~WebSocketFeed()
+    {
+        stop();
+    }
+
+    bool WebSocketFeed::parseUrl(const std::string &url, std::string &host, std::string &port, std::string &path)
+    {
+        constexpr std::string_view scheme = "ws://";
+        if (url.compare(0, scheme.size(), scheme) != 0)
+        {
+            return false;
+        }
+
+        std::string rest = url.substr(scheme.size());
+        size_t slash = rest.find('/');
+        std::string authority = rest.substr(0, slash);
+        path = slash == std::string::npos ? "/" : rest.substr(slash);
+
+        size_t colon = authority.rfind(':');
+        if (colon != std::string::npos && authority.find(']') == std::string::npos)
+        {
+            host = authority.substr(0, colon);
+            port = authority.substr(colon + 1);
+        }
+        else
+        {
+            host = authority;
+            port = "80";
+        }
+
+        return !host.empty() && !port.empty();
+    }
+
+    bool WebSocketFeed::start()
+    {
+        if (running_.exchange(true))
+        {
+            return true;
+        }
+
+        if (!parseUrl(config_.url, host_, port_, path_))
+        {
+            running_.store(false);
+            std::cerr << "WebSocketFeed: unsupported URL " << config_.url << " (expected ws://host[:port]/path)" << std::endl;
+            return false;
+        }
+
+        try
+        {
+            thread_ = std::thread(&WebSocketFeed::run, this);
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            running_.store(false);
+            std::cerr << "Failed to start WebSocketFeed: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    void WebSocketFeed::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(waitMutex_);
+            if (!running_.exchange(false))
+            {
+                return;
+            }
+        }
+        wake_.notify_all();
+
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    FeedStats WebSocketFeed::getStats() const
+    {
+        FeedStats stats;
+        stats.name = config_.url;
+        stats.connected = connected_.load();
+        stats.messages = messages_.load();
+        stats.ticks = ticks_.load();
+        stats.ignored = ignored_.load();
+        stats.gaps = gaps_.load();
+        stats.lostTicks = lostTicks_.load();
+        stats.reconnects = reconnects_.load();
+        return stats;
+    }
+
+    bool WebSocketFeed::sleepFor(unsigned ms)
+    {
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        wake_.wait_for(lock, std::chrono::milliseconds(ms), [this]
+                       { return !running_.load(); });
+        return running_.load();
+    }
+
+    void WebSocketFeed::run()
+    {
+        unsigned backoffMs = config_.reconnectMinMs;
+        bool first = true;
+
+        while (running_.load())
+        {
+            if (!first)
+            {
+                reconnects_.fetch_add(1);
+            }
+            first = false;
+
+            if (connectSocket() && handshake() &&
+                (config_.subscribe.empty() || sendFrame(OP_TEXT, config_.subscribe)))
+            {
+                connected_.store(true);
+                sessionStart_ = true;
+                backoffMs = config_.reconnectMinMs;
+                std::cerr << "WebSocketFeed connected to " << config_.url << std::endl;
+
+                readLoop();
+
+                connected_.store(false);
+                std::cerr << "WebSocketFeed disconnected from " << config_.url << std::endl;
+            }
+            closeSocket();
+
+            if (!sleepFor(backoffMs))
+            {
+                break;
+            }
+            backoffMs = std::min(config_.reconnectMaxMs, backoffMs * 2);
+        }
+
+        closeSocket();
+    }
+
+    bool WebSocketFeed::connectSocket()
+    {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo *addresses = nullptr;
+        int rc = getaddrinfo(host_.c_str(), port_.c_str(), &hints, &addresses);
+        if (rc != 0)
+        {
+            std::cerr << "WebSocketFeed: cannot resolve " << host_ << ": " << gai_strerror(rc) << std::endl;
+            return false;
+        }
+
+        for (addrinfo *address = addresses; address && fd_ < 0; address = address->ai_next)
+        {
+            int fd = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, address->ai_protocol);
+            if (fd < 0)
+            {
+                continue;
+            }
+
+            if (connect(fd, address->ai_addr, address->ai_addrlen) != 0 && errno != EINPROGRESS)
+            {
+                close(fd);
+                continue;
+            }
+
+            pollfd pfd{fd, POLLOUT, 0};
+            int error = 0;
+            socklen_t length = sizeof(error);
+            if (poll(&pfd, 1, static_cast<int>(config_.connectTimeoutMs)) != 1 ||
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0)
+            {
+                close(fd);
+                continue;
+            }
+
+            // Ticks are small; never hold one back to coalesce
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            fd_ = fd;
+        }
+
+        freeaddrinfo(addresses);
+
+        if (fd_ < 0)
+        {
+            std::cerr << "WebSocketFeed: cannot connect to " << host_ << ":" << port_ << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool WebSocketFeed::handshake()
+    {
+        uint8_t nonce[16];
+        for (size_t i = 0; i < sizeof(nonce); ++i)
+        {
+            maskState_ ^= maskState_ << 13;
+            maskState_ ^= maskState_ >> 7;
+            maskState_ ^= maskState_ << 17;
+            nonce[i] = static_cast<uint8_t>(maskState_);
+        }
+        std::string key = base64(nonce, sizeof(nonce));
+
+        std::string request = "GET " + path_ + " HTTP/1.1\r\n"
+                              "Host: " + host_ + ":" + port_ + "\r\n"
+                              "Upgrade: websocket\r\n"
+                              "Connection: Upgrade\r\n"
+                              "Sec-WebSocket-Key: " + key + "\r\n"
+                              "Sec-WebSocket-Version: 13\r\n"
+                              "User-Agent: QuantisTradingEngine/1.0\r\n\r\n";
+        if (!sendAll(request.data(), request.size()))
+        {
+            return false;
+        }
+
+        // Read up to the end of the response headers; anything after them is already frame data
+        filled_ = 0;
+        uint64_t deadline = nowMs() + config_.connectTimeoutMs;
+        size_t headerEnd = std::string_view::npos;
+        while (headerEnd == std::string_view::npos)
+        {
+            uint64_t now = nowMs();
+            pollfd pfd{fd_, POLLIN, 0};
+            if (now >= deadline || filled_ == buffer_.size() ||
+                poll(&pfd, 1, static_cast<int>(deadline - now)) != 1)
+            {
+                std::cerr << "WebSocketFeed: no handshake response from " << config_.url << std::endl;
+                return false;
+            }
+
+            ssize_t received = recv(fd_, buffer_.data() + filled_, buffer_.size() - filled_, 0);
+            if (received <= 0)
+            {
+                if (received < 0 && (errno == EAGAIN || errno == EINTR))
+                {
+                    continue;
+                }
+                return false;
+            }
+            filled_ += static_cast<size_t>(received);
+            headerEnd = std::string_view(buffer_.data(), filled_).find("\r\n\r\n");
+        }
+
+        std::string headers(buffer_.data(), headerEnd);
+        std::transform(headers.begin(), headers.end(), headers.begin(), [](unsigned char c)
+                       { return static_cast<char>(std::tolower(c)); });
+
+        uint8_t digest[20];
+        sha1(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11", digest);
+        std::string accept = base64(digest, sizeof(digest));
+        std::string acceptLower = accept;
+        std::transform(acceptLower.begin(), acceptLower.end(), acceptLower.begin(), [](unsigned char c)
+                       { return static_cast<char>(std::tolower(c)); });
+
+        if (headers.compare(0, 12, "http/1.1 101") != 0 ||
+            headers.find("sec-websocket-accept: " + acceptLower) == std::string::npos)
+        {
+            std::cerr << "WebSocketFeed: " << config_.url << " refused the upgrade: "
+                      << std::string_view(buffer_.data(), std::min<size_t>(headerEnd, 64)) << std::endl;
+            return false;
+        }
+
+        size_t consumed = headerEnd + 4;
+        std::memmove(buffer_.data(), buffer_.data() + consumed, filled_ - consumed);
+        filled_ -= consumed;
+        fragment_.clear();
+        fragmented_ = false;
+        return true;
+    }
+
+    bool WebSocketFeed::readLoop()
+    {
+        uint64_t lastReceive = nowMs();
+        bool pinged = false;
+        bool open = true;
+
+        // Frames that arrived with the handshake response
+        size_t consumed = processFrames(open);
+
+        while (running_.load() && open)
+        {
+            if (consumed > 0)
+            {
+                std::memmove(buffer_.data(), buffer_.data() + consumed, filled_ - consumed);
+                filled_ -= consumed;
+                consumed = 0;
+            }
+
+            if (filled_ == buffer_.size())
+            {
+                if (buffer_.size() >= config_.maxMessageBytes + 14)
+                {
+                    std::cerr << "WebSocketFeed: message over " << config_.maxMessageBytes << " bytes" << std::endl;
+                    return false;
+                }
+                buffer_.resize(std::min(buffer_.size() * 2, config_.maxMessageBytes + 14));
+            }
+
+            pollfd pfd{fd_, POLLIN, 0};
+            int ready = poll(&pfd, 1, POLL_MS);
+            if (ready < 0 && errno != EINTR)
+            {
+                return false;
+            }
+
+            if (ready <= 0)
+            {
+                // Silence: probe with a ping, give up after two heartbeat intervals
+                uint64_t idle = nowMs() - lastReceive;
+                if (idle >= 2ULL * config_.heartbeatMs)
+                {
+                    std::cerr << "WebSocketFeed: " << config_.url << " silent for " << idle << "ms" << std::endl;
+                    return false;
+                }
+                if (idle >= config_.heartbeatMs && !pinged)
+                {
+                    pinged = sendFrame(OP_PING, {});
+                }
+                continue;
+            }
+
+            ssize_t received = recv(fd_, buffer_.data() + filled_, buffer_.size() - filled_, 0);
+            if (received <= 0)
+            {
+                if (received < 0 && (errno == EAGAIN || errno == EINTR))
+                {
+                    continue;
+                }
+                return false;
+            }
+
+            filled_ += static_cast<size_t>(received);
+            lastReceive = nowMs();
+            pinged = false;
+            consumed = processFrames(open);
+        }
+
+        return open;
+    }
+
+    size_t WebSocketFeed::processFrames(bool &open)
+    {
+        size_t offset = 0;
+        while (open && filled_ - offset >= 2)
+        {
+            auto *frame = reinterpret_cast<uint8_t *>(buffer_.data() + offset);
+            size_t available = filled_ - offset;
+
+            bool fin = (frame[0] & 0x80) != 0;
+            uint8_t opcode = frame[0] & 0x0F;
+            bool masked = (frame[1] & 0x80) != 0;
+            uint64_t length = frame[1] & 0x7F;
+            size_t header = 2;
+
+            if (length == 126)
+            {
+                if (available < 4)
+                {
+                    break;
+                }
+                length = (uint64_t(frame[2]) << 8) | frame[3];
+                header = 4;
+            }
+            else if (length == 127)
+            {
+                if (available < 10)
+                {
+                    break;
+                }
+                length = 0;
+                for (int i = 0; i < 8; ++i)
+                {
+                    length = (length << 8) | frame[2 + i];
+                }
+                header = 10;
+            }
+
+            if (length > config_.maxMessageBytes)
+            {
+                std::cerr << "WebSocketFeed: frame of " << length << " bytes" << std::endl;
+                open = false;
+                break;
+            }
+
+            size_t maskOffset = header;
+            header += masked ? 4 : 0;
+            if (available < header + length)
+            {
+                break;
+            }
+
+            char *payload = buffer_.data() + offset + header;
+            if (masked)
+            {
+                // Servers must not mask, but unmask rather than drop the stream if one does
+                for (size_t i = 0; i < length; ++i)
+                {
+                    payload[i] ^= static_cast<char>(frame[maskOffset + (i & 3)]);
+                }
+            }
+
+            open = handleFrame(fin, opcode, payload, static_cast<size_t>(length));
+            offset += header + static_cast<size_t>(length);
+        }
+        return offset;
+    }
+
+    bool WebSocketFeed::handleFrame(bool fin, uint8_t opcode, char *payload, size_t length)
+    {
+        switch (opcode)
+        {
+        case OP_TEXT:
+        case OP_BINARY:
+            if (fin && !fragmented_)
+            {
+                onMessage(std::string_view(payload, length));
+                return true;
+            }
+            fragment_.assign(payload, length);
+            fragmented_ = !fin;
+            if (fin)
+            {
+                onMessage(fragment_);
+            }
+            return true;
+
+        case OP_CONTINUATION:
+            if (!fragmented_)
+            {
+                return false;
+            }
+            if (fragment_.size() + length > config_.maxMessageBytes)
+            {
+                return false;
+            }
+            fragment_.append(payload, length);
+            if (fin)
+            {
+                fragmented_ = false;
+                onMessage(fragment_);
+            }
+            return true;
+
+        case OP_PING:
+            return sendFrame(OP_PONG, std::string_view(payload, length));
+
+        case OP_PONG:
+            return true;
+
+        case OP_CLOSE:
+            sendFrame(OP_CLOSE, std::string_view(payload, std::min<size_t>(length, 2)));
+            return false;
+
+        default:
+            return false;
+        }
+    }
+
+    void WebSocketFeed::onMessage(std::string_view message)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        messages_.fetch_add(1, std::memory_order_relaxed);
+
+        FeedTick tick;
+        if (!decoder_ || !decoder_(message, tick))
+        {
+            ignored_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (tick.sequence != 0)
+        {
+            if (tick.sequence <= lastSequence_ && !sessionStart_)
+            {
+                // Duplicate or replayed tick: the store already has something newer
+                ignored_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            if (lastSequence_ != 0 && tick.sequence > lastSequence_ + 1)
+            {
+                gaps_.fetch_add(1, std::memory_order_relaxed);
+                lostTicks_.fetch_add(tick.sequence - lastSequence_ - 1, std::memory_order_relaxed);
+                if (onGap_)
+                {
+                    onGap_(lastSequence_ + 1, tick.sequence);
+                }
+            }
+
+            lastSequence_ = tick.sequence;
+            sessionStart_ = false;
+        }
+
+        uint32_t index = store_.getOrCreateSymbolIndex(tick.symbol);
+        if (store_.updateMarketData(index, tick.bestBid, tick.bestAsk, tick.lastPrice, tick.volume))
+        {
+            ticks_.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            ignored_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start);
+        latencyHistogram(LatencyMetric::FeedTick).record(static_cast<uint64_t>(duration.count()));
+    }
+
+    bool WebSocketFeed::sendFrame(uint8_t opcode, std::string_view payload)
+    {
+        // Client frames are always masked (RFC 6455 5.3)
+        frameOut_.clear();
+        frameOut_.push_back(static_cast<char>(0x80 | opcode));
+        if (payload.size() < 126)
+        {
+            frameOut_.push_back(static_cast<char>(0x80 | payload.size()));
+        }
+        else if (payload.size() <= 0xFFFF)
+        {
+            frameOut_.push_back(static_cast<char>(0x80 | 126));
+            frameOut_.push_back(static_cast<char>(payload.size() >> 8));
+            frameOut_.push_back(static_cast<char>(payload.size()));
+        }
+        else
+        {
+            frameOut_.push_back(static_cast<char>(0x80 | 127));
+            for (int i = 7; i >= 0; --i)
+            {
+                frameOut_.push_back(static_cast<char>(static_cast<uint64_t>(payload.size()) >> (i * 8)));
+            }
+        }
+
+        maskState_ ^= maskState_ << 13;
+        maskState_ ^= maskState_ >> 7;
+        maskState_ ^= maskState_ << 17;
+        char mask[4];
+        std::memcpy(mask, &maskState_, sizeof(mask));
+        frameOut_.append(mask, sizeof(mask));
+
+        for (size_t i = 0; i < payload.size(); ++i)
+        {
+            frameOut_.push_back(static_cast<char>(payload[i] ^ mask[i & 3]));
+        }
+
+        return sendAll(frameOut_.data(), frameOut_.size());
+    }
+
+    bool WebSocketFeed::sendAll(const char *data, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t sent = send(fd_, data, size, MSG_NOSIGNAL);
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                pollfd pfd{fd_, POLLOUT, 0};
+                if (errno != EAGAIN || poll(&pfd, 1, static_cast<int>(config_.connectTimeoutMs)) != 1)
+                {
+                    return false;
+                }
+                continue;
+            }
+            data += sent;
+            size -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    void WebSocketFeed::closeSocket()
+    {
+        if (fd_ >= 0)
+        {
+            close(fd_);
+            fd_ = -1;
+        }
+        filled_ = 0;
+    }
+
+    bool WebSocketFeed::decodeJsonTick(std::string_view message, FeedTick &tick) noexcept
+    {
+        static constexpr std::string_view keys[] = {"s", "b", "a", "p", "v", "q"};
+        std::string_view values[6];
+        FastJsonParser::findFields(message, keys, values, 6);
+
+        if (values[0].empty() || values[3].empty() || !toNumber(values[3], tick.lastPrice))
+        {
+            return false;
+        }
+        tick.symbol = values[0];
+
+        tick.bestBid = tick.lastPrice;
+        tick.bestAsk = tick.lastPrice;
+        if ((!values[1].empty() && !toNumber(values[1], tick.bestBid)) ||
+            (!values[2].empty() && !toNumber(values[2], tick.bestAsk)) ||
+            (!values[4].empty() && !toNumber(values[4], tick.volume)) ||
+            (!values[5].empty() && !toNumber(values[5], tick.sequence)))
+        {
+            return false;
+        }
+        return true;
+    }
+
+} // namespace quantis
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "MarketDataFeed.h"
+#include "MarketDataStore.h"
+
+namespace quantis
+{
+
+    struct WebSocketFeedConfig
+    {
+        std::string url;       // ws://host[:port]/path; empty = no streaming feed
+        std::string subscribe; // text message sent after every (re)connect, e.g. a subscription request
+        unsigned connectTimeoutMs{2000};
+        unsigned heartbeatMs{5000};      // ping after this much silence, reconnect after twice it
+        unsigned reconnectMinMs{100};    // first reconnect delay, doubled per failed attempt
+        unsigned reconnectMaxMs{10000};
+        size_t maxMessageBytes{1 << 20}; // larger messages drop the connection
+
+        // Reads QUANTIS_MD_WS_URL and QUANTIS_MD_WS_SUBSCRIBE
+        static WebSocketFeedConfig fromEnvironment();
+
+        bool enabled() const noexcept { return !url.empty(); }
+    };
+
+    /**
+     * Streaming market data over a WebSocket (RFC 6455) connection
+     *
+     * A dedicated I/O thread connects, sends the subscription message and
+     * decodes every pushed message straight into MarketDataStore, in place
+     * in its receive buffer. Unfragmented messages are never copied. Silence
+     * past the heartbeat interval is probed with a ping; a dead connection is
+     * re-established with exponential backoff. Ticks that carry sequence
+     * numbers are checked for gaps, which are counted and reported to the
+     * gap handler. Plain ws:// only: TLS is expected to be terminated by a
+     * local proxy.
+     */
+    class WebSocketFeed : public MarketDataFeed
+    {
+    private:
+        MarketDataStore &store_;
+        WebSocketFeedConfig config_;
+        TickDecoder decoder_;
+        GapHandler onGap_;
+        std::string host_;
+        std::string port_;
+        std::string path_;
+
+        // I/O thread state
+        int fd_{-1};
+        std::vector<char> buffer_; // received bytes not yet parsed into frames
+        size_t filled_{0};
+        std::string fragment_; // payload of a fragmented message so far
+        bool fragmented_{false};
+        std::string frameOut_; // outgoing frame scratch
+        uint64_t maskState_;
+        uint64_t lastSequence_{0};
+        bool sessionStart_{true}; // next sequenced tick may restart the numbering
+
+        std::atomic<bool> running_{false};
+        std::atomic<bool> connected_{false};
+        std::atomic<uint64_t> messages_{0};
+        std::atomic<uint64_t> ticks_{0};
+        std::atomic<uint64_t> ignored_{0};
+        std::atomic<uint64_t> gaps_{0};
+        std::atomic<uint64_t> lostTicks_{0};
+        std::atomic<uint64_t> reconnects_{0};
+
+        std::mutex waitMutex_;
+        std::condition_variable wake_;
+        std::thread thread_;
+
+        void run();
+        bool connectSocket();
+        bool handshake();
+        bool readLoop();
+        size_t processFrames(bool &open);
+        bool handleFrame(bool fin, uint8_t opcode, char *payload, size_t length);
+        void onMessage(std::string_view message);
+        bool sendFrame(uint8_t opcode, std::string_view payload);
+        bool sendAll(const char *data, size_t size);
+        void closeSocket();
+        bool sleepFor(unsigned ms); // false once stopping
+
+    public:
+        WebSocketFeed(MarketDataStore &store, const WebSocketFeedConfig &config, TickDecoder decoder = decodeJsonTick);
+        ~WebSocketFeed() override;
+
+        WebSocketFeed(const WebSocketFeed &) = delete;
+        WebSocketFeed &operator=(const WebSocketFeed &) = delete;
+
+        // Set before start()
+        void setGapHandler(GapHandler handler) { onGap_ = std::move(handler); }
+
+        bool start() override;
+        void stop() override;
+        bool isRunning() const override { return running_.load(); }
+        FeedStats getStats() const override;
+
+        /**
+         * Default decoder: {"s":"AAPL","b":189.1,"a":189.2,"p":189.15,"v":1200,"q":42}.
+         * "s" and "p" are required; a missing bid or ask takes the price, a
+         * missing "q" leaves the tick unsequenced.
+         */
+        static bool decodeJsonTick(std::string_view message, FeedTick &tick) noexcept;
+
+        // Split ws://host[:port][/path]; false for any other scheme
+        static bool parseUrl(const std::string &url, std::string &host, std::string &port, std::string &path);
+    };
+
+} // namespace quantis
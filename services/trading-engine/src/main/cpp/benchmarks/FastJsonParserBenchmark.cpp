@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+#include "FastJsonParser.h"
+#include <string>
+#include <vector>
+
+using namespace quantis;
+
+namespace
+{
+
+    // A GLOBAL_QUOTE response as Alpha Vantage sends it
+    const std::string QUOTE_RESPONSE = R"({
+    "Global Quote": {
+        "01. symbol": "AAPL",
+        "02. open": "150.0000",
+        "03. high": "155.5000",
+        "04. low": "148.2500",
+        "05. price": "152.5000",
+        "06. volume": "1000000",
+        "07. latest trading day": "2024-01-05",
+        "08. previous close": "151.0000",
+        "09. change": "1.5000",
+        "10. change percent": "0.9934%"
+    }
+})";
+
+} // namespace
+
+// Structural pass plus field conversion, per response
+static void BM_ParseGlobalQuote(benchmark::State &state)
+{
+    FastJsonParser::MarketData data;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(FastJsonParser::parseGlobalQuote(QUOTE_RESPONSE, data));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(QUOTE_RESPONSE.size()));
+}
+
+// A round of responses through the batch entry point the service uses
+static void BM_ParseAlphaVantageBatch(benchmark::State &state)
+{
+    FastJsonParser parser;
+    size_t count = static_cast<size_t>(state.range(0));
+    std::vector<std::string_view> responses(count, QUOTE_RESPONSE);
+    std::vector<FastJsonParser::MarketData> quotes(count);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(parser.parseAlphaVantageBatch(responses.data(), count, quotes.data()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(count * QUOTE_RESPONSE.size()));
+}
+
+// Key lookup on its own, as the WebSocket tick decoder uses it
+static void BM_FindField(benchmark::State &state)
+{
+    std::string_view value;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(FastJsonParser::findField(QUOTE_RESPONSE, "05. price", value));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ParseGlobalQuote);
+BENCHMARK(BM_ParseAlphaVantageBatch)->Arg(8)->Arg(64);
+BENCHMARK(BM_FindField);
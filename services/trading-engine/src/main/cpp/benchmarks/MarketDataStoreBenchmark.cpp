@@ -0,0 +1,171 @@
+#include <benchmark/benchmark.h>
+#include "MarketDataStore.h"
+
+using namespace quantis;
+
+namespace
+{
+
+    constexpr uint32_t SYMBOLS = 64;
+
+    BookDepth fullDepth()
+    {
+        BookDepth depth;
+        depth.bidCount = depth.askCount = BookDepth::LEVELS;
+        for (uint32_t i = 0; i < BookDepth::LEVELS; ++i)
+        {
+            depth.bids[i] = DepthLevel{100.0 - 0.01 * i, 500, 5};
+            depth.asks[i] = DepthLevel{100.02 + 0.01 * i, 500, 5};
+        }
+        return depth;
+    }
+
+    MarketDataStore &benchmarkStore()
+    {
+        static MarketDataStore store;
+        static bool filled = [&]
+        {
+            for (uint32_t i = 0; i < SYMBOLS; ++i)
+            {
+                uint32_t index = store.getOrCreateSymbolIndex("S" + std::to_string(i));
+                store.updateMarketData(index, 100.0, 100.02, 100.01, 1000);
+                store.publishDepth(index, fullDepth(), 0, 0);
+            }
+            return true;
+        }();
+        (void)filled;
+        return store;
+    }
+
+} // namespace
+
+// Uncontended seqlock read of one symbol
+static void BM_StoreRead(benchmark::State &state)
+{
+    MarketDataStore &store = benchmarkStore();
+    MarketDataValues values;
+    uint32_t index = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(store.getMarketData(index, values));
+        index = (index + 1) % SYMBOLS;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Reader threads on the symbols thread 0 keeps rewriting: retries under write contention
+static void BM_StoreReadContended(benchmark::State &state)
+{
+    MarketDataStore &store = benchmarkStore();
+    MarketDataValues values;
+    uint32_t index = 0;
+    double price = 100.0;
+
+    for (auto _ : state)
+    {
+        if (state.thread_index() == 0)
+        {
+            price += 0.01;
+            benchmark::DoNotOptimize(store.updateMarketData(index, price, price + 0.02, price + 0.01, 1000));
+        }
+        else
+        {
+            benchmark::DoNotOptimize(store.getMarketData(index, values));
+        }
+        index = (index + 1) % 4;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Writers on disjoint symbols: seqlock stores plus the shared change ring
+static void BM_StoreWrite(benchmark::State &state)
+{
+    MarketDataStore &store = benchmarkStore();
+    uint32_t base = static_cast<uint32_t>(state.thread_index()) * 4 % SYMBOLS;
+    uint32_t offset = 0;
+    double price = 100.0;
+
+    for (auto _ : state)
+    {
+        price += 0.01;
+        benchmark::DoNotOptimize(store.updateMarketData(base + offset, price, price + 0.02, price + 0.01, 1000));
+        offset = (offset + 1) % 4;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// The string lookup in front of every by-symbol call
+static void BM_StoreReadBySymbol(benchmark::State &state)
+{
+    MarketDataStore &store = benchmarkStore();
+    std::string symbol = "S17";
+    double bestBid, bestAsk, lastPrice, spread;
+    long volume;
+    uint64_t timestamp;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(store.getMarketData(symbol, bestBid, bestAsk, lastPrice, spread, volume, timestamp));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// One bulk pass over every symbol, as the dashboard reads the store
+static void BM_StoreSnapshotAll(benchmark::State &state)
+{
+    MarketDataStore &store = benchmarkStore();
+    std::vector<MarketDataRecord> records(SYMBOLS);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(store.snapshotAll(records.data(), records.size()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * SYMBOLS);
+}
+
+// Full top-of-book depth copy for one symbol
+static void BM_StoreDepthRead(benchmark::State &state)
+{
+    MarketDataStore &store = benchmarkStore();
+    BookDepth depth;
+    uint32_t index = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(store.getDepth(index, depth));
+        index = (index + 1) % SYMBOLS;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// What a book publishes after a fill at the touch: one ask level rewritten
+static void BM_StoreDepthPublishTouch(benchmark::State &state)
+{
+    MarketDataStore &store = benchmarkStore();
+    BookDepth depth = fullDepth();
+    uint32_t index = 0;
+
+    for (auto _ : state)
+    {
+        depth.asks[0].quantity = 100 + (depth.asks[0].quantity + 1) % 400;
+        benchmark::DoNotOptimize(store.publishDepth(index, depth, depth.bidCount, 0));
+        index = (index + 1) % SYMBOLS;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_StoreRead);
+BENCHMARK(BM_StoreReadContended)->ThreadRange(2, 8)->UseRealTime();
+BENCHMARK(BM_StoreWrite)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_StoreReadBySymbol);
+BENCHMARK(BM_StoreSnapshotAll);
+BENCHMARK(BM_StoreDepthRead);
+BENCHMARK(BM_StoreDepthPublishTouch);
@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+#include "OrderBook.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace quantis;
+
+namespace
+{
+
+    // A book filled to its benchmark depth, plus the handle sequence for its orders
+    struct Flow
+    {
+        std::unique_ptr<OrderBook> book;
+        uint64_t sequence{0};
+
+        OrderRequest order(Side side, double price, int64_t quantity)
+        {
+            OrderRequest request;
+            request.handle = makeOrderHandle(book->getSymbolIndex(), ++sequence);
+            request.userIndex = 1;
+            request.side = side;
+            request.price = price;
+            request.quantity = quantity;
+            return request;
+        }
+
+        // depth levels a side, one order each, bids from 99.99 down and asks from firstAsk up
+        void fill(int64_t depth, double firstAsk)
+        {
+            for (int64_t level = 0; level < depth; ++level)
+            {
+                book->addOrder(order(Side::Buy, 99.99 - 0.01 * static_cast<double>(level), 100));
+                book->addOrder(order(Side::Sell, firstAsk + 0.01 * static_cast<double>(level), 100));
+            }
+        }
+    };
+
+    // Every benchmark leaves its book as it found it, so one book per benchmark and
+    // arguments is built once and reused across the library's repeated runs
+    Flow &flowFor(const char *benchmark, const benchmark::State &state, double firstAsk = 100.01)
+    {
+        static std::map<std::string, Flow> flows;
+
+        std::string key = std::string(benchmark) + "/" + std::to_string(state.range(0)) + "/" + std::to_string(state.range(1));
+        auto it = flows.find(key);
+        if (it == flows.end())
+        {
+            BookConfig config;
+            config.type = state.range(1) ? BookType::TickLadder : BookType::Map;
+
+            // Store symbols are at most 7 characters
+            std::string symbol = "BM" + std::to_string(flows.size());
+            it = flows.emplace(key, Flow{}).first;
+            it->second.book = std::make_unique<OrderBook>(symbol, config);
+            it->second.fill(state.range(0), firstAsk);
+        }
+        return it->second;
+    }
+
+} // namespace
+
+// Rest an order inside the book and cancel it again
+static void BM_OrderBookAddCancel(benchmark::State &state)
+{
+    Flow &flow = flowFor("addCancel", state);
+    OrderBook &book = *flow.book;
+    double price = 99.99 - 0.01 * static_cast<double>(state.range(0) / 2);
+
+    for (auto _ : state)
+    {
+        OrderRequest request = flow.order(Side::Buy, price, 10);
+        benchmark::DoNotOptimize(book.addOrder(request));
+        benchmark::DoNotOptimize(book.removeOrder(request.handle));
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Rest an order at the best ask and take it with a marketable buy
+static void BM_OrderBookMatch(benchmark::State &state)
+{
+    Flow &flow = flowFor("match", state);
+    OrderBook &book = *flow.book;
+    std::vector<Trade> trades;
+    trades.reserve(16);
+
+    for (auto _ : state)
+    {
+        book.addOrder(flow.order(Side::Sell, 100.00, 10));
+        trades.clear();
+        benchmark::DoNotOptimize(book.matchOrder(flow.order(Side::Buy, 100.00, 10), trades));
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Sweep several levels of the ask side, then put them back
+static void BM_OrderBookSweep(benchmark::State &state)
+{
+    constexpr int LEVELS = 5;
+    // The swept levels rest from 100.00 up, between the best bid and the seeded asks
+    Flow &flow = flowFor("sweep", state, 100.00 + 0.01 * LEVELS);
+    OrderBook &book = *flow.book;
+    std::vector<Trade> trades;
+    trades.reserve(LEVELS);
+
+    for (auto _ : state)
+    {
+        for (int level = 0; level < LEVELS; ++level)
+        {
+            book.addOrder(flow.order(Side::Sell, 100.00 + 0.01 * level, 10));
+        }
+        trades.clear();
+        book.matchOrder(flow.order(Side::Buy, 100.00 + 0.01 * (LEVELS - 1), 10 * LEVELS), trades);
+        benchmark::DoNotOptimize(trades.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * LEVELS);
+}
+
+// Args: resting levels per side, book type (0 = Map, 1 = TickLadder)
+#define BOOK_DEPTHS ArgsProduct({{1, 10, 100, 1000}, {0, 1}})->ArgNames({"depth", "ladder"})
+
+BENCHMARK(BM_OrderBookAddCancel)->BOOK_DEPTHS;
+BENCHMARK(BM_OrderBookMatch)->BOOK_DEPTHS;
+BENCHMARK(BM_OrderBookSweep)->BOOK_DEPTHS;
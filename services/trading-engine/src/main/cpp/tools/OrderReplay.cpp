@@ -0,0 +1,478 @@
+// Replays a captured or synthetic order flow through the matching engine and
+// reports per-operation latency, throughput and allocations per operation.
+//
+//   quantis_replay --synthetic hawkes --events 2000000 --rate 200000 --write flow.qrp
+//   quantis_replay --capture flow.qrp --speed 1 --threads 4 --shards 4 --book ladder --json run.json
+//   quantis_replay --journal /var/lib/quantis/journal-copy
+
+#include "ReplayCapture.h"
+#include "CpuRelax.h"
+#include "LatencyHistogram.h"
+#include "MatchingEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace quantis;
+
+// ==================== ALLOCATION COUNTING ====================
+// Every heap allocation in the process, engine threads included
+
+namespace
+{
+
+    std::atomic<uint64_t> g_allocations{0};
+    std::atomic<uint64_t> g_allocatedBytes{0};
+
+    void *countedAlloc(size_t size, size_t alignment)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        void *p = alignment > alignof(std::max_align_t)
+                      ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                      : std::malloc(size == 0 ? 1 : size);
+        if (!p)
+        {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+} // namespace
+
+void *operator new(size_t size) { return countedAlloc(size, 0); }
+void *operator new[](size_t size) { return countedAlloc(size, 0); }
+void *operator new(size_t size, std::align_val_t alignment) { return countedAlloc(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment) { return countedAlloc(size, static_cast<size_t>(alignment)); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace
+{
+
+    struct ReplayOptions
+    {
+        std::string capturePath;
+        std::string journalDirectory;
+        bool synthetic{false};
+        SyntheticFlowConfig flow;
+        std::string writePath;
+        std::string jsonPath;
+        double speed{0.0}; // multiple of the recorded pace; 0 = as fast as possible
+        size_t threads{1};
+        long shards{-1}; // -1 = QUANTIS_ENGINE_SHARDS
+        BookType bookType{BookType::Map};
+        double tickSize{0.01};
+    };
+
+    constexpr size_t OP_KINDS = 4;
+    constexpr const char *OP_NAMES[OP_KINDS] = {"new", "cancel", "amend", "marketData"};
+
+    size_t opSlot(uint8_t op) noexcept { return static_cast<size_t>(op - 1) % OP_KINDS; }
+
+    struct alignas(64) DriverStats
+    {
+        uint64_t ops[OP_KINDS]{};
+        uint64_t rejects[OP_KINDS]{};
+        uint64_t trades{0};
+    };
+
+    // Everything the run needs, built before the clock starts
+    struct Replay
+    {
+        const ReplayOptions &options;
+        MatchingEngine engine;
+        std::vector<OrderBook *> books;      // by capture symbol
+        std::vector<uint32_t> storeIndices;  // by capture symbol
+        std::vector<OrderHandle> handles;    // by capture order ID; each ID is only touched by its symbol's thread
+        std::vector<std::vector<CaptureRecord>> partitions; // by driver thread
+        std::vector<DriverStats> stats;
+        LatencyHistogram latency[OP_KINDS]{LatencyHistogram("new"), LatencyHistogram("cancel"), LatencyHistogram("amend"), LatencyHistogram("marketData")};
+        LatencyHistogram lag{"lag"}; // how late each paced operation started against its schedule
+
+        Replay(const ReplayOptions &opts, const EngineConfig &config) : options(opts), engine(config) {}
+    };
+
+    uint64_t elapsedNs(std::chrono::steady_clock::time_point since)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count());
+    }
+
+    void waitUntil(std::chrono::steady_clock::time_point deadline)
+    {
+        // Sleep most of the way, then spin so the operation starts on time
+        auto now = std::chrono::steady_clock::now();
+        if (deadline - now > std::chrono::microseconds(200))
+        {
+            std::this_thread::sleep_for(deadline - now - std::chrono::microseconds(100));
+        }
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            cpuRelax();
+        }
+    }
+
+    void drive(Replay &replay, size_t thread, std::chrono::steady_clock::time_point start)
+    {
+        DriverStats &stats = replay.stats[thread];
+        MarketDataStore &store = getMarketDataStore();
+        std::vector<Trade> trades;
+        trades.reserve(256);
+        double speed = replay.options.speed;
+
+        for (const CaptureRecord &record : replay.partitions[thread])
+        {
+            if (speed > 0.0)
+            {
+                auto due = start + std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(record.timestampNs) / speed));
+                waitUntil(due);
+                auto late = std::chrono::steady_clock::now() - due;
+                replay.lag.record(static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(late).count())));
+            }
+
+            size_t slot = opSlot(record.op);
+            OrderBook *book = replay.books[record.symbol];
+            OrderRequest request;
+            request.userIndex = record.userIndex;
+            request.side = record.side ? Side::Sell : Side::Buy;
+            request.price = record.price;
+            request.quantity = record.quantity;
+
+            bool ok = false;
+            auto opStart = std::chrono::steady_clock::now();
+            switch (static_cast<CaptureOp>(record.op))
+            {
+            case CaptureOp::New:
+                request.handle = replay.engine.newOrderHandle(*book);
+                replay.handles[record.orderId] = request.handle;
+                trades.clear();
+                ok = replay.engine.matchOrder(*book, request, trades);
+                break;
+            case CaptureOp::Cancel:
+                ok = replay.engine.removeOrder(replay.handles[record.orderId]);
+                break;
+            case CaptureOp::Amend:
+                request.handle = replay.handles[record.orderId];
+                ok = replay.engine.updateOrder(request);
+                break;
+            case CaptureOp::MarketData:
+                ok = store.updateMarketData(replay.storeIndices[record.symbol], record.bestBid, record.bestAsk, record.price, static_cast<long>(record.quantity));
+                break;
+            }
+            replay.latency[slot].record(elapsedNs(opStart));
+
+            ++stats.ops[slot];
+            if (!ok)
+            {
+                ++stats.rejects[slot];
+            }
+            if (record.op == static_cast<uint8_t>(CaptureOp::New))
+            {
+                stats.trades += trades.size();
+            }
+        }
+    }
+
+    bool parseArguments(int argc, char **argv, ReplayOptions &options)
+    {
+        auto value = [&](int &i) -> const char *
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << argv[i] << " needs a value" << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        static const char *const KNOWN[] = {"--capture", "--journal", "--synthetic", "--events", "--rate", "--symbols", "--branching",
+                                            "--decay", "--seed", "--write", "--json", "--speed", "--threads", "--shards", "--book", "--tick"};
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (std::none_of(std::begin(KNOWN), std::end(KNOWN), [&](const char *known)
+                             { return arg == known; }))
+            {
+                if (arg != "--help" && arg != "-h")
+                {
+                    std::cerr << "Unknown option " << arg << std::endl;
+                }
+                return false;
+            }
+
+            const char *v = value(i);
+            if (!v)
+            {
+                return false;
+            }
+
+            if (arg == "--capture")
+            {
+                options.capturePath = v;
+            }
+            else if (arg == "--journal")
+            {
+                options.journalDirectory = v;
+            }
+            else if (arg == "--synthetic")
+            {
+                options.synthetic = true;
+                options.flow.process = std::strcmp(v, "hawkes") == 0 ? ArrivalProcess::Hawkes : ArrivalProcess::Poisson;
+            }
+            else if (arg == "--events")
+            {
+                options.flow.events = std::strtoull(v, nullptr, 10);
+            }
+            else if (arg == "--rate")
+            {
+                options.flow.eventsPerSecond = std::strtod(v, nullptr);
+            }
+            else if (arg == "--symbols")
+            {
+                options.flow.symbols = std::strtoull(v, nullptr, 10);
+            }
+            else if (arg == "--branching")
+            {
+                options.flow.hawkesBranching = std::strtod(v, nullptr);
+            }
+            else if (arg == "--decay")
+            {
+                options.flow.hawkesBeta = std::strtod(v, nullptr);
+            }
+            else if (arg == "--seed")
+            {
+                options.flow.seed = std::strtoull(v, nullptr, 10);
+            }
+            else if (arg == "--write")
+            {
+                options.writePath = v;
+            }
+            else if (arg == "--json")
+            {
+                options.jsonPath = v;
+            }
+            else if (arg == "--speed")
+            {
+                options.speed = std::strtod(v, nullptr);
+            }
+            else if (arg == "--threads")
+            {
+                options.threads = std::max<size_t>(1, std::strtoull(v, nullptr, 10));
+            }
+            else if (arg == "--shards")
+            {
+                options.shards = std::strtol(v, nullptr, 10);
+            }
+            else if (arg == "--book")
+            {
+                options.bookType = std::strcmp(v, "ladder") == 0 ? BookType::TickLadder : BookType::Map;
+            }
+            else if (arg == "--tick")
+            {
+                options.tickSize = std::strtod(v, nullptr);
+                options.flow.tickSize = options.tickSize;
+            }
+        }
+
+        int sources = !options.capturePath.empty() + !options.journalDirectory.empty() + options.synthetic;
+        if (sources != 1)
+        {
+            std::cerr << "Give exactly one of --capture, --journal or --synthetic" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Usage: quantis_replay (--capture FILE | --journal DIR | --synthetic poisson|hawkes) [options]\n"
+                     "  --events N        synthetic events (1000000)\n"
+                     "  --rate R          synthetic mean events per second (100000)\n"
+                     "  --symbols N       synthetic symbols, activity falling off by rank (16)\n"
+                     "  --branching B     Hawkes events triggered per event (0.8)\n"
+                     "  --decay D         Hawkes excitation decay per second (2000)\n"
+                     "  --seed S          synthetic seed (42)\n"
+                     "  --write FILE      save the flow as a capture before replaying it\n"
+                     "  --speed X         replay at X times the recorded pace; 0 = max speed (0)\n"
+                     "  --threads N       driver threads, symbols split between them (1)\n"
+                     "  --shards N        engine shards; 0 = inline (QUANTIS_ENGINE_SHARDS)\n"
+                     "  --book map|ladder book backend (map)\n"
+                     "  --tick T          tick size (0.01)\n"
+                     "  --json FILE       also write the report as JSON\n";
+    }
+
+    void writeSummary(std::ostream &out, const LatencySummary &summary)
+    {
+        out << "{\"count\": " << summary.count << ", \"meanNs\": " << summary.meanNs << ", \"p50Ns\": " << summary.p50Ns
+            << ", \"p99Ns\": " << summary.p99Ns << ", \"p999Ns\": " << summary.p999Ns << ", \"maxNs\": " << summary.maxNs << "}";
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ReplayOptions options;
+    if (!parseArguments(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+
+    Capture capture;
+    if (options.synthetic)
+    {
+        generateSyntheticFlow(options.flow, capture);
+    }
+    else if (!options.capturePath.empty() ? !readCapture(options.capturePath, capture) : !importJournal(options.journalDirectory, capture))
+    {
+        return 1;
+    }
+
+    if (!options.writePath.empty() && !writeCapture(options.writePath, capture))
+    {
+        return 1;
+    }
+
+    EngineConfig config = EngineConfig::fromEnvironment();
+    if (options.shards >= 0)
+    {
+        config.shards = static_cast<size_t>(options.shards);
+    }
+    Replay replay(options, config);
+
+    BookConfig bookConfig;
+    bookConfig.type = options.bookType;
+    bookConfig.tickSize = options.tickSize;
+    replay.engine.setDefaultBookConfig(bookConfig);
+
+    for (const auto &symbol : capture.symbols)
+    {
+        OrderBook *book = replay.engine.getOrCreateBook(symbol);
+        if (!book)
+        {
+            std::cerr << "Cannot create a book for " << symbol << std::endl;
+            return 1;
+        }
+        replay.books.push_back(book);
+        replay.storeIndices.push_back(book->getSymbolIndex());
+    }
+
+    // Symbols are split across driver threads, so every book still sees its own flow in order
+    replay.handles.assign(capture.maxOrderId + 1, INVALID_ORDER_HANDLE);
+    replay.partitions.resize(options.threads);
+    replay.stats.resize(options.threads);
+    for (const auto &record : capture.records)
+    {
+        replay.partitions[record.symbol % options.threads].push_back(record);
+    }
+
+    std::cout << "Replaying " << capture.records.size() << " events over " << capture.symbols.size() << " symbols: "
+              << options.threads << " driver thread(s), " << config.shards << " shard(s), "
+              << (options.bookType == BookType::TickLadder ? "tick ladder" : "price map") << " books, "
+              << (options.speed > 0.0 ? std::to_string(options.speed) + "x recorded pace" : std::string("max speed")) << std::endl;
+
+    std::barrier ready(static_cast<std::ptrdiff_t>(options.threads + 1));
+    std::chrono::steady_clock::time_point start;
+    std::vector<std::thread> drivers;
+    for (size_t t = 0; t < options.threads; ++t)
+    {
+        drivers.emplace_back([&, t]
+                             {
+            ready.arrive_and_wait(); // start set
+            ready.arrive_and_wait();
+            drive(replay, t, start); });
+    }
+
+    ready.arrive_and_wait();
+    uint64_t allocationsBefore = g_allocations.load();
+    uint64_t bytesBefore = g_allocatedBytes.load();
+    start = std::chrono::steady_clock::now();
+    ready.arrive_and_wait();
+    for (auto &driver : drivers)
+    {
+        driver.join();
+    }
+    double seconds = static_cast<double>(elapsedNs(start)) * 1e-9;
+    uint64_t allocations = g_allocations.load() - allocationsBefore;
+    uint64_t allocatedBytes = g_allocatedBytes.load() - bytesBefore;
+
+    DriverStats total;
+    for (const auto &stats : replay.stats)
+    {
+        for (size_t i = 0; i < OP_KINDS; ++i)
+        {
+            total.ops[i] += stats.ops[i];
+            total.rejects[i] += stats.rejects[i];
+        }
+        total.trades += stats.trades;
+    }
+    uint64_t ops = total.ops[0] + total.ops[1] + total.ops[2] + total.ops[3];
+    double perOp = ops ? 1.0 / static_cast<double>(ops) : 0.0;
+
+    std::printf("\n%-11s %10s %9s %9s %9s %9s %9s %11s\n", "operation", "count", "rejects", "mean ns", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+    for (size_t i = 0; i < OP_KINDS; ++i)
+    {
+        LatencySummary summary = replay.latency[i].summarize();
+        std::printf("%-11s %10llu %9llu %9.0f %9llu %9llu %9llu %11llu\n", OP_NAMES[i],
+                    static_cast<unsigned long long>(total.ops[i]), static_cast<unsigned long long>(total.rejects[i]), summary.meanNs,
+                    static_cast<unsigned long long>(summary.p50Ns), static_cast<unsigned long long>(summary.p99Ns),
+                    static_cast<unsigned long long>(summary.p999Ns), static_cast<unsigned long long>(summary.maxNs));
+    }
+
+    std::printf("\n%.3f s, %.0f ops/s, %llu trades (%.0f trades/s), %.4f allocations/op, %.1f bytes/op\n", seconds,
+                static_cast<double>(ops) / seconds, static_cast<unsigned long long>(total.trades), static_cast<double>(total.trades) / seconds,
+                static_cast<double>(allocations) * perOp, static_cast<double>(allocatedBytes) * perOp);
+
+    LatencySummary lag = replay.lag.summarize();
+    if (options.speed > 0.0)
+    {
+        std::printf("schedule lag: p50 %llu ns, p99 %llu ns, max %llu ns\n", static_cast<unsigned long long>(lag.p50Ns),
+                    static_cast<unsigned long long>(lag.p99Ns), static_cast<unsigned long long>(lag.maxNs));
+    }
+
+    if (!options.jsonPath.empty())
+    {
+        std::ofstream json(options.jsonPath);
+        json << "{\n  \"events\": " << capture.records.size() << ",\n  \"symbols\": " << capture.symbols.size()
+             << ",\n  \"threads\": " << options.threads << ",\n  \"shards\": " << config.shards
+             << ",\n  \"book\": \"" << (options.bookType == BookType::TickLadder ? "ladder" : "map") << "\""
+             << ",\n  \"speed\": " << options.speed << ",\n  \"seconds\": " << seconds
+             << ",\n  \"opsPerSecond\": " << static_cast<double>(ops) / seconds
+             << ",\n  \"trades\": " << total.trades << ",\n  \"tradesPerSecond\": " << static_cast<double>(total.trades) / seconds
+             << ",\n  \"allocationsPerOp\": " << static_cast<double>(allocations) * perOp
+             << ",\n  \"bytesPerOp\": " << static_cast<double>(allocatedBytes) * perOp << ",\n  \"operations\": {";
+        for (size_t i = 0; i < OP_KINDS; ++i)
+        {
+            json << (i ? "," : "") << "\n    \"" << OP_NAMES[i] << "\": {\"rejects\": " << total.rejects[i] << ", \"latency\": ";
+            writeSummary(json, replay.latency[i].summarize());
+            json << "}";
+        }
+        json << "\n  },\n  \"scheduleLag\": ";
+        writeSummary(json, lag);
+        json << "\n}\n";
+        if (!json)
+        {
+            std::cerr << "Error writing " << options.jsonPath << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,309 @@
+#include "ReplayCapture.h"
+#include "EventJournal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+namespace quantis
+{
+
+    namespace
+    {
+
+        constexpr char CAPTURE_MAGIC[8] = {'Q', 'R', 'P', 'L', 'A', 'Y', 0, 0};
+
+        struct FileCloser
+        {
+            void operator()(FILE *file) const noexcept { std::fclose(file); }
+        };
+        using File = std::unique_ptr<FILE, FileCloser>;
+
+    } // namespace
+
+    bool readCapture(const std::string &path, Capture &capture)
+    {
+        File file(std::fopen(path.c_str(), "rb"));
+        if (!file)
+        {
+            std::cerr << "Cannot open capture " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        CaptureFileHeader header{};
+        if (std::fread(&header, sizeof(header), 1, file.get()) != 1 ||
+            std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0)
+        {
+            std::cerr << path << " is not a replay capture" << std::endl;
+            return false;
+        }
+        if (header.version != CAPTURE_VERSION)
+        {
+            std::cerr << path << ": unsupported capture version " << header.version << std::endl;
+            return false;
+        }
+
+        capture.symbols.clear();
+        for (uint32_t i = 0; i < header.symbolCount; ++i)
+        {
+            char name[CAPTURE_SYMBOL_BYTES + 1] = {};
+            if (std::fread(name, CAPTURE_SYMBOL_BYTES, 1, file.get()) != 1)
+            {
+                std::cerr << path << ": truncated symbol table" << std::endl;
+                return false;
+            }
+            capture.symbols.emplace_back(name);
+        }
+
+        capture.records.resize(header.recordCount);
+        if (header.recordCount > 0 &&
+            std::fread(capture.records.data(), sizeof(CaptureRecord), header.recordCount, file.get()) != header.recordCount)
+        {
+            std::cerr << path << ": truncated after " << capture.records.size() << " records" << std::endl;
+            return false;
+        }
+
+        capture.maxOrderId = header.maxOrderId;
+        for (const auto &record : capture.records)
+        {
+            if (record.op < static_cast<uint8_t>(CaptureOp::New) || record.op > static_cast<uint8_t>(CaptureOp::MarketData) ||
+                record.symbol >= capture.symbols.size() || record.orderId > capture.maxOrderId)
+            {
+                std::cerr << path << ": record out of range" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool writeCapture(const std::string &path, const Capture &capture)
+    {
+        File file(std::fopen(path.c_str(), "wb"));
+        if (!file)
+        {
+            std::cerr << "Cannot create capture " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        CaptureFileHeader header{};
+        std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+        header.version = CAPTURE_VERSION;
+        header.symbolCount = static_cast<uint32_t>(capture.symbols.size());
+        header.recordCount = capture.records.size();
+        header.maxOrderId = capture.maxOrderId;
+
+        bool ok = std::fwrite(&header, sizeof(header), 1, file.get()) == 1;
+        for (const auto &symbol : capture.symbols)
+        {
+            char name[CAPTURE_SYMBOL_BYTES] = {};
+            std::memcpy(name, symbol.data(), std::min(symbol.size(), CAPTURE_SYMBOL_BYTES));
+            ok = ok && std::fwrite(name, CAPTURE_SYMBOL_BYTES, 1, file.get()) == 1;
+        }
+        ok = ok && std::fwrite(capture.records.data(), sizeof(CaptureRecord), capture.records.size(), file.get()) == capture.records.size();
+        ok = std::fflush(file.get()) == 0 && ok;
+
+        if (!ok)
+        {
+            std::cerr << "Error writing capture " << path << ": " << std::strerror(errno) << std::endl;
+        }
+        return ok;
+    }
+
+    bool importJournal(const std::string &directory, Capture &capture)
+    {
+        EventJournal::Options options;
+        options.directory = directory;
+        auto journal = EventJournal::open(options);
+        if (!journal)
+        {
+            return false;
+        }
+
+        capture = Capture{};
+        std::unordered_map<uint32_t, uint16_t> symbolsByIndex; // journal symbol index -> capture symbol
+        std::unordered_map<OrderHandle, uint64_t> orderIds;
+        size_t skipped = 0;
+
+        journal->replay(0, [&](const EventHeader &header, const uint8_t *payload, size_t payloadSize)
+                        {
+            auto type = static_cast<EventType>(header.type);
+            if (type == EventType::Book && payloadSize >= sizeof(BookEvent))
+            {
+                BookEvent book;
+                std::memcpy(&book, payload, sizeof(book));
+                if (payloadSize >= sizeof(BookEvent) + book.symbolLength && !symbolsByIndex.contains(book.symbolIndex))
+                {
+                    symbolsByIndex[book.symbolIndex] = static_cast<uint16_t>(capture.symbols.size());
+                    capture.symbols.emplace_back(reinterpret_cast<const char *>(payload) + sizeof(BookEvent), book.symbolLength);
+                }
+                return;
+            }
+
+            if ((type != EventType::New && type != EventType::Cancel && type != EventType::Amend) || payloadSize < sizeof(OrderEvent))
+            {
+                return;
+            }
+
+            OrderEvent event;
+            std::memcpy(&event, payload, sizeof(event));
+            auto symbol = symbolsByIndex.find(handleSymbolIndex(event.handle));
+            if (symbol == symbolsByIndex.end())
+            {
+                ++skipped;
+                return;
+            }
+
+            CaptureRecord record{};
+            record.symbol = symbol->second;
+            record.userIndex = event.userIndex;
+            record.side = event.side;
+            record.price = event.price;
+            record.quantity = event.quantity;
+
+            if (type == EventType::New)
+            {
+                record.op = static_cast<uint8_t>(CaptureOp::New);
+                record.orderId = orderIds[event.handle] = ++capture.maxOrderId;
+            }
+            else
+            {
+                auto id = orderIds.find(event.handle);
+                if (id == orderIds.end())
+                {
+                    // The order's New was compacted into a snapshot
+                    ++skipped;
+                    return;
+                }
+                record.op = static_cast<uint8_t>(type == EventType::Cancel ? CaptureOp::Cancel : CaptureOp::Amend);
+                record.orderId = id->second;
+            }
+            capture.records.push_back(record); });
+
+        if (skipped > 0)
+        {
+            std::cerr << "Skipped " << skipped << " journal events for orders or books before the oldest segment" << std::endl;
+        }
+        return true;
+    }
+
+    void generateSyntheticFlow(const SyntheticFlowConfig &config, Capture &capture)
+    {
+        capture = Capture{};
+        std::mt19937_64 rng(config.seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        size_t symbolCount = std::clamp<size_t>(config.symbols, 1, UINT16_MAX);
+        std::vector<double> weights(symbolCount);
+        for (size_t i = 0; i < symbolCount; ++i)
+        {
+            capture.symbols.push_back("SYN" + std::to_string(i));
+            weights[i] = 1.0 / static_cast<double>(i + 1);
+        }
+        std::discrete_distribution<size_t> pickSymbol(weights.begin(), weights.end());
+
+        // Mid prices random-walk in ticks; limit orders sit a geometric number of ticks off the touch
+        std::vector<double> mids(symbolCount, 100.0);
+        struct LiveOrder
+        {
+            uint64_t orderId;
+            uint8_t side;
+        };
+        std::vector<std::vector<LiveOrder>> live(symbolCount); // orders the generator may cancel or amend
+        std::geometric_distribution<int> ticksAway(0.3);
+        std::uniform_int_distribution<int> lots(1, 5);
+        std::uniform_int_distribution<uint32_t> pickUser(1, std::max<uint32_t>(config.users, 1));
+
+        double rate = std::max(config.eventsPerSecond, 1.0);
+        double branching = std::clamp(config.hawkesBranching, 0.0, 0.99);
+        double beta = std::max(config.hawkesBeta, 1e-3);
+        double baseline = config.process == ArrivalProcess::Hawkes ? rate * (1.0 - branching) : rate;
+        double excitation = 0.0; // Hawkes intensity above the baseline at time t
+        double t = 0.0;
+
+        capture.records.reserve(config.events);
+        while (capture.records.size() < config.events)
+        {
+            if (config.process == ArrivalProcess::Poisson)
+            {
+                t += -std::log(1.0 - unit(rng)) / rate;
+            }
+            else
+            {
+                // Ogata thinning: the intensity only decays between events, so its value now bounds it
+                while (true)
+                {
+                    double bound = baseline + excitation;
+                    double gap = -std::log(1.0 - unit(rng)) / bound;
+                    t += gap;
+                    excitation *= std::exp(-beta * gap);
+                    if (unit(rng) * bound <= baseline + excitation)
+                    {
+                        break;
+                    }
+                }
+                excitation += branching * beta;
+            }
+
+            size_t symbol = pickSymbol(rng);
+            CaptureRecord record{};
+            record.timestampNs = static_cast<uint64_t>(t * 1e9);
+            record.symbol = static_cast<uint16_t>(symbol);
+            record.userIndex = pickUser(rng);
+
+            double &mid = mids[symbol];
+            auto &orders = live[symbol];
+            double roll = unit(rng);
+
+            if (roll < config.marketDataRatio)
+            {
+                mid = std::max(config.tickSize, mid + config.tickSize * static_cast<double>(static_cast<int>(rng() % 3) - 1));
+                record.op = static_cast<uint8_t>(CaptureOp::MarketData);
+                record.bestBid = mid - config.tickSize;
+                record.bestAsk = mid + config.tickSize;
+                record.price = mid;
+                record.quantity = static_cast<int64_t>(rng() % 10000);
+            }
+            else if (roll < config.marketDataRatio + config.cancelRatio && !orders.empty())
+            {
+                size_t pick = rng() % orders.size();
+                record.op = static_cast<uint8_t>(CaptureOp::Cancel);
+                record.orderId = orders[pick].orderId;
+                orders[pick] = orders.back();
+                orders.pop_back();
+            }
+            else if (roll < config.marketDataRatio + config.cancelRatio + config.amendRatio && !orders.empty())
+            {
+                record.op = static_cast<uint8_t>(CaptureOp::Amend);
+                const LiveOrder &order = orders[rng() % orders.size()];
+                record.orderId = order.orderId;
+                record.side = order.side;
+                record.price = std::max(config.tickSize, mid + (record.side ? 1 : -1) * config.tickSize * (1 + ticksAway(rng)));
+                record.quantity = 100 * lots(rng);
+            }
+            else
+            {
+                record.op = static_cast<uint8_t>(CaptureOp::New);
+                record.orderId = ++capture.maxOrderId;
+                record.side = rng() & 1;
+                double offset = config.tickSize * (1 + ticksAway(rng));
+                // Marketable orders cross the mid by the offset, resting ones stay behind it
+                bool marketable = unit(rng) < config.marketableRatio;
+                double direction = (record.side == 0) == marketable ? 1.0 : -1.0;
+                record.price = std::max(config.tickSize, mid + direction * offset);
+                record.quantity = 100 * lots(rng);
+                if (!marketable)
+                {
+                    orders.push_back({record.orderId, record.side});
+                }
+            }
+
+            capture.records.push_back(record);
+        }
+    }
+
+} // namespace quantis
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace quantis
+{
+
+    enum class CaptureOp : uint8_t
+    {
+        New = 1,       // same values as BatchOp
+        Cancel = 2,
+        Amend = 3,
+        MarketData = 4 // external quote for the store
+    };
+
+    /**
+     * One captured event, native-endian, one cache line
+     *
+     * Orders are named by capture-local IDs, dense from 1, so a replay maps
+     * them to engine handles with a flat array. Cancel and Amend name the ID
+     * of the New they refer to.
+     */
+    struct CaptureRecord
+    {
+        uint64_t timestampNs; // since the start of the capture
+        uint8_t op;           // CaptureOp
+        uint8_t side;         // 0 = buy, 1 = sell
+        uint16_t symbol;      // index into Capture::symbols
+        uint32_t userIndex;
+        uint64_t orderId;  // New / Cancel / Amend
+        int64_t quantity;  // MarketData: volume
+        double price;      // MarketData: last price
+        double bestBid;    // MarketData only
+        double bestAsk;    // MarketData only
+        uint64_t reserved;
+    };
+
+    static_assert(sizeof(CaptureRecord) == 64 && std::is_trivially_copyable_v<CaptureRecord>);
+
+    /**
+     * A replayable order flow
+     *
+     * On disk ("*.qrp"): a CaptureFileHeader, symbolCount NUL-padded
+     * 8-byte symbol names, then recordCount CaptureRecords.
+     */
+    struct Capture
+    {
+        std::vector<std::string> symbols;
+        std::vector<CaptureRecord> records; // in timestamp order
+        uint64_t maxOrderId{0};
+    };
+
+    struct CaptureFileHeader
+    {
+        char magic[8]; // "QRPLAY\0\0"
+        uint32_t version;
+        uint32_t symbolCount;
+        uint64_t recordCount;
+        uint64_t maxOrderId;
+    };
+
+    static_assert(sizeof(CaptureFileHeader) == 32 && std::is_trivially_copyable_v<CaptureFileHeader>);
+
+    inline constexpr uint32_t CAPTURE_VERSION = 1;
+    inline constexpr size_t CAPTURE_SYMBOL_BYTES = 8;
+
+    bool readCapture(const std::string &path, Capture &capture);
+    bool writeCapture(const std::string &path, const Capture &capture);
+
+    /**
+     * Convert an engine event journal (QUANTIS_JOURNAL_DIR) into a capture
+     *
+     * Every accepted New, Cancel and Amend is kept in journal order. The
+     * journal carries no times, so the result only replays at max speed.
+     * Opening a journal trims a torn tail: point it at a copy or at the
+     * directory of a stopped engine.
+     */
+    bool importJournal(const std::string &directory, Capture &capture);
+
+    enum class ArrivalProcess : uint8_t
+    {
+        Poisson, // independent exponential gaps
+        Hawkes   // self-exciting: each event raises the rate, which decays back
+    };
+
+    struct SyntheticFlowConfig
+    {
+        ArrivalProcess process{ArrivalProcess::Poisson};
+        size_t events{1000000};
+        double eventsPerSecond{100000.0}; // long-run mean rate for both processes
+        double hawkesBranching{0.8};      // Hawkes: events each event triggers on average (< 1)
+        double hawkesBeta{2000.0};        // Hawkes: decay rate of the excitation, per second
+        size_t symbols{16};               // activity falls off as 1/rank across symbols
+        uint32_t users{64};
+        double tickSize{0.01};
+        double cancelRatio{0.35};
+        double amendRatio{0.10};
+        double marketDataRatio{0.05};
+        double marketableRatio{0.10}; // share of new orders priced through the touch
+        uint64_t seed{42};
+    };
+
+    // Deterministic for a given config: the same seed always gives the same flow
+    void generateSyntheticFlow(const SyntheticFlowConfig &config, Capture &capture);
+
+} // namespace quantis
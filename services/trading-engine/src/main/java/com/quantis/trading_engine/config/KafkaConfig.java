@@ -108,6 +108,34 @@ public class KafkaConfig {
                 .build();
     }
     
+    /**
+     * Creates the 'trades.fills' topic the C++ engine's fills are published
+     * to from its trade output rings, keyed by symbol
+     */
+    @Bean
+    public NewTopic tradesFillsTopic() {
+        return TopicBuilder.name("trades.fills")
+                .partitions(6)
+                .replicas(1)
+                .config("cleanup.policy", "delete")
+                .config("retention.ms", "604800000") // 7 days
+                .build();
+    }
+    
+    /**
+     * Creates the 'risk.controls' topic the risk service pushes user limits
+     * and symbol halts on. Compacted by key (user or symbol), so a starting
+     * engine replays the latest control for each.
+     */
+    @Bean
+    public NewTopic riskControlsTopic() {
+        return TopicBuilder.name("risk.controls")
+                .partitions(1)
+                .replicas(1)
+                .config("cleanup.policy", "compact")
+                .build();
+    }
+    
     /**
      * Creates the 'market.data' topic for market data updates
      */
@@ -47,11 +47,12 @@ public class MarketDataController {
     @GetMapping
     public ResponseEntity<Map<String, Object>> getAllMarketData() {
         try {
-            // Get symbols from C++ service
+            // Get symbols from C++ service, and every quote in one bulk snapshot
             String[] symbols = marketDataService.getSymbols();
             Map<String, Object> data = Map.of(
                 "symbols", symbols,
                 "count", symbols.length,
+                "marketData", marketDataService.getAllMarketData(),
                 "service", "C++ Market Data Service"
             );
             return ResponseEntity.ok(data);
@@ -1,5 +1,8 @@
 package com.quantis.trading_engine.jni;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
 /**
  * JNI interface to C++ trading engine
  */
@@ -89,6 +92,23 @@ public class TradingEngineJNI {
     private native boolean updateOrderNative(String orderId, String userId, String symbol,
                                            String side, long quantity, double price);
     
+    /**
+     * Amend a resting order by the handle from its batch ack. A smaller quantity
+     * at the same price keeps the order's place in the queue; a new price or a
+     * larger quantity sends it to the back. Side and user stay as entered.
+     */
+    public boolean amendOrder(long handle, long quantity, double price) {
+        if (nativeLibraryLoaded) {
+            return amendOrderNative(handle, quantity, price);
+        } else {
+            // Mock implementation
+            System.out.println("Mock: Amending order " + handle + " to " + quantity + "@" + price);
+            return true;
+        }
+    }
+    
+    private native boolean amendOrderNative(long handle, long quantity, double price);
+    
     /**
      * Get market data for a symbol
      * @return Array of [bestBid, bestAsk, lastPrice, spread]
@@ -118,6 +138,22 @@ public class TradingEngineJNI {
     
     private native long getOrderCountNative(String symbol);
     
+    /**
+     * Occupancy of a symbol's order and price level pools
+     * @return [ordersInUse, orderCapacity, levelsInUse, levelCapacity, reservedBytes,
+     *         hugePageBytes], or null if the symbol has no book
+     */
+    public long[] getBookMemoryStats(String symbol) {
+        if (nativeLibraryLoaded) {
+            return getBookMemoryStatsNative(symbol);
+        } else {
+            // Mock implementation
+            return new long[]{42L, 4096L, 8L, 512L, 303104L, 0L};
+        }
+    }
+    
+    private native long[] getBookMemoryStatsNative(String symbol);
+    
     /**
      * Get spread for a symbol
      */
@@ -133,7 +169,8 @@ public class TradingEngineJNI {
     private native double getSpreadNative(String symbol);
     
     /**
-     * Check if symbol is halted
+     * Check if a symbol's circuit breaker is tripped: halted symbols refuse
+     * new orders and amends, cancels still go through
      */
     public boolean isSymbolHalted(String symbol) {
         if (nativeLibraryLoaded) {
@@ -146,6 +183,194 @@ public class TradingEngineJNI {
     
     private native boolean isSymbolHaltedNative(String symbol);
     
+    /**
+     * Halt or resume a symbol in the engine's pre-trade risk gate
+     */
+    public boolean setSymbolHalted(String symbol, boolean halted) {
+        if (nativeLibraryLoaded) {
+            return setSymbolHaltedNative(symbol, halted);
+        } else {
+            // Mock implementation
+            System.out.println("Mock: " + (halted ? "Halting " : "Resuming ") + symbol);
+            return true;
+        }
+    }
+    
+    private native boolean setSymbolHaltedNative(String symbol, boolean halted);
+    
+    /**
+     * Replace a user's pre-trade limits in the engine; 0 disables a limit.
+     * maxPositionNotional bounds the user's net filled notional (bought minus
+     * sold) as if the order filled in full; maxOrdersPerSecond throttles new
+     * orders and amends, allowing a one-second burst.
+     */
+    public boolean setUserRiskLimits(String userId, long maxOrderQuantity, double maxOrderNotional,
+                                     double maxPositionNotional, double maxOrdersPerSecond) {
+        if (nativeLibraryLoaded) {
+            return setUserRiskLimitsNative(userId, maxOrderQuantity, maxOrderNotional, maxPositionNotional, maxOrdersPerSecond);
+        } else {
+            // Mock implementation
+            System.out.println("Mock: Setting risk limits for " + userId);
+            return true;
+        }
+    }
+    
+    private native boolean setUserRiskLimitsNative(String userId, long maxOrderQuantity, double maxOrderNotional,
+                                                   double maxPositionNotional, double maxOrdersPerSecond);
+    
+    /**
+     * Select the order book backend for a symbol before its first order.
+     * Pass a null symbol to change the default for books not yet created.
+     * @param bookType 0 = sparse price map, 1 = dense tick ladder around the touch
+     * @param tickSize minimum price increment used to convert prices to integer ticks
+     */
+    public boolean configureOrderBook(String symbol, int bookType, double tickSize) {
+        if (nativeLibraryLoaded) {
+            return configureOrderBookNative(symbol, bookType, tickSize);
+        } else {
+            // Mock implementation
+            System.out.println("Mock: Configuring order book for " + symbol + " type=" + bookType + " tick=" + tickSize);
+            return true;
+        }
+    }
+    
+    private native boolean configureOrderBookNative(String symbol, int bookType, double tickSize);
+    
+    // ==================== BATCH ORDER ENTRY ====================
+    
+    // Record layouts, mirrored from BatchProtocol.h (native byte order)
+    public static final int ORDER_RECORD_SIZE = 48;
+    public static final int RESULT_RECORD_SIZE = 64;
+    public static final int BATCH_HEADER_SIZE = 16;
+    
+    public static final byte BATCH_OP_NEW = 1;
+    public static final byte BATCH_OP_CANCEL = 2;
+    public static final byte BATCH_OP_AMEND = 3;
+    
+    public static final byte RESULT_ACK = 1;
+    public static final byte RESULT_REJECT = 2;
+    public static final byte RESULT_FILL = 3;
+    
+    // Result byte 3 of a RESULT_REJECT: why the pre-trade risk gate refused it (0 = refused by the book)
+    public static final byte REJECT_HALTED = 1;
+    public static final byte REJECT_PRICE_BAND = 2;
+    public static final byte REJECT_ORDER_QUANTITY = 3;
+    public static final byte REJECT_ORDER_NOTIONAL = 4;
+    public static final byte REJECT_POSITION = 5;
+    public static final byte REJECT_ORDER_RATE = 6;
+    public static final byte REJECT_UNKNOWN_USER = 7;
+    
+    /**
+     * Resolve a symbol to the index used in batch order records, creating its book if needed
+     * @return symbol index, or -1 if the symbol table is full
+     */
+    public int resolveSymbol(String symbol) {
+        if (nativeLibraryLoaded) {
+            return resolveSymbolNative(symbol);
+        } else {
+            // Mock implementation
+            return Math.floorMod(symbol.hashCode(), 10000);
+        }
+    }
+    
+    private native int resolveSymbolNative(String symbol);
+    
+    /**
+     * Resolve a user ID to the index used in batch order records
+     */
+    public int resolveUser(String userId) {
+        if (nativeLibraryLoaded) {
+            return resolveUserNative(userId);
+        } else {
+            // Mock implementation
+            return Math.floorMod(userId.hashCode(), 1 << 20) + 1;
+        }
+    }
+    
+    private native int resolveUserNative(String userId);
+    
+    /**
+     * Submit count order records from a direct buffer in one native call.
+     * Acks, rejects and fills are written to the direct output buffer after a
+     * 16-byte header {processed, results, pending, reserved}; if pending is
+     * non-zero, call again (count may be 0) to collect the rest.
+     * @return number of result records written, or -1 on invalid buffers
+     */
+    public int processOrderBatch(ByteBuffer input, int count, ByteBuffer output) {
+        if (nativeLibraryLoaded) {
+            return processOrderBatchNative(input, count, output);
+        } else {
+            // Mock implementation
+            System.out.println("Mock: Processing batch of " + count + " orders");
+            output.order(ByteOrder.nativeOrder());
+            output.putInt(0, count).putInt(4, 0).putInt(8, 0).putInt(12, 0);
+            return 0;
+        }
+    }
+    
+    private native int processOrderBatchNative(ByteBuffer input, int count, ByteBuffer output);
+    
+    // Trade output ring layout, mirrored from TradeRing.h (native byte order): a 256-byte
+    // header {int version, int recordSize, long capacity; long head at 64; long tail at 128;
+    // long watermark at 192, long dropped at 200}, then capacity records of
+    // {long tradeId, orderHandle, restingHandle, double price, long quantity, executedAt,
+    //  int symbolIndex, userIndex, restingUserIndex, byte side, byte flags, short reserved}
+    public static final int TRADE_RING_HEADER_SIZE = 256;
+    public static final int TRADE_RING_CAPACITY_OFFSET = 8;
+    public static final int TRADE_RING_HEAD_OFFSET = 64;
+    public static final int TRADE_RING_TAIL_OFFSET = 128;
+    public static final int TRADE_RING_WATERMARK_OFFSET = 192;
+    public static final int TRADE_RING_DROPPED_OFFSET = 200;
+    public static final int TRADE_RECORD_SIZE = 64;
+    
+    /**
+     * Number of trade output rings (one per engine shard, one when inline;
+     * 0 if disabled with QUANTIS_TRADE_RING_CAPACITY=0)
+     */
+    public int getTradeRingCount() {
+        if (nativeLibraryLoaded) {
+            return getTradeRingCountNative();
+        } else {
+            // Mock implementation
+            return 0;
+        }
+    }
+    
+    private native int getTradeRingCountNative();
+    
+    /**
+     * Direct view of a trade output ring's memory. The engine appends every
+     * fill and advances head; the single consumer reads head with acquire
+     * semantics, copies the records up to it and publishes tail with release
+     * semantics to free their slots. The view stays valid for the engine's life.
+     * @return the ring, or null if index is out of range
+     */
+    public ByteBuffer getTradeRing(int index) {
+        if (nativeLibraryLoaded) {
+            ByteBuffer ring = getTradeRingNative(index);
+            return ring != null ? ring.order(ByteOrder.nativeOrder()) : null;
+        } else {
+            // Mock implementation
+            return null;
+        }
+    }
+    
+    private native ByteBuffer getTradeRingNative(int index);
+    
+    /**
+     * User ID behind a userIndex from a batch result or trade record, "" if unknown
+     */
+    public String getUserId(int userIndex) {
+        if (nativeLibraryLoaded) {
+            return getUserIdNative(userIndex);
+        } else {
+            // Mock implementation
+            return "";
+        }
+    }
+    
+    private native String getUserIdNative(int userIndex);
+    
     /**
      * Get executed trades for an order
      * @return Array of Trade objects (currently returns empty array)
@@ -195,6 +420,34 @@ public class TradingEngineJNI {
     
     private native double[] getMarketDataLockFreeNative(String symbol);
     
+    // Values per symbol in readMarketData's output
+    public static final int MARKET_DATA_FIELDS = 6;
+    
+    /**
+     * Read many symbols at once into a caller-owned array, without allocating:
+     * row i of out, MARKET_DATA_FIELDS values from i * MARKET_DATA_FIELDS, gets
+     * [bestBid, bestAsk, lastPrice, spread, volume, timestamp] for symbolIndices[i]
+     * (resolveSymbol / waitForUpdates indices), or zeros if it has no data.
+     * Returns the number of symbols with data, or -1 if out is too short.
+     */
+    public int readMarketData(int[] symbolIndices, double[] out) {
+        if (nativeLibraryLoaded) {
+            return readMarketDataNative(symbolIndices, out);
+        } else {
+            // Mock implementation
+            if (out.length < symbolIndices.length * MARKET_DATA_FIELDS) {
+                return -1;
+            }
+            for (int i = 0; i < symbolIndices.length; i++) {
+                double[] row = {100.50, 100.60, 100.55, 0.10, 1000.0, System.currentTimeMillis()};
+                System.arraycopy(row, 0, out, i * MARKET_DATA_FIELDS, MARKET_DATA_FIELDS);
+            }
+            return symbolIndices.length;
+        }
+    }
+    
+    private native int readMarketDataNative(int[] symbolIndices, double[] out);
+    
     /**
      * Check if symbol has valid market data
      */
@@ -208,6 +461,81 @@ public class TradingEngineJNI {
     }
     
     private native boolean hasValidMarketDataNative(String symbol);
+    
+    /**
+     * Get the top levels of a symbol's order book (lock-free, up to 10 per side)
+     * Returns: [bidCount, askCount, timestamp, then price, quantity, orderCount
+     * for each bid level best first, then for each ask level], or null if the
+     * symbol has no book
+     */
+    public double[] getMarketDepth(String symbol) {
+        if (nativeLibraryLoaded) {
+            return getMarketDepthNative(symbol);
+        } else {
+            // Mock implementation
+            return new double[]{1, 1, System.currentTimeMillis(), 100.50, 100.0, 1, 100.60, 100.0, 1};
+        }
+    }
+    
+    private native double[] getMarketDepthNative(String symbol);
+    
+    /**
+     * Block until market data changes after lastSequence, or timeoutMs passes.
+     * Returns [sequence, symbolIndex...]: pass sequence back as lastSequence on
+     * the next call; each changed symbol appears once, by its resolveSymbol index.
+     * Start from 0 to receive every symbol once.
+     */
+    public long[] waitForUpdates(long lastSequence, long timeoutMs) {
+        if (nativeLibraryLoaded) {
+            return waitForUpdatesNative(lastSequence, timeoutMs);
+        } else {
+            // Mock implementation
+            try {
+                Thread.sleep(timeoutMs);
+            } catch (InterruptedException e) {
+                Thread.currentThread().interrupt();
+            }
+            return new long[]{lastSequence};
+        }
+    }
+    
+    private native long[] waitForUpdatesNative(long lastSequence, long timeoutMs);
+    
+    // MarketDataRecord layout, mirrored from MarketDataStore.h (native byte order):
+    // {int symbolIndex, int sequence, double bestBid, bestAsk, lastPrice, spread, long volume, long timestamp}
+    public static final int MARKET_DATA_RECORD_SIZE = 56;
+    
+    /**
+     * Copy every symbol that has market data into a direct buffer in one native
+     * call, as MARKET_DATA_RECORD_SIZE records in symbol index order. Size the
+     * buffer for getActiveSymbols().length records to be sure to get them all.
+     * @return number of records written, or -1 if the buffer is not direct
+     */
+    public int snapshotMarketData(ByteBuffer output) {
+        if (nativeLibraryLoaded) {
+            return snapshotMarketDataNative(output);
+        } else {
+            // Mock implementation
+            return output.isDirect() ? 0 : -1;
+        }
+    }
+    
+    private native int snapshotMarketDataNative(ByteBuffer output);
+    
+    /**
+     * Symbols in the market data store, indexed by the symbolIndex used in
+     * snapshot records and waitForUpdates; an entry still being registered is "".
+     */
+    public String[] getActiveSymbols() {
+        if (nativeLibraryLoaded) {
+            return getActiveSymbolsNative();
+        } else {
+            // Mock implementation
+            return new String[0];
+        }
+    }
+    
+    private native String[] getActiveSymbolsNative();
 
     // ==================== C++ MARKET DATA SERVICE CONTROL ====================
     
@@ -11,8 +11,13 @@ import org.springframework.stereotype.Service;
 
 import javax.annotation.PostConstruct;
 import javax.annotation.PreDestroy;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.ArrayList;
+import java.util.Arrays;
 import java.util.List;
 import java.util.Map;
+import java.util.TreeMap;
 import java.util.concurrent.ConcurrentHashMap;
 import java.util.concurrent.atomic.AtomicLong;
 
@@ -44,6 +49,9 @@ public class LockFreeMarketDataService {
     private final AtomicLong failedUpdates = new AtomicLong(0);
     private final AtomicLong totalReads = new AtomicLong(0);
     
+    // Reused by getAllMarketData; grown when the store outgrows it
+    private ByteBuffer snapshotBuffer;
+    
     // Cache for performance monitoring (not used for trading decisions)
     private final Map<String, MarketDataSnapshot> performanceCache = new ConcurrentHashMap<>();
     
@@ -320,6 +328,51 @@ public class LockFreeMarketDataService {
         return null;
     }
     
+    /**
+     * Get market data for every symbol in the C++ store with one native call
+     * instead of one getMarketData call per symbol
+     */
+    public synchronized List<MarketDataSnapshot> getAllMarketData() {
+        List<MarketDataSnapshot> snapshots = new ArrayList<>();
+        
+        try {
+            String[] symbols = cppEngine.getActiveSymbols();
+            if (symbols == null || symbols.length == 0) {
+                return snapshots;
+            }
+            
+            int capacity = symbols.length * TradingEngineJNI.MARKET_DATA_RECORD_SIZE;
+            if (snapshotBuffer == null || snapshotBuffer.capacity() < capacity) {
+                snapshotBuffer = ByteBuffer.allocateDirect(capacity).order(ByteOrder.nativeOrder());
+            }
+            
+            int count = cppEngine.snapshotMarketData(snapshotBuffer);
+            for (int i = 0; i < count; i++) {
+                int offset = i * TradingEngineJNI.MARKET_DATA_RECORD_SIZE;
+                int index = snapshotBuffer.getInt(offset);
+                // Registered after getActiveSymbols was read
+                if (index >= symbols.length) {
+                    continue;
+                }
+                snapshots.add(MarketDataSnapshot.builder()
+                    .symbol(symbols[index])
+                    .bestBid(snapshotBuffer.getDouble(offset + 8))
+                    .bestAsk(snapshotBuffer.getDouble(offset + 16))
+                    .lastPrice(snapshotBuffer.getDouble(offset + 24))
+                    .spread(snapshotBuffer.getDouble(offset + 32))
+                    .volume(snapshotBuffer.getLong(offset + 40))
+                    .timestamp(snapshotBuffer.getLong(offset + 48))
+                    .build());
+            }
+            totalReads.addAndGet(count);
+            
+        } catch (Exception e) {
+            log.error("Error getting bulk market data snapshot", e);
+        }
+        
+        return snapshots;
+    }
+    
     /**
      * Check if symbol has valid market data
      */
@@ -349,8 +402,9 @@ public class LockFreeMarketDataService {
                     .failedUpdates(Long.parseLong(metricsMap.getOrDefault("failedUpdates", "0")))
                     .totalReads(totalReads.get())
                     .updatesPerSecond(Double.parseDouble(metricsMap.getOrDefault("updatesPerSecond", "0")))
-                    .avgReadLatencyNs(10.0) // ~10 nanoseconds
-                    .avgWriteLatencyNs(Double.parseDouble(metricsMap.getOrDefault("avgLatencyMs", "0")) * 1e6) // Convert ms to ns
+                    .avgReadLatencyNs(Double.parseDouble(metricsMap.getOrDefault("latency.store.read.meanNs", "0")))
+                    .avgWriteLatencyNs(Double.parseDouble(metricsMap.getOrDefault("latency.store.write.meanNs", "0")))
+                    .latency(latencyPercentiles(metricsMap))
                     .build();
             }
         } catch (Exception e) {
@@ -365,8 +419,22 @@ public class LockFreeMarketDataService {
             .updatesPerSecond(totalUpdates.get() * 1000.0 / (System.currentTimeMillis() - getStartTime()))
             .avgReadLatencyNs(10.0) // ~10 nanoseconds
             .avgWriteLatencyNs(50.0) // ~50 nanoseconds
+            .latency(Map.of())
             .build();
     }
+
+    /**
+     * Native latency histogram summaries, keyed "<metric>.<stat>" (e.g. "book.matchOrder.p99Ns")
+     */
+    private static Map<String, String> latencyPercentiles(Map<String, String> metricsMap) {
+        Map<String, String> latency = new TreeMap<>();
+        metricsMap.forEach((key, value) -> {
+            if (key.startsWith("latency.")) {
+                latency.put(key.substring("latency.".length()), value);
+            }
+        });
+        return latency;
+    }
     
     /**
      * Add a symbol to the C++ service
@@ -401,6 +469,11 @@ public class LockFreeMarketDataService {
             if (cppSymbols != null && cppSymbols.length > 0) {
                 return cppSymbols;
             }
+            // Symbols the store holds data for, without asking the C++ service
+            String[] storeSymbols = cppEngine.getActiveSymbols();
+            if (storeSymbols != null && storeSymbols.length > 0) {
+                return Arrays.stream(storeSymbols).filter(symbol -> !symbol.isEmpty()).toArray(String[]::new);
+            }
             // Fallback to configured symbols
             return marketDataConfig.getAlphaVantage().getSymbols().toArray(new String[0]);
         } catch (Exception e) {
@@ -495,5 +568,6 @@ public class LockFreeMarketDataService {
         private double updatesPerSecond;
         private double avgReadLatencyNs;
         private double avgWriteLatencyNs;
+        private Map<String, String> latency;
     }
 }
@@ -0,0 +1,57 @@
+package com.quantis.trading_engine.service;
+
+import com.fasterxml.jackson.databind.JsonNode;
+import com.fasterxml.jackson.databind.ObjectMapper;
+import com.quantis.trading_engine.jni.TradingEngineJNI;
+import lombok.RequiredArgsConstructor;
+import lombok.extern.slf4j.Slf4j;
+import org.springframework.boot.autoconfigure.condition.ConditionalOnProperty;
+import org.springframework.kafka.annotation.KafkaListener;
+import org.springframework.stereotype.Service;
+
+/**
+ * Applies risk-service pushes to the C++ engine's pre-trade risk gate.
+ * Each engine instance reads the whole topic under its own group, so every
+ * instance holds every user's limits and every halt. Messages:
+ * {"type":"limits","userId":...,"maxOrderQuantity":...,"maxOrderNotional":...,
+ *  "maxPositionNotional":...,"maxOrdersPerSecond":...} (missing or 0 = no limit)
+ * and {"type":"halt","symbol":...,"halted":true|false}.
+ */
+@Service
+@RequiredArgsConstructor
+@Slf4j
+@ConditionalOnProperty(name = "cpp.engine.enabled", havingValue = "true", matchIfMissing = false)
+public class RiskControlConsumer {
+    
+    private final ObjectMapper objectMapper;
+    private final TradingEngineJNI cppEngine;
+    
+    @KafkaListener(topics = "risk.controls", groupId = "trading-engine-risk-#{T(java.util.UUID).randomUUID()}")
+    public void processRiskControl(String message) {
+        try {
+            JsonNode control = objectMapper.readTree(message);
+            String type = control.path("type").asText();
+            
+            if ("limits".equals(type)) {
+                String userId = control.path("userId").asText();
+                boolean applied = cppEngine.setUserRiskLimits(
+                    userId,
+                    control.path("maxOrderQuantity").asLong(0),
+                    control.path("maxOrderNotional").asDouble(0),
+                    control.path("maxPositionNotional").asDouble(0),
+                    control.path("maxOrdersPerSecond").asDouble(0)
+                );
+                log.info("Risk limits for user {} {}", userId, applied ? "applied" : "rejected by the engine");
+            } else if ("halt".equals(type)) {
+                String symbol = control.path("symbol").asText();
+                boolean halted = control.path("halted").asBoolean(true);
+                cppEngine.setSymbolHalted(symbol, halted);
+                log.warn("Symbol {} {} by risk service", symbol, halted ? "halted" : "resumed");
+            } else {
+                log.warn("Ignoring unknown risk control: {}", message);
+            }
+        } catch (Exception e) {
+            log.error("Error processing risk control: {}", message, e);
+        }
+    }
+}
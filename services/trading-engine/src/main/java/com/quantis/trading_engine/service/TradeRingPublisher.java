@@ -0,0 +1,241 @@
+package com.quantis.trading_engine.service;
+
+import com.quantis.trading_engine.jni.TradingEngineJNI;
+import lombok.RequiredArgsConstructor;
+import lombok.extern.slf4j.Slf4j;
+import org.springframework.boot.autoconfigure.condition.ConditionalOnProperty;
+import org.springframework.kafka.core.KafkaTemplate;
+import org.springframework.stereotype.Service;
+
+import javax.annotation.PostConstruct;
+import javax.annotation.PreDestroy;
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.VarHandle;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.concurrent.locks.LockSupport;
+
+/**
+ * Publishes the C++ engine's fills to Kafka straight from its trade output rings.
+ *
+ * Each ring is a direct view of engine memory that this service is the only
+ * consumer of: one thread reads a ring's head, turns up to MAX_BATCH records
+ * into messages on 'trades.fills' and then releases the whole batch with one
+ * store to tail, so fills cost no JNI call and no Java object on the engine
+ * side. Symbols and user IDs are resolved once per index and cached. When the
+ * rings are empty the thread spins briefly, then parks with a growing backoff.
+ *
+ * The rings never stall matching: a fill that finds its ring full is dropped
+ * and counted. The ring's watermark (deepest backlog seen) and drop count are
+ * checked every second and logged when they rise.
+ */
+@Service
+@RequiredArgsConstructor
+@Slf4j
+@ConditionalOnProperty(name = "cpp.engine.enabled", havingValue = "true", matchIfMissing = false)
+public class TradeRingPublisher {
+
+    private static final String TOPIC = "trades.fills";
+    private static final int MAX_BATCH = 256;
+    private static final int IDLE_SPINS = 100;
+    private static final long MAX_PARK_NANOS = 1_000_000;
+    private static final long MONITOR_INTERVAL_NANOS = 1_000_000_000L;
+
+    // Acquire / release access to the ring indices the engine shares with us
+    private static final VarHandle LONGS = MethodHandles.byteBufferViewVarHandle(long[].class, ByteOrder.nativeOrder());
+
+    private final TradingEngineJNI cppEngine;
+    private final KafkaTemplate<String, String> kafkaTemplate;
+
+    private ByteBuffer[] rings = new ByteBuffer[0];
+    private long[] tails;
+    private long[] watermarks;
+    private long[] dropped;
+
+    // Publisher thread only
+    private String[] symbols = new String[0];
+    private final Map<Integer, String> userIds = new HashMap<>();
+    private final StringBuilder json = new StringBuilder(256);
+
+    private volatile boolean running = false;
+    private Thread worker;
+
+    @PostConstruct
+    public void start() {
+        int count = cppEngine.getTradeRingCount();
+        rings = new ByteBuffer[count];
+        for (int i = 0; i < count; i++) {
+            rings[i] = cppEngine.getTradeRing(i);
+        }
+        tails = new long[count];
+        watermarks = new long[count];
+        dropped = new long[count];
+        if (count == 0) {
+            log.info("No C++ trade output rings; engine fills are not published to {}", TOPIC);
+            return;
+        }
+
+        for (int i = 0; i < count; i++) {
+            tails[i] = (long) LONGS.getAcquire(rings[i], TradingEngineJNI.TRADE_RING_TAIL_OFFSET);
+        }
+        running = true;
+        worker = new Thread(this::run, "trade-ring-publisher");
+        worker.setDaemon(true);
+        worker.start();
+        log.info("Publishing C++ engine fills to {} from {} trade ring(s) of {} records", TOPIC, count,
+                rings[0].getLong(TradingEngineJNI.TRADE_RING_CAPACITY_OFFSET));
+    }
+
+    @PreDestroy
+    public void stop() {
+        running = false;
+        if (worker == null) {
+            return;
+        }
+        try {
+            worker.join(5_000);
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+        }
+    }
+
+    private void run() {
+        int idle = 0;
+        long parkNanos = 1_000;
+        long nextMonitor = System.nanoTime() + MONITOR_INTERVAL_NANOS;
+
+        while (running) {
+            int published = 0;
+            try {
+                for (int i = 0; i < rings.length; i++) {
+                    published += drain(i);
+                }
+            } catch (Exception e) {
+                log.error("Error publishing engine fills", e);
+            }
+
+            if (published > 0) {
+                idle = 0;
+                parkNanos = 1_000;
+            } else if (++idle < IDLE_SPINS) {
+                Thread.onSpinWait();
+            } else {
+                LockSupport.parkNanos(parkNanos);
+                parkNanos = Math.min(parkNanos * 2, MAX_PARK_NANOS);
+            }
+
+            if (System.nanoTime() - nextMonitor >= 0) {
+                monitor();
+                nextMonitor = System.nanoTime() + MONITOR_INTERVAL_NANOS;
+            }
+        }
+
+        // Flush what the engine published before shutdown
+        for (int i = 0; i < rings.length; i++) {
+            while (drain(i) > 0) {
+                // keep draining
+            }
+        }
+        log.info("Trade ring publisher stopped");
+    }
+
+    /**
+     * Publish up to MAX_BATCH records from ring i and free their slots
+     */
+    private int drain(int i) {
+        ByteBuffer ring = rings[i];
+        long tail = tails[i];
+        long head = (long) LONGS.getAcquire(ring, TradingEngineJNI.TRADE_RING_HEAD_OFFSET);
+        int count = (int) Math.min(head - tail, MAX_BATCH);
+        if (count <= 0) {
+            return 0;
+        }
+
+        long mask = ring.getLong(TradingEngineJNI.TRADE_RING_CAPACITY_OFFSET) - 1;
+        for (int n = 0; n < count; n++) {
+            int offset = TradingEngineJNI.TRADE_RING_HEADER_SIZE + (int) ((tail + n) & mask) * TradingEngineJNI.TRADE_RECORD_SIZE;
+            publish(ring, offset);
+        }
+
+        tails[i] = tail + count;
+        LONGS.setRelease(ring, TradingEngineJNI.TRADE_RING_TAIL_OFFSET, tails[i]);
+        return count;
+    }
+
+    private void publish(ByteBuffer ring, int offset) {
+        long tradeId = ring.getLong(offset);
+        String symbol = symbolFor(ring.getInt(offset + 48));
+
+        json.setLength(0);
+        json.append("{\"tradeId\":").append(tradeId)
+            .append(",\"symbol\":").append(symbol)
+            .append(",\"side\":").append(ring.get(offset + 60) == 0 ? "\"BUY\"" : "\"SELL\"")
+            .append(",\"price\":").append(ring.getDouble(offset + 24))
+            .append(",\"quantity\":").append(ring.getLong(offset + 32))
+            .append(",\"executedAtNs\":").append(ring.getLong(offset + 40))
+            .append(",\"userId\":").append(userFor(ring.getInt(offset + 52)))
+            .append(",\"restingUserId\":").append(userFor(ring.getInt(offset + 56)))
+            .append(",\"orderHandle\":").append(ring.getLong(offset + 8))
+            .append(",\"restingHandle\":").append(ring.getLong(offset + 16))
+            .append(",\"restingFilled\":").append((ring.get(offset + 61) & 0x01) != 0)
+            .append('}');
+
+        // Symbols are cached quoted; the key drops the quotes
+        kafkaTemplate.send(TOPIC, symbol.substring(1, symbol.length() - 1), json.toString());
+    }
+
+    // Quoted symbol name, refreshing the store's symbol table on a new index
+    private String symbolFor(int index) {
+        if (index >= symbols.length || symbols[index] == null) {
+            String[] active = cppEngine.getActiveSymbols();
+            symbols = new String[active.length];
+            for (int i = 0; i < active.length; i++) {
+                symbols[i] = active[i].isEmpty() ? null : quote(active[i]);
+            }
+        }
+        return index < symbols.length && symbols[index] != null ? symbols[index] : "\"\"";
+    }
+
+    // Quoted user ID, looked up once per user index
+    private String userFor(int index) {
+        return userIds.computeIfAbsent(index, i -> quote(cppEngine.getUserId(i)));
+    }
+
+    private void monitor() {
+        for (int i = 0; i < rings.length; i++) {
+            long capacity = rings[i].getLong(TradingEngineJNI.TRADE_RING_CAPACITY_OFFSET);
+            long watermark = (long) LONGS.getOpaque(rings[i], TradingEngineJNI.TRADE_RING_WATERMARK_OFFSET);
+            long drops = (long) LONGS.getOpaque(rings[i], TradingEngineJNI.TRADE_RING_DROPPED_OFFSET);
+
+            if (drops > dropped[i]) {
+                log.error("Trade ring {} was full: {} fills dropped ({} in total), not published to {}",
+                        i, drops - dropped[i], drops, TOPIC);
+            }
+            if (watermark > watermarks[i] && watermark * 2 > capacity) {
+                log.warn("Trade ring {} backlog reached {} of {} records; publishing is falling behind",
+                        i, watermark, capacity);
+            }
+            dropped[i] = drops;
+            watermarks[i] = watermark;
+        }
+    }
+
+    private static String quote(String value) {
+        StringBuilder quoted = new StringBuilder(value == null ? 2 : value.length() + 2).append('"');
+        if (value != null) {
+            for (int i = 0; i < value.length(); i++) {
+                char c = value.charAt(i);
+                if (c == '"' || c == '\\') {
+                    quoted.append('\\').append(c);
+                } else if (c < 0x20) {
+                    quoted.append(String.format("\\u%04x", (int) c));
+                } else {
+                    quoted.append(c);
+                }
+            }
+        }
+        return quoted.append('"').toString();
+    }
+}